@@ -3,10 +3,10 @@
 
 #if UGE_DLL
     #if UGE_COREMATH_EXPORT
-        #define COREMATH_API __declspec(dllexport)
+        #define COREMATH_API UGE_DLLEXPORT
         #define COREMATH_TEMPLATE
     #else
-        #define COREMATH_API __declspec(dllimport)
+        #define COREMATH_API UGE_DLLIMPORT
         #define COREMATH_TEMPLATE extern
     #endif // UGE_COREMATH_EXPORT
 #else
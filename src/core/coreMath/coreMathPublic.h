@@ -1,10 +1,10 @@
 #ifndef __COREMATH_PUBLIC_H__
 #define __COREMATH_PUBLIC_H__
 
-#include "_module/coreMathApi.h"
-
 #include "core/coreSystem/build.h"
 
+#include "_module/coreMathApi.h"
+
 #include "math/mathUtils.h"
 #include "math/simdUtils.h"
 
@@ -3,10 +3,10 @@
 
 #if UGE_DLL
     #if UGE_CORESYSTEM_EXPORT
-        #define CORESYSTEM_API __declspec(dllexport)
+        #define CORESYSTEM_API UGE_DLLEXPORT
         #define CORESYSTEM_TEMPLATE
     #else
-        #define CORESYSTEM_API __declspec(dllimport)
+        #define CORESYSTEM_API UGE_DLLIMPORT
         #define CORESYSTEM_TEMPLATE extern
     #endif // UGE_CORESYSTEM_EXPORT
 #else
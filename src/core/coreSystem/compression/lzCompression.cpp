@@ -0,0 +1,273 @@
+#include "build.h"
+
+#include "lzCompression.h"
+
+#include <bit>
+
+namespace uge::compression
+{
+    namespace
+    {
+        const UInt32 c_lzMinMatch = 4;
+        const UInt32 c_lzMaxOffset = 65535;
+        // The last bytes are always literals and no match starts this close to the end.
+        const UInt32 c_lzLastLiterals = 5;
+        const UInt32 c_lzMatchStartLimit = 12;
+        const UInt32 c_lzHashBits = 12;
+        const UInt32 c_lzSkipShift = 6;
+
+        UGE_FORCE_INLINE UInt32 Read32(const UByte *source)
+        {
+            UInt32 value;
+            Memcpy(&value, source, sizeof(value));
+            return value;
+        }
+
+        UGE_FORCE_INLINE UInt64 Read64(const UByte *source)
+        {
+            UInt64 value;
+            Memcpy(&value, source, sizeof(value));
+            return value;
+        }
+
+        /**
+         * @brief Extends a match of c_lzMinMatch bytes, comparing 8 bytes at a time.
+         */
+        UGE_FORCE_INLINE UInt32 GetMatchLength(const UByte *source, UInt32 position, UInt32 candidate, UInt32 matchEndLimit)
+        {
+            UInt32 matchLength = c_lzMinMatch;
+            while (position + matchLength + sizeof(UInt64) <= matchEndLimit)
+            {
+                const UInt64 difference = Read64(source + position + matchLength) ^ Read64(source + candidate + matchLength);
+                if (difference != 0)
+                {
+                    return matchLength + static_cast<UInt32>(std::countr_zero(difference)) / 8;
+                }
+                matchLength += sizeof(UInt64);
+            }
+
+            while (position + matchLength < matchEndLimit && source[position + matchLength] == source[candidate + matchLength])
+            {
+                ++matchLength;
+            }
+            return matchLength;
+        }
+
+        UGE_FORCE_INLINE UInt32 HashSequence(UInt32 sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - c_lzHashBits);
+        }
+
+        UGE_FORCE_INLINE UByte *WriteLength(UByte *output, UInt32 length)
+        {
+            for (; length >= 255; length -= 255)
+            {
+                *output++ = 255;
+            }
+            *output++ = static_cast<UByte>(length);
+            return output;
+        }
+
+        /**
+         * @brief Writes a sequence, the match is omitted when matchLength is 0.
+         *
+         * @return The end of the sequence, or nullptr if it doesn't fit before outputEnd.
+         */
+        UByte *WriteSequence(UByte *output, const UByte *outputEnd, const UByte *literals, UInt32 literalLength, UInt32 offset, UInt32 matchLength)
+        {
+            const UInt32 maxSize = 1 + literalLength / 255 + 1 + literalLength + 2 + matchLength / 255 + 1;
+            if (static_cast<size_t>(outputEnd - output) < maxSize)
+            {
+                return nullptr;
+            }
+
+            UByte *token = output++;
+            *token = static_cast<UByte>(std::min<UInt32>(literalLength, 15) << 4);
+            if (literalLength >= 15)
+            {
+                output = WriteLength(output, literalLength - 15);
+            }
+
+            Memcpy(output, literals, literalLength);
+            output += literalLength;
+
+            if (matchLength != 0)
+            {
+                *output++ = static_cast<UByte>(offset);
+                *output++ = static_cast<UByte>(offset >> 8);
+
+                const UInt32 extraLength = matchLength - c_lzMinMatch;
+                *token |= static_cast<UByte>(std::min<UInt32>(extraLength, 15));
+                if (extraLength >= 15)
+                {
+                    output = WriteLength(output, extraLength - 15);
+                }
+            }
+
+            return output;
+        }
+
+        UGE_FORCE_INLINE Bool ReadLength(const UByte *&input, const UByte *inputEnd, UInt32 &length)
+        {
+            UByte value;
+            do
+            {
+                if (input == inputEnd)
+                {
+                    return false;
+                }
+                value = *input++;
+                length += value;
+            } while (value == 255);
+
+            return true;
+        }
+    }
+
+    /**
+     * @brief Returns the largest size LzCompress can produce for size bytes of input.
+     */
+    UInt32 LzCompressBound(UInt32 size)
+    {
+        return size + size / 255 + 16;
+    }
+
+    /**
+     * @brief Compresses a block with a greedy, single probe hash table match finder.
+     *
+     * @param source The data to compress.
+     * @param sourceSize The size of the data.
+     * @param destination The buffer receiving the compressed block.
+     * @param destinationSize The size of the buffer, LzCompressBound(sourceSize) always fits.
+     * @return The size of the compressed block, 0 if it doesn't fit in destinationSize.
+     */
+    UInt32 LzCompress(const UByte *source, UInt32 sourceSize, UByte *destination, UInt32 destinationSize)
+    {
+        UByte *output = destination;
+        const UByte *outputEnd = destination + destinationSize;
+        UInt32 anchor = 0;
+
+        if (sourceSize > c_lzMatchStartLimit)
+        {
+            UInt32 table[1 << c_lzHashBits] = {};
+            const UInt32 matchStartLimit = sourceSize - c_lzMatchStartLimit;
+            const UInt32 matchEndLimit = sourceSize - c_lzLastLiterals;
+
+            UInt32 position = 1;
+            while (position <= matchStartLimit)
+            {
+                const UInt32 sequence = Read32(source + position);
+                UInt32 &entry = table[HashSequence(sequence)];
+                UInt32 candidate = entry;
+                entry = position;
+
+                if (candidate >= position || position - candidate > c_lzMaxOffset || Read32(source + candidate) != sequence)
+                {
+                    // Probe sparser the longer nothing matches, incompressible data goes by quickly.
+                    position += 1 + ((position - anchor) >> c_lzSkipShift);
+                    continue;
+                }
+
+                while (position > anchor && candidate > 0 && source[position - 1] == source[candidate - 1])
+                {
+                    --position;
+                    --candidate;
+                }
+
+                const UInt32 matchLength = GetMatchLength(source, position, candidate, matchEndLimit);
+
+                output = WriteSequence(output, outputEnd, source + anchor, position - anchor, position - candidate, matchLength);
+                if (output == nullptr)
+                {
+                    return 0;
+                }
+
+                position += matchLength;
+                anchor = position;
+
+                if (position <= matchStartLimit)
+                {
+                    table[HashSequence(Read32(source + position - 2))] = position - 2;
+                }
+            }
+        }
+
+        output = WriteSequence(output, outputEnd, source + anchor, sourceSize - anchor, 0, 0);
+        return output != nullptr ? static_cast<UInt32>(output - destination) : 0;
+    }
+
+    /**
+     * @brief Decompresses a block produced by LzCompress, validating every length and offset.
+     *
+     * @param source The compressed block.
+     * @param sourceSize The size of the compressed block.
+     * @param destination The buffer receiving the data.
+     * @param destinationSize The size of the buffer.
+     * @return The size of the data, c_lzInvalid if the block is malformed or doesn't fit.
+     */
+    UInt32 LzDecompress(const UByte *source, UInt32 sourceSize, UByte *destination, UInt32 destinationSize)
+    {
+        const UByte *input = source;
+        const UByte *inputEnd = source + sourceSize;
+        UByte *output = destination;
+        UByte *outputEnd = destination + destinationSize;
+
+        while (input != inputEnd)
+        {
+            const UByte token = *input++;
+
+            UInt32 literalLength = token >> 4;
+            if ((literalLength == 15 && !ReadLength(input, inputEnd, literalLength)) || literalLength > static_cast<size_t>(inputEnd - input) || literalLength > static_cast<size_t>(outputEnd - output))
+            {
+                return c_lzInvalid;
+            }
+
+            Memcpy(output, input, literalLength);
+            input += literalLength;
+            output += literalLength;
+
+            if (input == inputEnd)
+            {
+                return static_cast<UInt32>(output - destination);
+            }
+
+            if (inputEnd - input < 2)
+            {
+                return c_lzInvalid;
+            }
+
+            const UInt32 offset = input[0] | (input[1] << 8);
+            input += 2;
+
+            UInt32 matchLength = token & 15;
+            if ((matchLength == 15 && !ReadLength(input, inputEnd, matchLength)) || offset == 0 || offset > static_cast<size_t>(output - destination))
+            {
+                return c_lzInvalid;
+            }
+
+            matchLength += c_lzMinMatch;
+            if (matchLength > static_cast<size_t>(outputEnd - output))
+            {
+                return c_lzInvalid;
+            }
+
+            const UByte *match = output - offset;
+            if (offset >= matchLength)
+            {
+                Memcpy(output, match, matchLength);
+                output += matchLength;
+            }
+            else
+            {
+                // Overlapping match, repeats the last offset bytes.
+                for (UInt32 i = 0; i != matchLength; ++i)
+                {
+                    *output++ = match[i];
+                }
+            }
+        }
+
+        // An empty block still holds its final token.
+        return c_lzInvalid;
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef __CORESYSTEM_LZCOMPRESSION_H__
+#define __CORESYSTEM_LZCOMPRESSION_H__
+
+namespace uge::compression
+{
+    const UInt32 c_lzInvalid = UINT32_MAX;
+
+    /**
+     * @brief Self-contained LZ77 block codec, byte oriented like LZ4: a block is a sequence of
+     * [token][literal length][literals][UInt16 offset][match length] where the token holds 4 bits of
+     * each length and the lengths continue in 255 valued bytes. The last sequence only has literals.
+     * A block doesn't reference anything outside itself, so it decodes on its own.
+     */
+    CORESYSTEM_API UInt32 LzCompressBound(UInt32 size);
+    CORESYSTEM_API UInt32 LzCompress(const UByte *source, UInt32 sourceSize, UByte *destination, UInt32 destinationSize);
+    CORESYSTEM_API UInt32 LzDecompress(const UByte *source, UInt32 sourceSize, UByte *destination, UInt32 destinationSize);
+}
+
+#endif // __CORESYSTEM_LZCOMPRESSION_H__
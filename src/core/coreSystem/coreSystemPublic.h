@@ -1,15 +1,21 @@
 #ifndef __CORESYSTEM_PUBLIC_H__
 #define __CORESYSTEM_PUBLIC_H__
 
-#include "_module/coreSystemApi.h"
-
 #include "settings/settings.h"
 #include "settings/compiler.h"
+#include "_module/coreSystemApi.h"
+
 #include "settings/types.h"
 #include "threads/atomic.h"
 #include "crt.h"
 #include "log/log.h"
 #include "debugging/dbgUtils.h"
 #include "threads/threads.h"
+#include "threads/readWriteSpinLock.h"
+#include "threads/bigReaderLock.h"
+#include "threads/fiber.h"
+#include "jobs/jobSystem.h"
+#include "jobs/taskScheduler.h"
+#include "jobs/parallelFor.h"
 
 #endif // __CORESYSTEM_PUBLIC_H__
\ No newline at end of file
@@ -1,10 +1,14 @@
 #ifndef __UGE_CORESYSTEM_CRT_H__
 #define __UGE_CORESYSTEM_CRT_H__
 
+#include <ctime>
+
 namespace uge
 {
     void Memcpy( void* __restrict dest, const void* __restrict source, size_t size );
 
+    Int32 Memcmp( const void* left, const void* right, size_t size );
+
     void* Memset( void* ptr, UInt32 x, size_t n );
 
     void* Memzero( void* ptr, size_t n );
@@ -19,6 +23,7 @@ namespace uge
 
     size_t Strlen(const UniChar* str);
     size_t Strlen(const AnsiChar* str);
+    size_t Strnlen(const AnsiChar* str, size_t maxLength);
 
     AnsiChar* Strchr(AnsiChar* str, AnsiChar c);
     const AnsiChar* Strchr(const AnsiChar* str, AnsiChar c);
@@ -27,6 +32,10 @@ namespace uge
 
     Int32 Vsnprintf(AnsiChar* buffer, size_t count, const AnsiChar* format, va_list arg);
     Int32 Vsnprintf(UniChar* buffer, size_t count, const UniChar* format, va_list arg);
+
+    Int32 Snprintf(AnsiChar* buffer, size_t count, const AnsiChar* format, ...);
+
+    void Localtime(std::tm& result, std::time_t time);
 }
 
 #include "crt.inl"
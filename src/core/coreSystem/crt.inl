@@ -15,7 +15,12 @@ namespace uge
 
     UGE_FORCE_INLINE void Memcpy( void* __restrict dest, const void* __restrict source, size_t size )
     {
-        return;
+        ::memcpy( dest, source, size );
+    }
+
+    UGE_FORCE_INLINE Int32 Memcmp( const void* left, const void* right, size_t size )
+    {
+        return ::memcmp( left, right, size );
     }
 
     UGE_FORCE_INLINE void* Memset( void* ptr, UInt32 x, size_t n )
@@ -38,6 +43,7 @@ namespace uge
         return ptr;
     }
 
+#if defined( UGE_COMPILER_MSVC )
     UGE_FORCE_INLINE Bool Strcpy(AnsiChar *dest, const AnsiChar *src, size_t destSize, size_t srcSize)
     {
         return ::strncpy_s( dest, destSize, src, srcSize ) == 0;
@@ -57,6 +63,76 @@ namespace uge
     {
         return ::wcsncpy_s( dest, destSize, src, srcSize ) == 0;
     }
+#else
+    namespace priv
+    {
+        /**
+         * @brief strncpy_s: copies at most srcSize characters and always terminates dest. A srcSize of -1
+         * (_TRUNCATE) cuts src to fit and reports it, any other copy that doesn't fit leaves dest empty.
+         */
+        template<typename TChar>
+        UGE_FORCE_INLINE Bool Strncpy( TChar* dest, const TChar* src, size_t destSize, size_t srcSize )
+        {
+            if ( dest == nullptr || destSize == 0 )
+            {
+                return false;
+            }
+
+            size_t length = 0;
+            while ( length != srcSize && src[length] != 0 )
+            {
+                ++length;
+            }
+
+            const Bool fits = length < destSize;
+            if ( !fits )
+            {
+                if ( srcSize != static_cast<size_t>( -1 ) )
+                {
+                    dest[0] = 0;
+                    return false;
+                }
+                length = destSize - 1;
+            }
+
+            ::memmove( dest, src, length * sizeof( TChar ) );
+            dest[length] = 0;
+            return fits;
+        }
+
+        template<typename TChar>
+        UGE_FORCE_INLINE Bool Strncat( TChar* dest, const TChar* src, size_t destSize, size_t srcSize )
+        {
+            size_t offset = 0;
+            while ( offset != destSize && dest[offset] != 0 )
+            {
+                ++offset;
+            }
+
+            return offset != destSize && Strncpy( dest + offset, src, destSize - offset, srcSize );
+        }
+    }
+
+    UGE_FORCE_INLINE Bool Strcpy(AnsiChar *dest, const AnsiChar *src, size_t destSize, size_t srcSize)
+    {
+        return priv::Strncpy( dest, src, destSize, srcSize );
+    }
+
+    UGE_FORCE_INLINE Bool Strcat(UniChar *dest, const UniChar *src, size_t destSize, size_t srcSize)
+    {
+        return priv::Strncat( dest, src, destSize, srcSize );
+    }
+
+    UGE_FORCE_INLINE Bool Strcat(AnsiChar *dest, const AnsiChar *src, size_t destSize, size_t srcSize)
+    {
+        return priv::Strncat( dest, src, destSize, srcSize );
+    }
+
+    UGE_FORCE_INLINE Bool Strcpy( UniChar* dest, const UniChar* src, size_t destSize, size_t srcSize )
+    {
+        return priv::Strncpy( dest, src, destSize, srcSize );
+    }
+#endif
 
     UGE_FORCE_INLINE size_t Strlen(const UniChar *str)
     {
@@ -68,6 +144,11 @@ namespace uge
         return ::strlen( str );
     }
 
+    UGE_FORCE_INLINE size_t Strnlen(const AnsiChar *str, size_t maxLength)
+    {
+        return ::strnlen( str, maxLength );
+    }
+
     UGE_FORCE_INLINE AnsiChar *Strchr(AnsiChar *str, AnsiChar c)
     {
         return ::strchr( str, c );
@@ -88,6 +169,7 @@ namespace uge
         return ::wcschr( str, c );
     }
 
+#if defined( UGE_COMPILER_MSVC )
     UGE_FORCE_INLINE Int32 Vsnprintf(AnsiChar *buffer, size_t count, const AnsiChar *format, va_list arg)
     {
         return ::vsnprintf_s( buffer, count, _TRUNCATE, format, arg);
@@ -97,4 +179,35 @@ namespace uge
     {
         return ::_vsnwprintf_s( buffer, count, _TRUNCATE, format, arg );
     }
+#else
+    // Like _TRUNCATE, a line cut to fit the buffer returns -1 rather than the length it would have had.
+    UGE_FORCE_INLINE Int32 Vsnprintf(AnsiChar *buffer, size_t count, const AnsiChar *format, va_list arg)
+    {
+        const Int32 result = ::vsnprintf( buffer, count, format, arg );
+        return result >= 0 && static_cast<size_t>( result ) < count ? result : -1;
+    }
+
+    UGE_FORCE_INLINE Int32 Vsnprintf(UniChar *buffer, size_t count, const UniChar *format, va_list arg)
+    {
+        return ::vswprintf( buffer, count, format, arg );
+    }
+#endif
+
+    UGE_INLINE Int32 Snprintf(AnsiChar *buffer, size_t count, const AnsiChar *format, ...)
+    {
+        va_list argList;
+        va_start( argList, format );
+        const Int32 result = Vsnprintf( buffer, count, format, argList );
+        va_end( argList );
+        return result;
+    }
+
+    UGE_FORCE_INLINE void Localtime(std::tm& result, std::time_t time)
+    {
+#if defined( UGE_PLATFORM_WINDOWS )
+        ::localtime_s( &result, &time );
+#else
+        ::localtime_r( &time, &result );
+#endif
+    }
 }
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "build.h"
 
+#include <csignal>
+#include <cstring>
+
 #include "file/file.h"
 #include "dbgUtils.h"
 
@@ -50,9 +53,9 @@ namespace uge::dbg
             }
         }
 
-        if (IsDebuggerPresent())
+        if (IsDebuggerAttached())
         {
-            OutputDebugStringA(buffer);
+            DebugOutput(buffer);
         }
         else
         {
@@ -60,6 +63,7 @@ namespace uge::dbg
         }
     }
 
+#if defined(UGE_PLATFORM_WINDOWS)
     // CStackTrace
     CStackTrace::CStackTrace()
     {
@@ -241,12 +245,249 @@ namespace uge::dbg
 
         return true;
     }
+#endif
 
     // CAssert
     void CAssert::OnAssert(const AnsiChar *filename, UInt32 line, const AnsiChar *expression, const AnsiChar *message, ...)
     {
-        if (m_isHandlingAssert != 0)
+        // An assert raised while writing out the log would only recurse.
+        if (m_isHandlingAssert)
+        {
+            return;
+        }
+
+        m_isHandlingAssert = true;
+        m_assertType = AssertType_Assert;
+
+        const Int32 length = Snprintf(m_buffer, sizeof(m_buffer), "Assertion failed: %s (%s:%u) ", expression, filename, line);
+        if (length > 0 && message != nullptr)
+        {
+            va_list argList;
+            va_start(argList, message);
+            Vsnprintf(m_buffer + length, sizeof(m_buffer) - length, message, argList);
+            va_end(argList);
+        }
+
+        // The __debugbreak that follows ends the process when no debugger is attached.
+        log::LogFlushOnCrash(m_buffer);
+
+        m_assertType = AssertType_None;
+        m_isHandlingAssert = false;
+    }
+
+    /**
+     * @brief Whether a debugger is attached to the process, see DebugOutput.
+     */
+    Bool IsDebuggerAttached()
+    {
+#if defined(UGE_PLATFORM_WINDOWS)
+        return ::IsDebuggerPresent() != FALSE;
+#elif defined(UGE_PLATFORM_LINUX)
+        // A traced process reports its tracer's pid.
+        FILE *status = nullptr;
+        if (!file::FileOpen(&status, "/proc/self/status", "r"))
+        {
+            return false;
+        }
+
+        Int32 tracerPid = 0;
+        char line[256];
+        while (::fgets(line, sizeof(line), status) != nullptr)
+        {
+            if (::sscanf(line, "TracerPid: %d", &tracerPid) == 1)
+            {
+                break;
+            }
+        }
+        file::FileClose(status);
+
+        return tracerPid != 0;
+#endif
+    }
+
+    /**
+     * @brief Writes msg to the attached debugger's output. Debuggers on Linux show the process' stderr.
+     */
+    void DebugOutput(const AnsiChar *msg)
+    {
+#if defined(UGE_PLATFORM_WINDOWS)
+        ::OutputDebugStringA(msg);
+#elif defined(UGE_PLATFORM_LINUX)
+        ::fputs(msg, stderr);
+#endif
+    }
+
+    // Crash handler
+    namespace
+    {
+        Bool g_crashHandlerInstalled = false;
+
+#if defined(UGE_PLATFORM_WINDOWS)
+        typedef void (*SignalHandler_t)(int);
+
+        SignalHandler_t g_previousAbortHandler = SIG_DFL;
+        LPTOP_LEVEL_EXCEPTION_FILTER g_previousExceptionFilter = nullptr;
+
+        LONG WINAPI OnUnhandledException(EXCEPTION_POINTERS *exceptionPointers)
+        {
+            char reason[128];
+            Snprintf(reason, sizeof(reason), "Unhandled exception 0x%08X at %p", exceptionPointers->ExceptionRecord->ExceptionCode, exceptionPointers->ExceptionRecord->ExceptionAddress);
+            log::LogFlushOnCrash(reason);
+
+            return g_previousExceptionFilter != nullptr ? g_previousExceptionFilter(exceptionPointers) : EXCEPTION_CONTINUE_SEARCH;
+        }
+
+        void OnAbortSignal(int signal)
         {
+            log::LogFlushOnCrash("abort() called");
+
+            // Let the previous handler, or the default one, end the process.
+            ::signal(SIGABRT, g_previousAbortHandler);
+            ::raise(SIGABRT);
+        }
+#elif defined(UGE_PLATFORM_LINUX)
+        // The faults SetUnhandledExceptionFilter sees on Windows.
+        const int g_faultSignals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL};
+        struct sigaction g_previousFaultActions[sizeof(g_faultSignals) / sizeof(g_faultSignals[0])];
+        struct sigaction g_previousAbortAction;
+
+        // The signal handlers only build the reason with these, printf and strsignal aren't async-signal-safe.
+        char *AppendCrashText(char *out, char *end, const char *text)
+        {
+            while (out != end && *text != '\0')
+            {
+                *out++ = *text++;
+            }
+            return out;
+        }
+
+        char *AppendCrashNumber(char *out, char *end, UInt64 value, UInt32 base)
+        {
+            char digits[20];
+            UInt32 count = 0;
+            do
+            {
+                digits[count++] = "0123456789abcdef"[value % base];
+                value /= base;
+            } while (value != 0);
+
+            while (out != end && count != 0)
+            {
+                *out++ = digits[--count];
+            }
+            return out;
+        }
+
+        const char *GetCrashSignalName(int signal)
+        {
+            switch (signal)
+            {
+            case SIGSEGV:
+                return "Segmentation fault";
+            case SIGBUS:
+                return "Bus error";
+            case SIGFPE:
+                return "Floating point exception";
+            case SIGILL:
+                return "Illegal instruction";
+            default:
+                return "Unknown signal";
+            }
+        }
+
+        /**
+         * @brief Writes the reason to stderr with write(2), so it's out even if the log can't be drained.
+         */
+        void WriteCrashReason(const char *reason)
+        {
+            const ssize_t written = ::write(STDERR_FILENO, reason, Strlen(reason));
+            const ssize_t newLine = ::write(STDERR_FILENO, "\n", 1);
+            (void)written;
+            (void)newLine;
+        }
+
+        void OnFaultSignal(int signal, siginfo_t *info, void *context)
+        {
+            char reason[128];
+            char *end = reason + sizeof(reason) - 1;
+            char *out = AppendCrashText(reason, end, "Signal ");
+            out = AppendCrashNumber(out, end, static_cast<UInt64>(signal), 10);
+            out = AppendCrashText(out, end, " (");
+            out = AppendCrashText(out, end, GetCrashSignalName(signal));
+            out = AppendCrashText(out, end, ") at 0x");
+            out = AppendCrashNumber(out, end, reinterpret_cast<uintptr_t>(info->si_addr), 16);
+            *out = '\0';
+
+            WriteCrashReason(reason);
+            log::LogFlushOnCrash(reason);
+
+            // Returning re-runs the faulting instruction under the previous handler, or the default one.
+            for (UInt32 i = 0; i != sizeof(g_faultSignals) / sizeof(g_faultSignals[0]); ++i)
+            {
+                if (g_faultSignals[i] == signal)
+                {
+                    ::sigaction(signal, &g_previousFaultActions[i], nullptr);
+                }
+            }
+        }
+
+        void OnAbortSignal(int signal)
+        {
+            WriteCrashReason("abort() called");
+            log::LogFlushOnCrash("abort() called");
+
+            // Let the previous handler, or the default one, end the process.
+            ::sigaction(SIGABRT, &g_previousAbortAction, nullptr);
+            ::raise(SIGABRT);
+        }
+#endif
+    }
+
+    /**
+     * @brief Makes unhandled exceptions and abort() write out the log before the process goes away,
+     * see log::LogFlushOnCrash. Installed by log::InitLog, the previous handlers are chained.
+     */
+    void InstallCrashHandler()
+    {
+        if (!g_crashHandlerInstalled)
+        {
+#if defined(UGE_PLATFORM_WINDOWS)
+            g_previousExceptionFilter = ::SetUnhandledExceptionFilter(&OnUnhandledException);
+            g_previousAbortHandler = ::signal(SIGABRT, &OnAbortSignal);
+#elif defined(UGE_PLATFORM_LINUX)
+            struct sigaction action = {};
+            action.sa_sigaction = &OnFaultSignal;
+            action.sa_flags = SA_SIGINFO;
+            sigemptyset(&action.sa_mask);
+            for (UInt32 i = 0; i != sizeof(g_faultSignals) / sizeof(g_faultSignals[0]); ++i)
+            {
+                ::sigaction(g_faultSignals[i], &action, &g_previousFaultActions[i]);
+            }
+
+            struct sigaction abortAction = {};
+            abortAction.sa_handler = &OnAbortSignal;
+            sigemptyset(&abortAction.sa_mask);
+            ::sigaction(SIGABRT, &abortAction, &g_previousAbortAction);
+#endif
+            g_crashHandlerInstalled = true;
+        }
+    }
+
+    void UninstallCrashHandler()
+    {
+        if (g_crashHandlerInstalled)
+        {
+#if defined(UGE_PLATFORM_WINDOWS)
+            ::SetUnhandledExceptionFilter(g_previousExceptionFilter);
+            ::signal(SIGABRT, g_previousAbortHandler);
+#elif defined(UGE_PLATFORM_LINUX)
+            for (UInt32 i = 0; i != sizeof(g_faultSignals) / sizeof(g_faultSignals[0]); ++i)
+            {
+                ::sigaction(g_faultSignals[i], &g_previousFaultActions[i], nullptr);
+            }
+            ::sigaction(SIGABRT, &g_previousAbortAction, nullptr);
+#endif
+            g_crashHandlerInstalled = false;
         }
     }
 }
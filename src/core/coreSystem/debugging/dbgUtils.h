@@ -1,13 +1,17 @@
 #ifndef __CORESYSTEM_DBGUTILS_H__
 #define __CORESYSTEM_DBGUTILS_H__
 
+#if defined( UGE_PLATFORM_WINDOWS )
 #include <DbgHelp.h>
+#endif
 
 namespace uge::dbg
 {
+#if defined( UGE_PLATFORM_WINDOWS )
     typedef HANDLE hProcess_t;
     typedef HANDLE hThread_t;
     typedef CONTEXT Context_t;
+#endif
 
     enum EAssertType
     {
@@ -38,6 +42,7 @@ namespace uge::dbg
         AnsiChar buffer[BUFFER_SIZE];
     };
 
+#if defined( UGE_PLATFORM_WINDOWS )
     class CORESYSTEM_API CStackTrace
     {
     private:
@@ -98,6 +103,7 @@ namespace uge::dbg
         // All of our stack info
         SStackTrace m_addrInfo;
     };
+#endif
 
     class CORESYSTEM_API CAssert
     {
@@ -115,6 +121,12 @@ namespace uge::dbg
         EAssertType m_assertType;
         Bool m_isHandlingAssert;
     };
+
+    CORESYSTEM_API Bool IsDebuggerAttached();
+    CORESYSTEM_API void DebugOutput(const AnsiChar *msg);
+
+    CORESYSTEM_API void InstallCrashHandler();
+    CORESYSTEM_API void UninstallCrashHandler();
 }
 
 extern CORESYSTEM_API uge::dbg::CAssert g_assert;
@@ -127,18 +139,18 @@ extern CORESYSTEM_API uge::dbg::CTrace g_trace;
         if (!(cond))                                                          \
         {                                                                     \
             g_assert.OnAssert(__FILE__, __LINE__, #cond, msg, ##__VA_ARGS__); \
-            __debugbreak();                                                   \
+            UGE_DEBUG_BREAK();                                                \
         }                                                                     \
     } while ((void)0, 0)
 
-#define UGE_VERIFY(expr, msg, ...)                            \
-    do                                                        \
-    {                                                         \
-        if (!(expr))                                          \
-        {                                                     \
-            UGE_LOG_ERROR("%hs: " msg, #expr, ##__VA_ARGS__); \
-            __debugbreak();                                   \
-        }                                                     \
+#define UGE_VERIFY(expr, msg, ...)                                                        \
+    do                                                                                    \
+    {                                                                                     \
+        if (!(expr))                                                                      \
+        {                                                                                 \
+            UGE_LOG_ERROR(uge::log::LogCategory_Core, "%hs: " msg, #expr, ##__VA_ARGS__); \
+            UGE_DEBUG_BREAK();                                                            \
+        }                                                                                 \
     } while ((void)0, 0)
 
 #define UGE_TRACE(msg, ...)                \
@@ -147,6 +159,7 @@ extern CORESYSTEM_API uge::dbg::CTrace g_trace;
         g_trace.Trace(msg, ##__VA_ARGS__); \
     } while ((void)0, 0)
 
+#if defined(UGE_PLATFORM_WINDOWS)
 #define UGE_CHECK_WINAPI(expr)                                                \
     do                                                                        \
     {                                                                         \
@@ -154,11 +167,13 @@ extern CORESYSTEM_API uge::dbg::CTrace g_trace;
         DWORD error = GetLastError();                                         \
         UGE_ASSERT(!result, #expr, "\nGetLastError() result: 0x%08X", error); \
     } while (0)
+#endif
 
 #else
 #define UGE_ASSERT(cond, msg, ...) \
     do                             \
-    {} while( (void)0, 0) )
+    {                              \
+    } while ((void)0, 0)
 #define UGE_VERIFY(expr, msg, ...) \
     do                             \
     {                              \
@@ -166,6 +181,10 @@ extern CORESYSTEM_API uge::dbg::CTrace g_trace;
         {                          \
         }                          \
     } while ((void)0, 0)
+#define UGE_TRACE(msg, ...) \
+    do                      \
+    {                       \
+    } while ((void)0, 0)
 #endif
 
 #endif // __CORESYSTEM_DBGUTILS_H__
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "file.h"
 
+#if defined( UGE_PLATFORM_WINDOWS )
 #include <share.h>
+#endif
 
 namespace uge
 {
@@ -8,7 +10,11 @@ namespace uge
     {
         CORESYSTEM_API Bool FileOpen(FILE **file, const AnsiChar *fileName, const AnsiChar *mode)
         {
+#if defined( UGE_PLATFORM_WINDOWS )
             *file = ::_fsopen(fileName, mode, SH_DENYNO);
+#else
+            *file = ::fopen(fileName, mode);
+#endif
             return *file != nullptr;
         }
 
@@ -26,5 +32,31 @@ namespace uge
         {
             ::fputs(buffer, file);
         }
+
+        CORESYSTEM_API Bool FileWrite(FILE *file, const void *buffer, UInt32 size)
+        {
+            return ::fwrite(buffer, 1, size, file) == size;
+        }
+
+        CORESYSTEM_API UInt32 FileRead(FILE *file, void *buffer, UInt32 size)
+        {
+            return static_cast<UInt32>(::fread(buffer, 1, size, file));
+        }
+
+        CORESYSTEM_API Int64 FileGetSize(FILE *file)
+        {
+#if defined( UGE_PLATFORM_WINDOWS )
+            const Int64 position = ::_ftelli64(file);
+            ::_fseeki64(file, 0, SEEK_END);
+            const Int64 size = ::_ftelli64(file);
+            ::_fseeki64(file, position, SEEK_SET);
+#else
+            const Int64 position = ::ftello(file);
+            ::fseeko(file, 0, SEEK_END);
+            const Int64 size = ::ftello(file);
+            ::fseeko(file, position, SEEK_SET);
+#endif
+            return size;
+        }
     }
 }
\ No newline at end of file
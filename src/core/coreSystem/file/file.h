@@ -11,6 +11,9 @@ namespace uge
         CORESYSTEM_API Bool FileClose( FILE* file );
         CORESYSTEM_API Bool FileFlush( FILE* file );
         CORESYSTEM_API void FilePrint( FILE* file, const AnsiChar* buffer );
+        CORESYSTEM_API Bool FileWrite( FILE* file, const void* buffer, UInt32 size );
+        CORESYSTEM_API UInt32 FileRead( FILE* file, void* buffer, UInt32 size );
+        CORESYSTEM_API Int64 FileGetSize( FILE* file );
     }
 }
 
@@ -0,0 +1,58 @@
+#ifndef __CORESYSTEM_JOBQUEUE_H__
+#define __CORESYSTEM_JOBQUEUE_H__
+
+#include "threads/atomic.h"
+
+namespace uge::jobs
+{
+    class JobCounter;
+
+    typedef void (*JobFunction)(void *data);
+
+    /**
+     * @brief A scheduled unit of work: the function, its argument and the counter it decrements once done.
+     */
+    struct Job
+    {
+        JobFunction m_function;
+        void *m_data;
+        JobCounter *m_counter;
+    };
+
+    /**
+     * @brief Bounded Chase-Lev work-stealing deque owned by one worker.
+     *
+     * The owner pushes and pops at the bottom, LIFO, so it keeps working on what it touched last;
+     * any other thread steals from the top, FIFO, the oldest and usually largest jobs. Only the
+     * last job is contended, the owner and the thieves then race on the top with a CAS.
+     */
+    class CORESYSTEM_API JobQueue
+    {
+    public:
+        JobQueue();
+        ~JobQueue();
+
+        Bool Push(const Job &job);
+        Bool Pop(Job &job);
+        Bool Steal(Job &job);
+
+        UInt32 GetSize() const;
+
+    private:
+        constexpr static UInt32 c_jobQueueSize = 4096;
+        constexpr static UInt32 c_jobQueueMask = c_jobQueueSize - 1;
+        constexpr static UInt32 c_cacheLineSize = 64;
+
+        // Taken by the thieves.
+        UGE_ALIGNED_VAR(AtomicLong, c_cacheLineSize) m_top;
+
+        // Written by the owner only.
+        UGE_ALIGNED_VAR(AtomicLong, c_cacheLineSize) m_bottom;
+
+        UGE_ALIGNED_VAR(Job, c_cacheLineSize) m_jobs[c_jobQueueSize];
+    };
+}
+
+#include "jobQueue.inl"
+
+#endif // __CORESYSTEM_JOBQUEUE_H__
@@ -0,0 +1,97 @@
+#ifndef __CORESYSTEM_JOBQUEUE_INL__
+#define __CORESYSTEM_JOBQUEUE_INL__
+
+namespace uge::jobs
+{
+    UGE_INLINE JobQueue::JobQueue()
+        : m_top(0),
+          m_bottom(0)
+    {
+    }
+
+    UGE_INLINE JobQueue::~JobQueue()
+    {
+    }
+
+    /**
+     * @brief Pushes a job at the bottom. Only the owning worker may call this.
+     *
+     * @return false if the queue is full, the caller should run the job itself.
+     */
+    UGE_FORCE_INLINE Bool JobQueue::Push(const Job &job)
+    {
+        const AtomicLong bottom = m_bottom;
+
+        // The top only ever grows, a stale one underestimates the free room.
+        if (bottom - atomic::Atomic64::Fetch(&m_top) >= c_jobQueueSize)
+        {
+            return false;
+        }
+
+        m_jobs[bottom & c_jobQueueMask] = job;
+        atomic::Atomic64::Store(&m_bottom, bottom + 1);
+        return true;
+    }
+
+    /**
+     * @brief Pops the most recently pushed job. Only the owning worker may call this.
+     *
+     * @return false if the queue is empty or a thief took the last job.
+     */
+    UGE_FORCE_INLINE Bool JobQueue::Pop(Job &job)
+    {
+        const AtomicLong bottom = m_bottom - 1;
+
+        // Full fence: the thieves must see the bottom move before we read the top.
+        atomic::Atomic64::Exchange(&m_bottom, bottom);
+        const AtomicLong top = atomic::Atomic64::Fetch(&m_top);
+
+        if (top > bottom)
+        {
+            atomic::Atomic64::Store(&m_bottom, bottom + 1);
+            return false;
+        }
+
+        job = m_jobs[bottom & c_jobQueueMask];
+        if (top != bottom)
+        {
+            return true;
+        }
+
+        // Last job, the thieves may be going for it too.
+        const Bool won = atomic::Atomic64::CompareExchange(&m_top, top + 1, top) == top;
+        atomic::Atomic64::Store(&m_bottom, bottom + 1);
+        return won;
+    }
+
+    /**
+     * @brief Takes the oldest job. Any thread may call this.
+     *
+     * @return false if the queue is empty or another thread took the job first.
+     */
+    UGE_FORCE_INLINE Bool JobQueue::Steal(Job &job)
+    {
+        const AtomicLong top = atomic::Atomic64::Fetch(&m_top);
+        const AtomicLong bottom = atomic::Atomic64::Fetch(&m_bottom);
+        if (top >= bottom)
+        {
+            return false;
+        }
+
+        // The slot can't be reused before the top moves past it, a copy taken by a losing thief is thrown away.
+        job = m_jobs[top & c_jobQueueMask];
+        return atomic::Atomic64::CompareExchange(&m_top, top + 1, top) == top;
+    }
+
+    /**
+     * @brief Number of queued jobs, only a hint while other threads use the queue.
+     */
+    UGE_INLINE UInt32 JobQueue::GetSize() const
+    {
+        const AtomicLong top = atomic::Atomic64::Fetch(const_cast<AtomicLong *>(&m_top));
+        const AtomicLong bottom = atomic::Atomic64::Fetch(const_cast<AtomicLong *>(&m_bottom));
+        return bottom > top ? static_cast<UInt32>(bottom - top) : 0;
+    }
+}
+
+#endif // __CORESYSTEM_JOBQUEUE_INL__
@@ -0,0 +1,645 @@
+#include "build.h"
+
+#include "jobSystem.h"
+#include "jobWorkerThread.h"
+
+#include <thread>
+
+namespace uge::jobs
+{
+    namespace priv
+    {
+        // The system and index of the worker running on this thread, if any.
+        thread_local JobSystem *t_jobSystem = nullptr;
+        thread_local UInt32 t_workerIndex = JobSystem::c_noWorkerIndex;
+        thread_local UInt32 t_randomState = 0;
+
+        // The job fiber running on this thread, nullptr while the thread runs on its own stack.
+        thread_local JobFiber *t_currentFiber = nullptr;
+
+        // A fiber may resume on another thread: the thread locals are only read through functions the
+        // compiler can't inline, so it doesn't keep their address across a switch.
+
+        UGE_NOINLINE JobFiber *GetCurrentFiber()
+        {
+            return t_currentFiber;
+        }
+
+        UGE_NOINLINE void SetCurrentFiber(JobFiber *fiber)
+        {
+            t_currentFiber = fiber;
+        }
+
+        /**
+         * @brief xorshift32, enough to spread the thieves over their victims.
+         */
+        UGE_NOINLINE UInt32 NextRandom()
+        {
+            UInt32 state = t_randomState;
+            if (state == 0)
+            {
+                state = ThreadId::GetCurrentThread().Get() | 1;
+            }
+
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            t_randomState = state;
+            return state;
+        }
+    }
+
+    JobSystem::JobSystem()
+        : m_queues(nullptr),
+          m_workers(nullptr),
+          m_workerCount(0),
+          m_running(0),
+          m_fibers(nullptr),
+          m_fiberCount(0),
+          m_workerFibers(nullptr),
+          m_spareFibers(nullptr),
+          m_readyCount(0),
+          m_wakeup(nullptr),
+          m_sleepingCount(0),
+          m_sharedCount(0)
+    {
+    }
+
+    JobSystem::~JobSystem()
+    {
+        UGE_ASSERT(m_workerCount == 0, "Job system destroyed without Deinit");
+    }
+
+    /**
+     * @brief Starts the workers. The calling thread becomes worker 0.
+     *
+     * @param workerCount Number of workers, the calling thread included. 0 for one per hardware thread.
+     * @param fiberCount Number of fibers the jobs run on, once they are all waiting jobs run on the worker stacks. 0 always runs jobs on the worker stacks.
+     */
+    void JobSystem::Init(UInt32 workerCount, UInt32 fiberCount)
+    {
+        UGE_ASSERT(m_workerCount == 0, "Job system already initialized");
+
+        if (workerCount == 0)
+        {
+            workerCount = GetHardwareThreadCount();
+        }
+        m_workerCount = workerCount < c_maxWorkerCount ? workerCount : c_maxWorkerCount;
+
+        m_queues = new JobQueue[m_workerCount];
+        m_workers = new JobWorkerThread[m_workerCount - 1];
+        m_wakeup = new Semaphore(0, static_cast<Int32>(m_workerCount));
+        atomic::Atomic32::Store(&m_running, 1);
+
+        if (fiberCount != 0)
+        {
+            m_fiberCount = fiberCount;
+            m_fibers = new JobFiber[m_fiberCount];
+            m_freeFibers.reserve(m_fiberCount);
+            for (UInt32 i = 0; i != m_fiberCount; ++i)
+            {
+                JobFiber &fiber = m_fibers[i];
+                fiber.m_jobSystem = this;
+                fiber.m_scheduler = nullptr;
+                fiber.m_waitCounter = nullptr;
+                fiber.m_fiber.Init(&JobSystem::FiberMain, &fiber, c_fiberStackSize);
+                m_freeFibers.push_back(&fiber);
+            }
+
+            m_workerFibers = new Fiber[m_workerCount];
+            m_spareFibers = new JobFiber *[m_workerCount]();
+            m_workerFibers[0].InitFromThread();
+        }
+
+        priv::t_jobSystem = this;
+        priv::t_workerIndex = 0;
+
+        for (UInt32 i = 1; i != m_workerCount; ++i)
+        {
+            m_workers[i - 1].Start(this, i);
+        }
+    }
+
+    /**
+     * @brief Stops the workers. Call it from the thread that called Init, once every counter is done.
+     */
+    void JobSystem::Deinit()
+    {
+        UGE_ASSERT(priv::t_jobSystem == this && priv::t_workerIndex == 0, "Deinit called from another thread than Init");
+
+        atomic::Atomic32::Store(&m_running, 0);
+        atomic::MemoryFence();
+        ReleaseWakeups(m_workerCount - 1);
+
+        for (UInt32 i = 1; i != m_workerCount; ++i)
+        {
+            m_workers[i - 1].Stop();
+        }
+
+        priv::t_jobSystem = nullptr;
+        priv::t_workerIndex = c_noWorkerIndex;
+
+        if (m_fibers)
+        {
+            UGE_ASSERT(m_readyFibers.empty(), "Job system stopped while jobs wait");
+
+            m_workerFibers[0].Deinit();
+            delete[] m_spareFibers;
+            delete[] m_workerFibers;
+            delete[] m_fibers;
+            m_freeFibers.clear();
+            m_spareFibers = nullptr;
+            m_workerFibers = nullptr;
+            m_fibers = nullptr;
+            m_fiberCount = 0;
+        }
+
+        delete m_wakeup;
+        delete[] m_workers;
+        delete[] m_queues;
+        m_wakeup = nullptr;
+        m_workers = nullptr;
+        m_queues = nullptr;
+        m_workerCount = 0;
+    }
+
+    /**
+     * @brief Schedules jobs. Any thread may call this.
+     *
+     * @param jobs The jobs to run, copied before returning.
+     * @param count The number of jobs.
+     * @param counter Counts the jobs down as they finish, may be nullptr.
+     * @param dependency The jobs are only scheduled once this counter is done, may be nullptr.
+     */
+    void JobSystem::Run(const JobDecl *jobs, UInt32 count, JobCounter *counter, JobCounter *dependency)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (counter)
+        {
+            counter->Add(count);
+        }
+
+        // Small batches are built on the stack, larger ones are split.
+        constexpr UInt32 c_batchSize = 64;
+        Job batch[c_batchSize];
+
+        for (UInt32 first = 0; first < count; first += c_batchSize)
+        {
+            const UInt32 batchCount = count - first < c_batchSize ? count - first : c_batchSize;
+            for (UInt32 i = 0; i != batchCount; ++i)
+            {
+                batch[i] = Job{jobs[first + i].m_function, jobs[first + i].m_data, counter};
+            }
+
+            if (dependency && !dependency->IsDone())
+            {
+                ScopedLock<Mutex> lock(dependency->m_dependentsLock);
+                // Releasing counts as done, its dependents were already taken.
+                if (atomic::Atomic32::Fetch(&dependency->m_value) > 0)
+                {
+                    dependency->m_dependents.insert(dependency->m_dependents.end(), batch, batch + batchCount);
+                    continue;
+                }
+            }
+
+            Schedule(batch, batchCount);
+        }
+    }
+
+    /**
+     * @brief Returns once the counter is done. A job parks its fiber meanwhile, other callers run jobs
+     * until then, so waiting never leaves a core idle.
+     */
+    void JobSystem::WaitForCounter(JobCounter *counter)
+    {
+        JobFiber *fiber = priv::GetCurrentFiber();
+        if (fiber)
+        {
+            // Resumed early if the counter was releasing when parked, it only reads as done once
+            // the last job is through with it.
+            while (!counter->IsDone())
+            {
+                fiber->m_waitCounter = counter;
+                Fiber::Switch(fiber->m_fiber, *fiber->m_scheduler);
+            }
+            return;
+        }
+
+        const UInt32 workerIndex = GetCurrentWorkerIndex();
+        while (!counter->IsDone())
+        {
+            if (!RunWork(workerIndex))
+            {
+                Thread_Yield();
+            }
+        }
+    }
+
+    /**
+     * @brief Runs one job, from this worker's queue first, then the shared one, then stolen from another worker.
+     *
+     * @return false if no job was found.
+     */
+    Bool JobSystem::RunPendingJob()
+    {
+        Job job;
+        if (!FindJob(job))
+        {
+            return false;
+        }
+
+        Execute(job);
+        return true;
+    }
+
+    /**
+     * @brief Index of the worker running on the calling thread, c_noWorkerIndex for other threads.
+     */
+    UGE_NOINLINE UInt32 JobSystem::GetCurrentWorkerIndex() const
+    {
+        return priv::t_jobSystem == this ? priv::t_workerIndex : c_noWorkerIndex;
+    }
+
+    /**
+     * @brief Number of jobs queued by the calling worker, 0 for threads that aren't workers.
+     */
+    UInt32 JobSystem::GetLocalQueueSize() const
+    {
+        const UInt32 workerIndex = GetCurrentWorkerIndex();
+        return workerIndex != c_noWorkerIndex ? m_queues[workerIndex].GetSize() : 0;
+    }
+
+    UInt32 JobSystem::GetHardwareThreadCount()
+    {
+        const UInt32 count = std::thread::hardware_concurrency();
+        return count != 0 ? count : 1;
+    }
+
+    void JobSystem::FiberMain(void *userData)
+    {
+        JobFiber *fiber = static_cast<JobFiber *>(userData);
+        fiber->m_jobSystem->RunFiber(fiber);
+    }
+
+    void JobSystem::WorkerLoop(UInt32 workerIndex)
+    {
+        priv::t_jobSystem = this;
+        priv::t_workerIndex = workerIndex;
+
+        if (m_fibers)
+        {
+            m_workerFibers[workerIndex].InitFromThread();
+        }
+
+        UInt32 idleSpins = 0;
+        while (atomic::Atomic32::Fetch(&m_running))
+        {
+            if (RunWork(workerIndex))
+            {
+                idleSpins = 0;
+                continue;
+            }
+
+            if (++idleSpins < c_idleSpinCount)
+            {
+                Thread_Yield();
+                continue;
+            }
+
+            // Announce the sleep before the last look: Schedule publishes the jobs before reading
+            // the count, so either we find them or it wakes us.
+            atomic::Atomic32::Increment(&m_sleepingCount);
+            if (RunWork(workerIndex))
+            {
+                atomic::Atomic32::Decrement(&m_sleepingCount);
+                idleSpins = 0;
+                continue;
+            }
+
+            if (atomic::Atomic32::Fetch(&m_running))
+            {
+                m_wakeup->Acquire();
+            }
+            atomic::Atomic32::Decrement(&m_sleepingCount);
+            idleSpins = 0;
+        }
+
+        if (m_fibers)
+        {
+            m_workerFibers[workerIndex].Deinit();
+        }
+
+        priv::t_jobSystem = nullptr;
+        priv::t_workerIndex = c_noWorkerIndex;
+    }
+
+    /**
+     * @brief Runs a job or resumes a readied fiber.
+     *
+     * @return false if there was nothing to run.
+     */
+    Bool JobSystem::RunWork(UInt32 workerIndex)
+    {
+        if (!m_fibers || workerIndex == c_noWorkerIndex)
+        {
+            return RunPendingJob();
+        }
+
+        JobFiber *fiber = nullptr;
+        if (atomic::Atomic32::Fetch(&m_readyCount) != 0)
+        {
+            ScopedLock<Mutex> lock(m_fiberLock);
+            if (!m_readyFibers.empty())
+            {
+                fiber = m_readyFibers.front();
+                m_readyFibers.pop_front();
+                atomic::Atomic32::Decrement(&m_readyCount);
+            }
+        }
+
+        if (!fiber)
+        {
+            fiber = AcquireFiber(workerIndex);
+            if (!fiber)
+            {
+                // Out of fibers, every one is parked or running: the job runs on the worker's stack
+                // and blocks it while it waits, the parked fibers can't make progress otherwise.
+                return RunPendingJob();
+            }
+
+            if (!FindJob(fiber->m_job))
+            {
+                return false;
+            }
+            m_spareFibers[workerIndex] = nullptr;
+        }
+
+        SwitchToFiber(workerIndex, fiber);
+        return true;
+    }
+    void JobSystem::Schedule(const Job *jobs, UInt32 count)
+    {
+        const UInt32 workerIndex = GetCurrentWorkerIndex();
+        if (workerIndex != c_noWorkerIndex)
+        {
+            JobQueue &queue = m_queues[workerIndex];
+            for (UInt32 i = 0; i != count; ++i)
+            {
+                // A full queue means plenty of work for the thieves already.
+                if (!queue.Push(jobs[i]))
+                {
+                    Execute(jobs[i]);
+                }
+            }
+        }
+        else
+        {
+            ScopedLock<Mutex> lock(m_sharedLock);
+            m_sharedJobs.insert(m_sharedJobs.end(), jobs, jobs + count);
+            atomic::Atomic32::ExchangeAdd(&m_sharedCount, static_cast<AtomicInt>(count));
+        }
+
+        WakeWorkers(count);
+    }
+
+    void JobSystem::WakeWorkers(UInt32 count)
+    {
+        atomic::MemoryFence();
+        const AtomicInt sleepingCount = atomic::Atomic32::Fetch(&m_sleepingCount);
+        if (sleepingCount != 0)
+        {
+            ReleaseWakeups(static_cast<Int32>(count) < sleepingCount ? count : static_cast<UInt32>(sleepingCount));
+        }
+    }
+
+    /**
+     * @brief Releases up to count wakeup permits, one at a time: permits a woken worker didn't take
+     * yet may leave the semaphore near its maximum, releasing several at once would then fail whole.
+     * A full semaphore already holds a permit for every worker.
+     */
+    void JobSystem::ReleaseWakeups(UInt32 count)
+    {
+        for (UInt32 i = 0; i != count && m_wakeup->Release(1); ++i)
+        {
+        }
+    }
+
+    Bool JobSystem::FindJob(Job &job)
+    {
+        const UInt32 workerIndex = GetCurrentWorkerIndex();
+        if (workerIndex != c_noWorkerIndex && m_queues[workerIndex].Pop(job))
+        {
+            return true;
+        }
+
+        if (atomic::Atomic32::Fetch(&m_sharedCount) != 0)
+        {
+            ScopedLock<Mutex> lock(m_sharedLock);
+            if (!m_sharedJobs.empty())
+            {
+                job = m_sharedJobs.front();
+                m_sharedJobs.pop_front();
+                atomic::Atomic32::Decrement(&m_sharedCount);
+                return true;
+            }
+        }
+
+        const UInt32 firstVictim = priv::NextRandom() % m_workerCount;
+        for (UInt32 i = 0; i != m_workerCount; ++i)
+        {
+            const UInt32 victim = (firstVictim + i) % m_workerCount;
+            if (victim != workerIndex && m_queues[victim].Steal(job))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void JobSystem::Execute(const Job &job)
+    {
+        JobCounter *counter = job.m_counter;
+        job.m_function(job.m_data);
+
+        if (counter)
+        {
+            CompleteJob(counter);
+        }
+    }
+
+    void JobSystem::CompleteJob(JobCounter *counter)
+    {
+        for (;;)
+        {
+            const AtomicInt value = atomic::Atomic32::Fetch(&counter->m_value);
+            UGE_ASSERT(value > 0, "Job counter completed more jobs than it counted");
+
+            // The last job marks the counter as releasing rather than done: the waiters may destroy
+            // it as soon as it reads as done, the dependents must be scheduled before.
+            const AtomicInt newValue = value == 1 ? JobCounter::c_releasingValue : value - 1;
+            if (atomic::Atomic32::CompareExchange(&counter->m_value, newValue, value) == value)
+            {
+                if (value != 1)
+                {
+                    return;
+                }
+                break;
+            }
+        }
+
+        std::vector<Job> dependents;
+        std::vector<JobFiber *> waitingFibers;
+        {
+            ScopedLock<Mutex> lock(counter->m_dependentsLock);
+            dependents.swap(counter->m_dependents);
+            waitingFibers.swap(counter->m_waitingFibers);
+        }
+
+        if (!dependents.empty())
+        {
+            Schedule(dependents.data(), static_cast<UInt32>(dependents.size()));
+        }
+
+        atomic::Atomic32::Store(&counter->m_value, 0);
+
+        // The parked fibers don't touch the counter until resumed.
+        if (!waitingFibers.empty())
+        {
+            ReadyFibers(waitingFibers.data(), static_cast<UInt32>(waitingFibers.size()));
+        }
+    }
+
+    /**
+     * @brief Body of the pooled fibers: runs the job it was handed, then more while it finds some.
+     */
+    void JobSystem::RunFiber(JobFiber *fiber)
+    {
+        for (;;)
+        {
+            Execute(fiber->m_job);
+
+            // Staying on the fiber is cheaper than switching back for the next job, the readied
+            // fibers go first though.
+            while (atomic::Atomic32::Fetch(&m_readyCount) == 0 && FindJob(fiber->m_job))
+            {
+                Execute(fiber->m_job);
+            }
+
+            fiber->m_waitCounter = nullptr;
+            Fiber::Switch(fiber->m_fiber, *fiber->m_scheduler);
+        }
+    }
+
+    /**
+     * @brief Runs the fiber on the worker until it waits or runs out of jobs, then parks or frees it.
+     */
+    void JobSystem::SwitchToFiber(UInt32 workerIndex, JobFiber *fiber)
+    {
+        fiber->m_scheduler = &m_workerFibers[workerIndex];
+        priv::SetCurrentFiber(fiber);
+        Fiber::Switch(m_workerFibers[workerIndex], fiber->m_fiber);
+        priv::SetCurrentFiber(nullptr);
+
+        // The fiber is off its stack now, safe to hand to another worker.
+        if (fiber->m_waitCounter)
+        {
+            ParkFiber(fiber);
+        }
+        else if (!m_spareFibers[workerIndex])
+        {
+            m_spareFibers[workerIndex] = fiber;
+        }
+        else
+        {
+            ScopedLock<Mutex> lock(m_fiberLock);
+            m_freeFibers.push_back(fiber);
+        }
+    }
+
+    void JobSystem::ParkFiber(JobFiber *fiber)
+    {
+        JobCounter *counter = fiber->m_waitCounter;
+        fiber->m_waitCounter = nullptr;
+        {
+            ScopedLock<Mutex> lock(counter->m_dependentsLock);
+            if (atomic::Atomic32::Fetch(&counter->m_value) > 0)
+            {
+                counter->m_waitingFibers.push_back(fiber);
+                return;
+            }
+        }
+
+        ReadyFibers(&fiber, 1);
+    }
+
+    void JobSystem::ReadyFibers(JobFiber *const *fibers, UInt32 count)
+    {
+        {
+            ScopedLock<Mutex> lock(m_fiberLock);
+            m_readyFibers.insert(m_readyFibers.end(), fibers, fibers + count);
+            atomic::Atomic32::ExchangeAdd(&m_readyCount, static_cast<AtomicInt>(count));
+        }
+
+        WakeWorkers(count);
+    }
+
+    JobFiber *JobSystem::AcquireFiber(UInt32 workerIndex)
+    {
+        JobFiber *&spareFiber = m_spareFibers[workerIndex];
+        if (!spareFiber)
+        {
+            ScopedLock<Mutex> lock(m_fiberLock);
+            if (!m_freeFibers.empty())
+            {
+                spareFiber = m_freeFibers.back();
+                m_freeFibers.pop_back();
+            }
+        }
+
+        return spareFiber;
+    }
+
+    namespace priv
+    {
+        JobSystem *CreateJobSystem()
+        {
+            static JobSystem s_jobSystem;
+            return &s_jobSystem;
+        }
+    }
+
+    /**
+     * @brief Returns the engine's job system.
+     */
+    JobSystem &GetJobSystem()
+    {
+        static JobSystem *s_jobSystemPointer = nullptr;
+        if (!s_jobSystemPointer)
+        {
+            s_jobSystemPointer = priv::CreateJobSystem();
+        }
+
+        return *s_jobSystemPointer;
+    }
+
+    /**
+     * @brief Starts the engine's job system, the calling thread becomes worker 0.
+     */
+    void InitJobSystem(UInt32 workerCount, UInt32 fiberCount)
+    {
+        GetJobSystem().Init(workerCount, fiberCount);
+    }
+
+    /**
+     * @brief Stops the engine's job system.
+     */
+    void DeinitJobSystem()
+    {
+        GetJobSystem().Deinit();
+    }
+}
@@ -0,0 +1,165 @@
+#ifndef __CORESYSTEM_JOBSYSTEM_H__
+#define __CORESYSTEM_JOBSYSTEM_H__
+
+#include "jobQueue.h"
+#include "threads/fiber.h"
+
+#include <deque>
+#include <vector>
+
+namespace uge::jobs
+{
+    class JobSystem;
+    class JobWorkerThread;
+
+    /**
+     * @brief A job to run: the function and the argument it's called with.
+     */
+    struct JobDecl
+    {
+        JobFunction m_function;
+        void *m_data;
+    };
+
+    /**
+     * @brief Pooled fiber the workers run jobs on, so a job waiting on a counter parks its fiber instead of its thread.
+     */
+    struct JobFiber
+    {
+        Fiber m_fiber;
+        JobSystem *m_jobSystem;
+        Job m_job;
+
+        // The fiber of the worker that switched to it, to switch back to.
+        Fiber *m_scheduler;
+
+        // Set when the fiber switches back to wait on a counter, nullptr once it ran out of jobs.
+        JobCounter *m_waitCounter;
+    };
+
+    /**
+     * @brief Handle on a group of jobs: counts the ones still to run, and holds the jobs waiting on them.
+     *
+     * A counter must outlive the jobs counted on it and the Run calls that depend on it, and may
+     * only be reused once done.
+     */
+    class CORESYSTEM_API JobCounter
+    {
+        UGE_NOCLASSCOPY(JobCounter)
+
+    public:
+        JobCounter();
+        ~JobCounter();
+
+        Bool IsDone() const;
+        UInt32 GetValue() const;
+
+    private:
+        friend class JobSystem;
+
+        constexpr static AtomicInt c_releasingValue = -1;
+
+        void Add(UInt32 count);
+
+        // Jobs left to run, c_releasingValue while the last one schedules the dependents.
+        AtomicInt m_value;
+        Mutex m_dependentsLock;
+        std::vector<Job> m_dependents;
+        std::vector<JobFiber *> m_waitingFibers;
+    };
+
+    /**
+     * @brief Work-stealing job scheduler, one worker per hardware thread.
+     *
+     * The thread calling Init is worker 0 and runs jobs while it waits on a counter; the others are
+     * dedicated threads. Each worker owns a JobQueue, runs its own jobs newest first and steals the
+     * oldest ones from a random victim once it runs out. Threads that aren't workers submit through
+     * a shared locked queue. Idle workers spin a little, then sleep until jobs are submitted.
+     *
+     * Workers run jobs on a pool of fibers: a job waiting on a counter parks its fiber and the worker
+     * moves on to other jobs, the fiber is resumed, on any worker, once the counter is done. The
+     * worker keeps running jobs on the same fiber as long as it finds some, so only waits pay for
+     * a switch. Threads that aren't workers run the jobs they help with on their own stack.
+     */
+    class CORESYSTEM_API JobSystem
+    {
+        UGE_NOCLASSCOPY(JobSystem)
+
+    public:
+        JobSystem();
+        ~JobSystem();
+
+        void Init(UInt32 workerCount = 0, UInt32 fiberCount = c_defaultFiberCount);
+        void Deinit();
+
+        void Run(const JobDecl *jobs, UInt32 count, JobCounter *counter, JobCounter *dependency = nullptr);
+        void WaitForCounter(JobCounter *counter);
+        Bool RunPendingJob();
+
+        UInt32 GetWorkerCount() const;
+        UInt32 GetCurrentWorkerIndex() const;
+        UInt32 GetLocalQueueSize() const;
+
+        static UInt32 GetHardwareThreadCount();
+
+        constexpr static UInt32 c_noWorkerIndex = UINT32_MAX;
+        constexpr static UInt32 c_defaultFiberCount = 128;
+        constexpr static UInt32 c_fiberStackSize = 64 * 1024;
+
+    private:
+        friend class JobWorkerThread;
+
+        constexpr static UInt32 c_maxWorkerCount = 64;
+        constexpr static UInt32 c_idleSpinCount = 64;
+
+        static void FiberMain(void *userData);
+
+        void WorkerLoop(UInt32 workerIndex);
+        Bool RunWork(UInt32 workerIndex);
+        void Schedule(const Job *jobs, UInt32 count);
+        void WakeWorkers(UInt32 count);
+        void ReleaseWakeups(UInt32 count);
+        Bool FindJob(Job &job);
+        void Execute(const Job &job);
+        void CompleteJob(JobCounter *counter);
+
+        void RunFiber(JobFiber *fiber);
+        void SwitchToFiber(UInt32 workerIndex, JobFiber *fiber);
+        void ParkFiber(JobFiber *fiber);
+        void ReadyFibers(JobFiber *const *fibers, UInt32 count);
+        JobFiber *AcquireFiber(UInt32 workerIndex);
+
+        JobQueue *m_queues;
+        JobWorkerThread *m_workers;
+        UInt32 m_workerCount;
+        AtomicInt m_running;
+
+        // Fiber pool, nullptr when Init was given no fibers. Each worker keeps a spare one so looking
+        // for a job doesn't take the lock.
+        JobFiber *m_fibers;
+        UInt32 m_fiberCount;
+        Fiber *m_workerFibers;
+        JobFiber **m_spareFibers;
+        Mutex m_fiberLock;
+        std::vector<JobFiber *> m_freeFibers;
+        std::deque<JobFiber *> m_readyFibers;
+        AtomicInt m_readyCount;
+
+        // Idle workers sleep here, Schedule only pays for the wake up when some do.
+        Semaphore *m_wakeup;
+        AtomicInt m_sleepingCount;
+
+        // Jobs submitted by threads that aren't workers.
+        Mutex m_sharedLock;
+        std::deque<Job> m_sharedJobs;
+        AtomicInt m_sharedCount;
+    };
+
+    CORESYSTEM_API JobSystem &GetJobSystem();
+    CORESYSTEM_API void InitJobSystem(UInt32 workerCount = 0, UInt32 fiberCount = JobSystem::c_defaultFiberCount);
+    CORESYSTEM_API void DeinitJobSystem();
+}
+
+#include "jobSystem.inl"
+
+#endif // __CORESYSTEM_JOBSYSTEM_H__
@@ -0,0 +1,41 @@
+#ifndef __CORESYSTEM_JOBSYSTEM_INL__
+#define __CORESYSTEM_JOBSYSTEM_INL__
+
+namespace uge::jobs
+{
+    UGE_INLINE JobCounter::JobCounter()
+        : m_value(0)
+    {
+    }
+
+    UGE_INLINE JobCounter::~JobCounter()
+    {
+        UGE_ASSERT(IsDone(), "Job counter destroyed while its jobs are pending");
+    }
+
+    /**
+     * @brief true once every job counted on it ran and the jobs depending on it were scheduled.
+     */
+    UGE_FORCE_INLINE Bool JobCounter::IsDone() const
+    {
+        return atomic::Atomic32::Fetch(const_cast<AtomicInt *>(&m_value)) == 0;
+    }
+
+    UGE_INLINE UInt32 JobCounter::GetValue() const
+    {
+        const AtomicInt value = atomic::Atomic32::Fetch(const_cast<AtomicInt *>(&m_value));
+        return value > 0 ? static_cast<UInt32>(value) : 0;
+    }
+
+    UGE_FORCE_INLINE void JobCounter::Add(UInt32 count)
+    {
+        atomic::Atomic32::ExchangeAdd(&m_value, static_cast<AtomicInt>(count));
+    }
+
+    UGE_INLINE UInt32 JobSystem::GetWorkerCount() const
+    {
+        return m_workerCount;
+    }
+}
+
+#endif // __CORESYSTEM_JOBSYSTEM_INL__
@@ -0,0 +1,37 @@
+#include "build.h"
+
+#include "jobWorkerThread.h"
+#include "jobSystem.h"
+
+namespace uge::jobs
+{
+    const char *c_jobWorkerThreadName = "JobWorker";
+    const UInt32 c_jobWorkerThreadStackSize = 512 * 1024;
+
+    JobWorkerThread::JobWorkerThread()
+        : Thread(c_jobWorkerThreadName, c_jobWorkerThreadStackSize), m_jobSystem(nullptr), m_workerIndex(0)
+    {
+    }
+
+    JobWorkerThread::~JobWorkerThread()
+    {
+    }
+
+    void JobWorkerThread::Start(JobSystem *jobSystem, UInt32 workerIndex)
+    {
+        m_jobSystem = jobSystem;
+        m_workerIndex = workerIndex;
+        Thread::Init();
+        Thread::SetPriority(EThreadPriority::Normal);
+    }
+
+    void JobWorkerThread::Stop()
+    {
+        Thread::Join();
+    }
+
+    void JobWorkerThread::ThreadFunc()
+    {
+        m_jobSystem->WorkerLoop(m_workerIndex);
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef __CORESYSTEM_JOBWORKERTHREAD_H__
+#define __CORESYSTEM_JOBWORKERTHREAD_H__
+
+namespace uge::jobs
+{
+    class JobSystem;
+
+    class CORESYSTEM_API JobWorkerThread : public Thread
+    {
+    public:
+        JobWorkerThread();
+        virtual ~JobWorkerThread();
+
+        virtual void Start(JobSystem *jobSystem, UInt32 workerIndex);
+        virtual void Stop();
+
+        virtual void ThreadFunc();
+
+    private:
+        JobSystem *m_jobSystem;
+        UInt32 m_workerIndex;
+    };
+}
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef __CORESYSTEM_PARALLELFOR_H__
+#define __CORESYSTEM_PARALLELFOR_H__
+
+#include "jobSystem.h"
+
+#include <chrono>
+
+namespace uge
+{
+    namespace priv
+    {
+        // Items timed before deciding how to split the loop.
+        constexpr UInt32 c_parallelProbeCount = 16;
+        // Loops with less work left than this run on the caller.
+        constexpr Double c_parallelSerialThresholdNs = 20000.0;
+        // Work done between two looks at the worker's queue.
+        constexpr Double c_parallelChunkNs = 2000.0;
+        // Split ranges a loop may make per worker, each holds its own partial result.
+        constexpr UInt32 c_parallelRangesPerWorker = 8;
+
+        struct ParallelNoValue
+        {
+        };
+
+        /**
+         * @brief One parallel loop split lazily: a range only hands its upper half to the job system
+         * when the worker running it has nothing queued, so a loop makes about as many jobs as there
+         * are idle workers instead of a fixed count. Threads that aren't workers have no queue to
+         * look at, they split once the last range they handed out was picked up.
+         */
+        template <typename TValue, typename TAccumulate>
+        class ParallelLoop
+        {
+        public:
+            ParallelLoop(TAccumulate &accumulate, const TValue &identity, UInt32 grainSize, UInt32 maxRangeCount);
+
+            void RunRange(UInt32 begin, UInt32 end, TValue &accumulator);
+            Bool ShouldSplit(Bool worker);
+            void Wait();
+
+            template <typename TCombine>
+            void Combine(TValue &result, TCombine &combine);
+
+        private:
+            struct Range
+            {
+                ParallelLoop *m_loop;
+                UInt32 m_begin;
+                UInt32 m_end;
+                TValue m_accumulator;
+            };
+
+            static void RangeJob(void *data);
+
+            TAccumulate &m_accumulate;
+            UInt32 m_grainSize;
+            jobs::JobSystem &m_jobSystem;
+            jobs::JobCounter m_counter;
+            std::vector<Range> m_ranges;
+            AtomicInt m_rangeCount;
+
+            // Split ranges not picked up by a worker yet.
+            AtomicInt m_pendingCount;
+        };
+    }
+
+    template <typename TValue, typename TAccumulate, typename TCombine>
+    TValue ParallelReduce(UInt32 begin, UInt32 end, const TValue &identity, TAccumulate &&accumulate, TCombine &&combine);
+
+    template <typename TFunction>
+    void ParallelFor(UInt32 begin, UInt32 end, TFunction &&function);
+
+    template <typename TFunction>
+    void ParallelFor(UInt32 count, TFunction &&function);
+}
+
+#include "parallelFor.inl"
+
+#endif // __CORESYSTEM_PARALLELFOR_H__
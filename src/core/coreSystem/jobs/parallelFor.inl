@@ -0,0 +1,163 @@
+#ifndef __CORESYSTEM_PARALLELFOR_INL__
+#define __CORESYSTEM_PARALLELFOR_INL__
+
+namespace uge
+{
+    namespace priv
+    {
+        template <typename TValue, typename TAccumulate>
+        UGE_INLINE ParallelLoop<TValue, TAccumulate>::ParallelLoop(TAccumulate &accumulate, const TValue &identity, UInt32 grainSize, UInt32 maxRangeCount)
+            : m_accumulate(accumulate),
+              m_grainSize(grainSize),
+              m_jobSystem(jobs::GetJobSystem()),
+              m_ranges(maxRangeCount, Range{this, 0, 0, identity}),
+              m_rangeCount(0),
+              m_pendingCount(0)
+        {
+        }
+
+        /**
+         * @brief Runs [begin, end) a grain at a time, splitting the rest in two whenever the worker's queue is empty.
+         */
+        template <typename TValue, typename TAccumulate>
+        UGE_INLINE void ParallelLoop<TValue, TAccumulate>::RunRange(UInt32 begin, UInt32 end, TValue &accumulator)
+        {
+            const Bool worker = m_jobSystem.GetCurrentWorkerIndex() != jobs::JobSystem::c_noWorkerIndex;
+            while (begin != end)
+            {
+                if (end - begin > m_grainSize && ShouldSplit(worker))
+                {
+                    const AtomicInt rangeIndex = atomic::Atomic32::Increment(&m_rangeCount) - 1;
+                    if (static_cast<UInt32>(rangeIndex) < m_ranges.size())
+                    {
+                        const UInt32 middle = begin + (end - begin) / 2;
+
+                        Range &range = m_ranges[rangeIndex];
+                        range.m_begin = middle;
+                        range.m_end = end;
+                        end = middle;
+
+                        atomic::Atomic32::Increment(&m_pendingCount);
+                        const jobs::JobDecl job = {&ParallelLoop::RangeJob, &range};
+                        m_jobSystem.Run(&job, 1, &m_counter);
+                        continue;
+                    }
+                }
+
+                const UInt32 chunkEnd = end - begin > m_grainSize ? begin + m_grainSize : end;
+                for (; begin != chunkEnd; ++begin)
+                {
+                    m_accumulate(accumulator, begin);
+                }
+            }
+        }
+
+        template <typename TValue, typename TAccumulate>
+        UGE_INLINE Bool ParallelLoop<TValue, TAccumulate>::ShouldSplit(Bool worker)
+        {
+            return worker ? m_jobSystem.GetLocalQueueSize() == 0 : atomic::Atomic32::Fetch(&m_pendingCount) == 0;
+        }
+
+        template <typename TValue, typename TAccumulate>
+        UGE_INLINE void ParallelLoop<TValue, TAccumulate>::Wait()
+        {
+            m_jobSystem.WaitForCounter(&m_counter);
+        }
+
+        template <typename TValue, typename TAccumulate>
+        template <typename TCombine>
+        UGE_INLINE void ParallelLoop<TValue, TAccumulate>::Combine(TValue &result, TCombine &combine)
+        {
+            const UInt32 rangeCount = static_cast<UInt32>(atomic::Atomic32::Fetch(&m_rangeCount));
+            for (UInt32 i = 0; i < rangeCount && i < m_ranges.size(); ++i)
+            {
+                result = combine(result, m_ranges[i].m_accumulator);
+            }
+        }
+
+        template <typename TValue, typename TAccumulate>
+        void ParallelLoop<TValue, TAccumulate>::RangeJob(void *data)
+        {
+            Range *range = static_cast<Range *>(data);
+            atomic::Atomic32::Decrement(&range->m_loop->m_pendingCount);
+            range->m_loop->RunRange(range->m_begin, range->m_end, range->m_accumulator);
+        }
+    }
+
+    /**
+     * @brief Folds [begin, end) on the job system's workers.
+     *
+     * The first items are timed on the caller to size the chunks; loops with little work left, or
+     * without workers to help, finish there. Each split range accumulates into its own copy of
+     * identity, at most c_parallelRangesPerWorker per worker, the copies are combined once the loop
+     * is done, in no particular order.
+     *
+     * @param identity Starting value of every partial result.
+     * @param accumulate Called as accumulate(TValue &partial, UInt32 index) for every index.
+     * @param combine Called as combine(const TValue &a, const TValue &b), must be associative and commutative.
+     * @return The combined partial results.
+     */
+    template <typename TValue, typename TAccumulate, typename TCombine>
+    TValue ParallelReduce(UInt32 begin, UInt32 end, const TValue &identity, TAccumulate &&accumulate, TCombine &&combine)
+    {
+        TValue result = identity;
+        if (begin >= end)
+        {
+            return result;
+        }
+
+        const UInt32 probeEnd = end - begin > priv::c_parallelProbeCount ? begin + priv::c_parallelProbeCount : end;
+        const auto probeStart = std::chrono::high_resolution_clock::now();
+        for (UInt32 i = begin; i != probeEnd; ++i)
+        {
+            accumulate(result, i);
+        }
+        const std::chrono::duration<Double, std::nano> probeTime = std::chrono::high_resolution_clock::now() - probeStart;
+
+        const UInt32 remaining = end - probeEnd;
+        const Double itemNs = probeTime.count() / (probeEnd - begin) + 0.1;
+        if (jobs::GetJobSystem().GetWorkerCount() <= 1 || remaining * itemNs < priv::c_parallelSerialThresholdNs)
+        {
+            for (UInt32 i = probeEnd; i != end; ++i)
+            {
+                accumulate(result, i);
+            }
+            return result;
+        }
+
+        const Double grainSize = priv::c_parallelChunkNs / itemNs;
+        const UInt32 grain = grainSize < 1.0 ? 1 : grainSize > remaining ? remaining : static_cast<UInt32>(grainSize);
+
+        // Split ranges hold at least half a grain, and idle workers rarely need more than a few each.
+        const UInt32 maxRangeCount = std::min(2 * (remaining / grain) + 2, priv::c_parallelRangesPerWorker * jobs::GetJobSystem().GetWorkerCount());
+        priv::ParallelLoop<TValue, std::remove_reference_t<TAccumulate>> loop(accumulate, identity, grain, maxRangeCount);
+        loop.RunRange(probeEnd, end, result);
+        loop.Wait();
+        loop.Combine(result, combine);
+
+        return result;
+    }
+
+    /**
+     * @brief Calls function(UInt32 index) for every index of [begin, end) on the job system's workers,
+     * see ParallelReduce for how the range is split.
+     */
+    template <typename TFunction>
+    void ParallelFor(UInt32 begin, UInt32 end, TFunction &&function)
+    {
+        ParallelReduce(
+            begin, end, priv::ParallelNoValue(),
+            [&function](priv::ParallelNoValue &, UInt32 index)
+            { function(index); },
+            [](const priv::ParallelNoValue &a, const priv::ParallelNoValue &)
+            { return a; });
+    }
+
+    template <typename TFunction>
+    void ParallelFor(UInt32 count, TFunction &&function)
+    {
+        ParallelFor(0u, count, std::forward<TFunction>(function));
+    }
+}
+
+#endif // __CORESYSTEM_PARALLELFOR_INL__
@@ -0,0 +1,133 @@
+#ifndef __CORESYSTEM_TASK_H__
+#define __CORESYSTEM_TASK_H__
+
+#include "taskFrameAllocator.h"
+
+#include <coroutine>
+#include <optional>
+
+namespace uge
+{
+    namespace priv
+    {
+        /**
+         * @brief Tasks awaited together: the last one to finish resumes the continuation.
+         */
+        struct TaskGroup
+        {
+            AtomicInt m_remaining;
+            std::coroutine_handle<> m_continuation;
+        };
+    }
+
+    /**
+     * @brief What every task promise shares: lazy start, continuation, frames from TaskFrameAllocator.
+     */
+    class TaskPromiseBase
+    {
+    public:
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept;
+            template <typename TPromise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) noexcept;
+            void await_resume() noexcept;
+        };
+
+        TaskPromiseBase();
+
+        std::suspend_always initial_suspend() noexcept;
+        FinalAwaiter final_suspend() noexcept;
+        void unhandled_exception() noexcept;
+
+        static void *operator new(size_t size);
+        static void operator delete(void *frame, size_t size);
+
+        void SetContinuation(std::coroutine_handle<> continuation);
+        void SetGroup(priv::TaskGroup *group);
+
+    private:
+        std::coroutine_handle<> OnFinished() noexcept;
+
+        std::coroutine_handle<> m_continuation;
+        priv::TaskGroup *m_group;
+    };
+
+    template <typename T>
+    class Task;
+
+    template <typename T>
+    class TaskPromise : public TaskPromiseBase
+    {
+    public:
+        Task<T> get_return_object() noexcept;
+
+        template <typename TValue>
+        void return_value(TValue &&value);
+
+        T &GetResult();
+
+    private:
+        std::optional<T> m_result;
+    };
+
+    template <>
+    class TaskPromise<void> : public TaskPromiseBase
+    {
+    public:
+        Task<void> get_return_object() noexcept;
+
+        void return_void() noexcept;
+        void GetResult();
+    };
+
+    /**
+     * @brief Coroutine returning a T, started when awaited.
+     *
+     * co_await on a task runs it on the awaiting thread until it suspends itself, the awaiting
+     * coroutine resumes wherever the task finishes. Tasks are moved, not copied, and destroy
+     * their frame with them.
+     */
+    template <typename T = void>
+    class Task
+    {
+    public:
+        typedef TaskPromise<T> promise_type;
+        typedef std::coroutine_handle<promise_type> Handle;
+
+        class Awaiter
+        {
+        public:
+            explicit Awaiter(Handle handle);
+
+            bool await_ready() const noexcept;
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept;
+            decltype(auto) await_resume();
+
+        private:
+            Handle m_handle;
+        };
+
+        Task() noexcept;
+        explicit Task(Handle handle) noexcept;
+        Task(Task &&other) noexcept;
+        Task &operator=(Task &&other) noexcept;
+        ~Task();
+
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+
+        Awaiter operator co_await() const noexcept;
+
+        Bool IsValid() const;
+        Handle GetHandle() const;
+        decltype(auto) GetResult();
+
+    private:
+        Handle m_handle;
+    };
+}
+
+#include "task.inl"
+
+#endif // __CORESYSTEM_TASK_H__
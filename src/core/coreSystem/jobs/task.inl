@@ -0,0 +1,224 @@
+#ifndef __CORESYSTEM_TASK_INL__
+#define __CORESYSTEM_TASK_INL__
+
+namespace uge
+{
+    UGE_FORCE_INLINE bool TaskPromiseBase::FinalAwaiter::await_ready() noexcept
+    {
+        return false;
+    }
+
+    template <typename TPromise>
+    UGE_FORCE_INLINE std::coroutine_handle<> TaskPromiseBase::FinalAwaiter::await_suspend(std::coroutine_handle<TPromise> handle) noexcept
+    {
+        return handle.promise().OnFinished();
+    }
+
+    UGE_FORCE_INLINE void TaskPromiseBase::FinalAwaiter::await_resume() noexcept
+    {
+    }
+
+    UGE_INLINE TaskPromiseBase::TaskPromiseBase()
+        : m_continuation(),
+          m_group(nullptr)
+    {
+    }
+
+    UGE_FORCE_INLINE std::suspend_always TaskPromiseBase::initial_suspend() noexcept
+    {
+        return {};
+    }
+
+    UGE_FORCE_INLINE TaskPromiseBase::FinalAwaiter TaskPromiseBase::final_suspend() noexcept
+    {
+        return {};
+    }
+
+    UGE_INLINE void TaskPromiseBase::unhandled_exception() noexcept
+    {
+        UGE_ASSERT(false, "Unhandled exception in a task");
+        std::terminate();
+    }
+
+    UGE_FORCE_INLINE void *TaskPromiseBase::operator new(size_t size)
+    {
+        return TaskFrameAllocator::Allocate(size);
+    }
+
+    UGE_FORCE_INLINE void TaskPromiseBase::operator delete(void *frame, size_t size)
+    {
+        TaskFrameAllocator::Free(frame, size);
+    }
+
+    UGE_INLINE void TaskPromiseBase::SetContinuation(std::coroutine_handle<> continuation)
+    {
+        m_continuation = continuation;
+    }
+
+    UGE_INLINE void TaskPromiseBase::SetGroup(priv::TaskGroup *group)
+    {
+        m_group = group;
+    }
+
+    /**
+     * @brief Picks the coroutine to transfer to once the task is done: its awaiter, the group's once
+     * the whole group is done, or none.
+     */
+    UGE_FORCE_INLINE std::coroutine_handle<> TaskPromiseBase::OnFinished() noexcept
+    {
+        if (m_continuation)
+        {
+            return m_continuation;
+        }
+
+        if (m_group)
+        {
+            // Whoever waits on the group may destroy this frame as soon as the count hits zero.
+            priv::TaskGroup *group = m_group;
+            const std::coroutine_handle<> continuation = group->m_continuation;
+            if (atomic::Atomic32::Decrement(&group->m_remaining) == 0 && continuation)
+            {
+                return continuation;
+            }
+        }
+
+        return std::noop_coroutine();
+    }
+
+    template <typename T>
+    UGE_INLINE Task<T> TaskPromise<T>::get_return_object() noexcept
+    {
+        return Task<T>(Task<T>::Handle::from_promise(*this));
+    }
+
+    template <typename T>
+    template <typename TValue>
+    UGE_INLINE void TaskPromise<T>::return_value(TValue &&value)
+    {
+        m_result.emplace(std::forward<TValue>(value));
+    }
+
+    template <typename T>
+    UGE_INLINE T &TaskPromise<T>::GetResult()
+    {
+        UGE_ASSERT(m_result.has_value(), "Task has no result");
+        return *m_result;
+    }
+
+    UGE_INLINE Task<void> TaskPromise<void>::get_return_object() noexcept
+    {
+        return Task<void>(Task<void>::Handle::from_promise(*this));
+    }
+
+    UGE_INLINE void TaskPromise<void>::return_void() noexcept
+    {
+    }
+
+    UGE_INLINE void TaskPromise<void>::GetResult()
+    {
+    }
+
+    template <typename T>
+    UGE_INLINE Task<T>::Awaiter::Awaiter(Handle handle)
+        : m_handle(handle)
+    {
+    }
+
+    template <typename T>
+    UGE_FORCE_INLINE bool Task<T>::Awaiter::await_ready() const noexcept
+    {
+        return false;
+    }
+
+    template <typename T>
+    UGE_FORCE_INLINE std::coroutine_handle<> Task<T>::Awaiter::await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        m_handle.promise().SetContinuation(awaiting);
+        return m_handle;
+    }
+
+    template <typename T>
+    UGE_FORCE_INLINE decltype(auto) Task<T>::Awaiter::await_resume()
+    {
+        if constexpr (std::is_void_v<T>)
+        {
+            return;
+        }
+        else
+        {
+            return std::move(m_handle.promise().GetResult());
+        }
+    }
+
+    template <typename T>
+    UGE_INLINE Task<T>::Task() noexcept
+        : m_handle()
+    {
+    }
+
+    template <typename T>
+    UGE_INLINE Task<T>::Task(Handle handle) noexcept
+        : m_handle(handle)
+    {
+    }
+
+    template <typename T>
+    UGE_INLINE Task<T>::Task(Task &&other) noexcept
+        : m_handle(other.m_handle)
+    {
+        other.m_handle = Handle();
+    }
+
+    template <typename T>
+    UGE_INLINE Task<T> &Task<T>::operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_handle)
+            {
+                m_handle.destroy();
+            }
+            m_handle = other.m_handle;
+            other.m_handle = Handle();
+        }
+        return *this;
+    }
+
+    template <typename T>
+    UGE_INLINE Task<T>::~Task()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    template <typename T>
+    UGE_FORCE_INLINE typename Task<T>::Awaiter Task<T>::operator co_await() const noexcept
+    {
+        return Awaiter(m_handle);
+    }
+
+    template <typename T>
+    UGE_INLINE Bool Task<T>::IsValid() const
+    {
+        return static_cast<Bool>(m_handle);
+    }
+
+    template <typename T>
+    UGE_INLINE typename Task<T>::Handle Task<T>::GetHandle() const
+    {
+        return m_handle;
+    }
+
+    /**
+     * @brief The value the finished task returned.
+     */
+    template <typename T>
+    UGE_INLINE decltype(auto) Task<T>::GetResult()
+    {
+        return m_handle.promise().GetResult();
+    }
+}
+
+#endif // __CORESYSTEM_TASK_INL__
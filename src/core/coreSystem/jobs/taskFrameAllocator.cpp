@@ -0,0 +1,101 @@
+#include "build.h"
+
+#include "taskFrameAllocator.h"
+
+namespace uge
+{
+    namespace priv
+    {
+        // 64 bytes to 2 KB.
+        const UInt32 c_minTaskFrameSizeLog2 = 6;
+        const UInt32 c_taskFrameSizeClassCount = 6;
+        const size_t c_maxTaskFrameSize = size_t(1) << (c_minTaskFrameSizeLog2 + c_taskFrameSizeClassCount - 1);
+        const UInt32 c_maxCachedTaskFrames = 1024;
+
+        struct TaskFrameNode
+        {
+            TaskFrameNode *m_next;
+        };
+
+        struct TaskFrameCache
+        {
+            TaskFrameNode *m_heads[c_taskFrameSizeClassCount] = {};
+            UInt32 m_counts[c_taskFrameSizeClassCount] = {};
+
+            ~TaskFrameCache()
+            {
+                for (TaskFrameNode *head : m_heads)
+                {
+                    while (head)
+                    {
+                        TaskFrameNode *next = head->m_next;
+                        std::free(head);
+                        head = next;
+                    }
+                }
+            }
+        };
+
+        thread_local TaskFrameCache t_taskFrameCache;
+
+        UGE_FORCE_INLINE UInt32 GetTaskFrameSizeClass(size_t size)
+        {
+            UInt32 sizeClass = 0;
+            while ((size_t(1) << (c_minTaskFrameSizeLog2 + sizeClass)) < size)
+            {
+                ++sizeClass;
+            }
+            return sizeClass;
+        }
+    }
+
+    /**
+     * @brief Returns a frame of at least size bytes, from the calling thread's cache when it has one.
+     */
+    void *TaskFrameAllocator::Allocate(size_t size)
+    {
+        if (size > priv::c_maxTaskFrameSize)
+        {
+            return std::malloc(size);
+        }
+
+        priv::TaskFrameCache &cache = priv::t_taskFrameCache;
+        const UInt32 sizeClass = priv::GetTaskFrameSizeClass(size);
+
+        priv::TaskFrameNode *frame = cache.m_heads[sizeClass];
+        if (frame)
+        {
+            cache.m_heads[sizeClass] = frame->m_next;
+            --cache.m_counts[sizeClass];
+            return frame;
+        }
+
+        return std::malloc(size_t(1) << (priv::c_minTaskFrameSizeLog2 + sizeClass));
+    }
+
+    /**
+     * @brief Returns a frame to the calling thread's cache, size must be the one it was allocated with.
+     */
+    void TaskFrameAllocator::Free(void *frame, size_t size)
+    {
+        if (size > priv::c_maxTaskFrameSize)
+        {
+            std::free(frame);
+            return;
+        }
+
+        priv::TaskFrameCache &cache = priv::t_taskFrameCache;
+        const UInt32 sizeClass = priv::GetTaskFrameSizeClass(size);
+
+        if (cache.m_counts[sizeClass] == priv::c_maxCachedTaskFrames)
+        {
+            std::free(frame);
+            return;
+        }
+
+        priv::TaskFrameNode *node = static_cast<priv::TaskFrameNode *>(frame);
+        node->m_next = cache.m_heads[sizeClass];
+        cache.m_heads[sizeClass] = node;
+        ++cache.m_counts[sizeClass];
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef __CORESYSTEM_TASKFRAMEALLOCATOR_H__
+#define __CORESYSTEM_TASKFRAMEALLOCATOR_H__
+
+namespace uge
+{
+    /**
+     * @brief Allocates coroutine frames from per thread free lists, one per power of two size class.
+     *
+     * A task's frame is freed back to the list of the thread finishing it, so frames drift towards the
+     * threads running tasks; each list keeps a bounded number of frames. Frames larger than the
+     * largest class go to the heap.
+     */
+    class CORESYSTEM_API TaskFrameAllocator
+    {
+    public:
+        static void *Allocate(size_t size);
+        static void Free(void *frame, size_t size);
+    };
+}
+
+#endif // __CORESYSTEM_TASKFRAMEALLOCATOR_H__
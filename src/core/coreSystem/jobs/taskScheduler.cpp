@@ -0,0 +1,115 @@
+#include "build.h"
+
+#include "taskScheduler.h"
+
+namespace uge
+{
+    namespace priv
+    {
+        void ResumeTaskJob(void *data)
+        {
+            std::coroutine_handle<>::from_address(data).resume();
+        }
+
+        struct MainThreadTasks
+        {
+            Mutex m_lock;
+            std::vector<std::coroutine_handle<>> m_handles;
+            AtomicInt m_count = 0;
+        };
+
+        MainThreadTasks &GetMainThreadTasks()
+        {
+            static MainThreadTasks s_mainThreadTasks;
+            return s_mainThreadTasks;
+        }
+
+        /**
+         * @brief Resumes the coroutine from a job on the workers.
+         */
+        void ResumeOnWorkers(std::coroutine_handle<> handle)
+        {
+            const jobs::JobDecl job = {ResumeTaskJob, handle.address()};
+            jobs::GetJobSystem().Run(&job, 1, nullptr);
+        }
+
+        /**
+         * @brief Helps the workers until every task of the group is done. The main thread also
+         * resumes the coroutines waiting for it meanwhile.
+         */
+        void WaitForTaskGroup(TaskGroup &group)
+        {
+            jobs::JobSystem &jobSystem = jobs::GetJobSystem();
+            const Bool isMainThread = jobSystem.GetCurrentWorkerIndex() == 0;
+
+            while (atomic::Atomic32::Fetch(&group.m_remaining) != 0)
+            {
+                if (isMainThread && RunMainThreadTasks())
+                {
+                    continue;
+                }
+
+                if (!jobSystem.RunPendingJob())
+                {
+                    Thread_Yield();
+                }
+            }
+        }
+    }
+
+    void WorkerPoolAwaiter::await_suspend(std::coroutine_handle<> awaiting) const
+    {
+        priv::ResumeOnWorkers(awaiting);
+    }
+
+    void MainThreadAwaiter::await_suspend(std::coroutine_handle<> awaiting) const
+    {
+        priv::MainThreadTasks &tasks = priv::GetMainThreadTasks();
+
+        ScopedLock<Mutex> lock(tasks.m_lock);
+        tasks.m_handles.push_back(awaiting);
+        atomic::Atomic32::Increment(&tasks.m_count);
+    }
+
+    WorkerPoolAwaiter ResumeOnWorkers()
+    {
+        return WorkerPoolAwaiter();
+    }
+
+    MainThreadAwaiter ResumeOnMainThread()
+    {
+        return MainThreadAwaiter();
+    }
+
+    /**
+     * @brief Resumes the coroutines that awaited ResumeOnMainThread. Call it from the main thread, once per frame:
+     * outside SyncWait nothing else does.
+     *
+     * @return true if any coroutine was resumed.
+     */
+    Bool RunMainThreadTasks()
+    {
+        UGE_ASSERT(jobs::GetJobSystem().GetCurrentWorkerIndex() == 0, "Main thread tasks resumed from another thread");
+
+        priv::MainThreadTasks &tasks = priv::GetMainThreadTasks();
+        if (atomic::Atomic32::Fetch(&tasks.m_count) == 0)
+        {
+            return false;
+        }
+
+        std::vector<std::coroutine_handle<>> handles;
+        {
+            ScopedLock<Mutex> lock(tasks.m_lock);
+            handles.swap(tasks.m_handles);
+            atomic::Atomic32::Store(&tasks.m_count, 0);
+        }
+
+        // Coroutines queueing themselves again wait for the next call.
+        for (std::coroutine_handle<> handle : handles)
+        {
+            handle.resume();
+        }
+
+        return !handles.empty();
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef __CORESYSTEM_TASKSCHEDULER_H__
+#define __CORESYSTEM_TASKSCHEDULER_H__
+
+#include "task.h"
+
+namespace uge
+{
+    /**
+     * @brief co_await ResumeOnWorkers() moves the coroutine to the job system's workers.
+     */
+    class CORESYSTEM_API WorkerPoolAwaiter
+    {
+    public:
+        bool await_ready() const noexcept;
+        void await_suspend(std::coroutine_handle<> awaiting) const;
+        void await_resume() const noexcept;
+    };
+
+    /**
+     * @brief co_await ResumeOnMainThread() moves the coroutine to the main thread, the job system's worker 0,
+     * which resumes it from RunMainThreadTasks. Only SyncWait calls it on its own: a main loop that doesn't wait
+     * on tasks must call RunMainThreadTasks every frame, or the coroutine never resumes.
+     */
+    class CORESYSTEM_API MainThreadAwaiter
+    {
+    public:
+        bool await_ready() const noexcept;
+        void await_suspend(std::coroutine_handle<> awaiting) const;
+        void await_resume() const noexcept;
+    };
+
+    /**
+     * @brief co_await WhenAll(tasks, count) starts the tasks on the workers and resumes once they are all done.
+     */
+    template <typename T>
+    class WhenAllAwaiter
+    {
+    public:
+        WhenAllAwaiter(Task<T> *tasks, UInt32 count);
+
+        bool await_ready() const noexcept;
+        bool await_suspend(std::coroutine_handle<> awaiting);
+        void await_resume() const noexcept;
+
+    private:
+        Task<T> *m_tasks;
+        UInt32 m_count;
+        priv::TaskGroup m_group;
+    };
+
+    CORESYSTEM_API WorkerPoolAwaiter ResumeOnWorkers();
+    CORESYSTEM_API MainThreadAwaiter ResumeOnMainThread();
+    template <typename T>
+    WhenAllAwaiter<T> WhenAll(Task<T> *tasks, UInt32 count);
+
+    template <typename T>
+    decltype(auto) SyncWait(Task<T> &task);
+
+    CORESYSTEM_API Bool RunMainThreadTasks();
+
+    namespace priv
+    {
+        CORESYSTEM_API void ResumeOnWorkers(std::coroutine_handle<> handle);
+        CORESYSTEM_API void WaitForTaskGroup(TaskGroup &group);
+    }
+}
+
+#include "taskScheduler.inl"
+
+#endif // __CORESYSTEM_TASKSCHEDULER_H__
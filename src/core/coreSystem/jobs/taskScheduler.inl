@@ -0,0 +1,83 @@
+#ifndef __CORESYSTEM_TASKSCHEDULER_INL__
+#define __CORESYSTEM_TASKSCHEDULER_INL__
+
+namespace uge
+{
+    UGE_FORCE_INLINE bool WorkerPoolAwaiter::await_ready() const noexcept
+    {
+        return false;
+    }
+
+    UGE_FORCE_INLINE void WorkerPoolAwaiter::await_resume() const noexcept
+    {
+    }
+
+    UGE_FORCE_INLINE bool MainThreadAwaiter::await_ready() const noexcept
+    {
+        return false;
+    }
+
+    UGE_FORCE_INLINE void MainThreadAwaiter::await_resume() const noexcept
+    {
+    }
+
+    template <typename T>
+    UGE_INLINE WhenAllAwaiter<T>::WhenAllAwaiter(Task<T> *tasks, UInt32 count)
+        : m_tasks(tasks),
+          m_count(count),
+          m_group{0, std::coroutine_handle<>()}
+    {
+    }
+
+    template <typename T>
+    UGE_FORCE_INLINE bool WhenAllAwaiter<T>::await_ready() const noexcept
+    {
+        return m_count == 0;
+    }
+
+    template <typename T>
+    UGE_INLINE bool WhenAllAwaiter<T>::await_suspend(std::coroutine_handle<> awaiting)
+    {
+        // One extra count for us, so the tasks can't resume the awaiting coroutine before they're all started.
+        m_group.m_remaining = static_cast<AtomicInt>(m_count + 1);
+        m_group.m_continuation = awaiting;
+
+        for (UInt32 i = 0; i != m_count; ++i)
+        {
+            UGE_ASSERT(m_tasks[i].IsValid(), "WhenAll on an empty task");
+            m_tasks[i].GetHandle().promise().SetGroup(&m_group);
+            priv::ResumeOnWorkers(m_tasks[i].GetHandle());
+        }
+
+        // Done already: carry on without suspending.
+        return atomic::Atomic32::Decrement(&m_group.m_remaining) != 0;
+    }
+
+    template <typename T>
+    UGE_FORCE_INLINE void WhenAllAwaiter<T>::await_resume() const noexcept
+    {
+    }
+
+    template <typename T>
+    UGE_INLINE WhenAllAwaiter<T> WhenAll(Task<T> *tasks, UInt32 count)
+    {
+        return WhenAllAwaiter<T>(tasks, count);
+    }
+
+    /**
+     * @brief Runs the task on the workers and returns its result once done, for code outside coroutines.
+     * Don't call it from a job, it would hold its worker.
+     */
+    template <typename T>
+    UGE_INLINE decltype(auto) SyncWait(Task<T> &task)
+    {
+        priv::TaskGroup group = {1, std::coroutine_handle<>()};
+        task.GetHandle().promise().SetGroup(&group);
+        priv::ResumeOnWorkers(task.GetHandle());
+        priv::WaitForTaskGroup(group);
+
+        return task.GetResult();
+    }
+}
+
+#endif // __CORESYSTEM_TASKSCHEDULER_INL__
@@ -8,7 +8,7 @@ namespace uge::log
     /**
      * @brief Array of strings representing the different logger levels.
      */
-    const char *c_loggerLevelString[] =
+    constexpr const char *c_loggerLevelString[] =
         {
             "[Fatal]",
             "[Error]",
@@ -17,15 +17,164 @@ namespace uge::log
             "[Debug]",
             "[Trace]"};
 
+    /**
+     * @brief Lengths of c_loggerLevelString, so formatting a line doesn't need to measure them.
+     */
+    constexpr UInt32 c_loggerLevelStringLength[] =
+        {
+            static_cast<UInt32>(std::char_traits<char>::length(c_loggerLevelString[LogLevel_Fatal])),
+            static_cast<UInt32>(std::char_traits<char>::length(c_loggerLevelString[LogLevel_Error])),
+            static_cast<UInt32>(std::char_traits<char>::length(c_loggerLevelString[LogLevel_Warning])),
+            static_cast<UInt32>(std::char_traits<char>::length(c_loggerLevelString[LogLevel_Info])),
+            static_cast<UInt32>(std::char_traits<char>::length(c_loggerLevelString[LogLevel_Debug])),
+            static_cast<UInt32>(std::char_traits<char>::length(c_loggerLevelString[LogLevel_Trace]))};
+
+    static_assert(sizeof(c_loggerLevelString) / sizeof(c_loggerLevelString[0]) == sizeof(c_loggerLevelStringLength) / sizeof(c_loggerLevelStringLength[0]), "Missing logger level string length");
+
+    /**
+     * @brief Names of the levels and categories, as used in structured output.
+     */
+    constexpr const char *c_logLevelName[] = {"Fatal", "Error", "Warning", "Info", "Debug", "Trace"};
+    constexpr const char *c_logCategoryName[] = {"Core", "Game"};
+
+    static_assert(sizeof(c_logLevelName) / sizeof(c_logLevelName[0]) == LogLevel_Trace + 1, "Missing log level name");
+    static_assert(sizeof(c_logCategoryName) / sizeof(c_logCategoryName[0]) == LogCategory_MAX, "Missing log category name");
+
+    /**
+     * @brief Upper bound on a blocked producer's wait, wakeups aren't targeted at the ring that got space.
+     */
+    const UInt32 c_logProducerWaitMs = 1;
+
+    /**
+     * @brief How long the log thread keeps polling before parking, so bursts don't pay a wakeup per message.
+     */
+    const UInt32 c_logWaitSpinUs = 50;
+
+    /**
+     * @brief LogWait_Poll backoff: idle time after which the log thread stops spinning, then stops yielding.
+     */
+    const std::chrono::milliseconds c_logPollSpinTime(1);
+    const std::chrono::milliseconds c_logPollYieldTime(10);
+
+    /**
+     * @brief Longest run of repeated messages collapsed into a single "repeated" summary.
+     */
+    const std::chrono::seconds c_logRepeatReportInterval(10);
+
+    /**
+     * @brief Time LogFlushOnCrash may spend draining the rings and flushing the sinks.
+     */
+    const UInt32 c_logCrashFlushBudgetMs = 500;
+
+    namespace
+    {
+        /**
+         * @brief Monotonic milliseconds for the crash budget, read with calls a signal handler may make.
+         */
+        UInt64 GetCrashClockMs()
+        {
+#if defined(UGE_PLATFORM_WINDOWS)
+            return ::GetTickCount64();
+#elif defined(UGE_PLATFORM_LINUX)
+            timespec now;
+            ::clock_gettime(CLOCK_MONOTONIC, &now);
+            return static_cast<UInt64>(now.tv_sec) * 1000ull + static_cast<UInt64>(now.tv_nsec) / 1000000ull;
+#endif
+        }
+    }
+
+    /**
+     * @brief Source of CLog::m_instanceId, so the per-thread ring cache can't be fooled by a new CLog
+     * allocated at the address of a destroyed one.
+     */
+    AtomicInt g_logInstanceCounter = 0;
+
+    namespace
+    {
+        /**
+         * @brief The rings the calling thread registered with each CLog. They're released when the
+         * thread exits, so the log thread can reclaim them once drained.
+         */
+        class ProducerRingList
+        {
+        public:
+            ~ProducerRingList()
+            {
+                for (const Entry &entry : m_entries)
+                {
+                    entry.m_ring->Release(LogRingOwner_Producer);
+                }
+            }
+
+            /**
+             * @brief Returns the ring registered with the CLog instance, dropping the rings of
+             * destroyed instances on the way.
+             */
+            LogRing *Find(UInt32 instanceId)
+            {
+                LogRing *ring = nullptr;
+                for (size_t i = 0; i != m_entries.size();)
+                {
+                    if (m_entries[i].m_ring->IsReleasedBy(LogRingOwner_Log))
+                    {
+                        m_entries[i].m_ring->Release(LogRingOwner_Producer);
+                        m_entries[i] = m_entries.back();
+                        m_entries.pop_back();
+                        continue;
+                    }
+
+                    if (m_entries[i].m_instanceId == instanceId)
+                    {
+                        ring = m_entries[i].m_ring;
+                    }
+                    ++i;
+                }
+
+                return ring;
+            }
+
+            void Add(UInt32 instanceId, LogRing *ring)
+            {
+                m_entries.push_back(Entry{instanceId, ring});
+            }
+
+        private:
+            struct Entry
+            {
+                UInt32 m_instanceId;
+                LogRing *m_ring;
+            };
+
+            std::vector<Entry> m_entries;
+        };
+
+        thread_local ProducerRingList t_producerRings;
+    }
+
     CLog::CLog()
-        : m_enabled(false), m_initialized(false), m_level(LogLevel_Info), m_categoryMask(UINT64_MAX), m_lastFlushTime(std::chrono::system_clock::now()), m_logThreadPtr(nullptr)
+        : m_enabled(false), m_initialized(false), m_level(LogLevel_Info), m_flushMode(LogMode_ASync), m_formatMode(LogFormat_Immediate), m_timestampPrecision(LogTimestamp_Milliseconds), m_overflowPolicy(LogOverflow_Block), m_categoryMask(UINT64_MAX), m_sinkList(nullptr), m_sinkEpoch(0), m_sinkLevel(LogLevel_Trace), m_sinkCategoryMask(UINT64_MAX), m_logThreadPtr(nullptr), m_ringCount(0), m_droppedCount(0), m_reportedDroppedCount(0), m_sharedRing(0), m_logThreadSleeping(0), m_logThreadWakeup(0, 1), m_waitMode(LogWait_Park), m_pollBatchCount(0), m_blockedProducerCount(0), m_producerWakeup(0, c_logRingMax), m_consumerThreadId(0), m_collapseRepeats(false), m_repeatCount(0), m_statsReportInterval(0)
     {
-        Memzero(m_sinks, sizeof(m_sinks));
+        Memzero(&m_stats, sizeof(m_stats));
+        Memzero(m_sinkLists, sizeof(m_sinkLists));
+        Memzero(m_sinkReaders, sizeof(m_sinkReaders));
+        m_sinkList = &m_sinkLists[0];
+        Memzero(m_rings, sizeof(m_rings));
         m_logThreadPtr = &m_logThreadInstance;
+        *reinterpret_cast<LogLine *>(m_lastRecord) = LogLine{0, {}, 0, LogLineType_Flush, LogLevel_Info, LogCategory_Core, nullptr};
+        m_instanceId = atomic::Atomic32::Increment(&g_logInstanceCounter);
     }
 
     CLog::~CLog()
     {
+        // The rings of threads still running are deleted when they exit.
+        for (UInt32 i = 0; i != c_logRingMax; ++i)
+        {
+            LogRing *ring = static_cast<LogRing *>(m_rings[i]);
+            if (ring != nullptr)
+            {
+                ring->Release(LogRingOwner_Log);
+            }
+        }
     }
 
     /**
@@ -76,278 +225,1250 @@ namespace uge::log
     {
         if (m_initialized)
         {
-            m_enabled = true;
+            m_enabled = true;
+        }
+    }
+
+    /**
+     * @brief Disables logging if it has been initialized.
+     */
+    void CLog::Disable()
+    {
+        if (m_initialized)
+        {
+            m_enabled = false;
+        }
+    }
+
+    /**
+     * @brief Returns a boolean value indicating whether logging is enabled or not.
+     *
+     * @return Bool - true if logging is enabled, false otherwise.
+     */
+    Bool CLog::IsEnabled() const
+    {
+        return m_enabled;
+    }
+
+    /**
+     * Logs a message with the specified log level and category.
+     *
+     * @param level The log level of the message.
+     * @param category The log category of the message.
+     * @param format The format string of the message.
+     * @param ... The variable arguments to be formatted according to the format string.
+     */
+    void CLog::PushMessage(LogLevel level, LogCategory category, const char *format, ...)
+    {
+        if (CanLog(level, category))
+        {
+            va_list argList;
+            va_start(argList, format);
+            PushMessage(level, category, format, argList);
+            va_end(argList);
+        }
+    }
+
+    /**
+     * @brief Logs a message with the specified log level, category, format and arguments.
+     *
+     * @param level The log level of the message.
+     * @param category The category of the message.
+     * @param format The format string of the message.
+     * @param args The arguments to be formatted into the message.
+     */
+    void CLog::PushMessage(LogLevel level, LogCategory category, const char *format, va_list args)
+    {
+        if (CanLog(level, category))
+        {
+            LogRing *ring = nullptr;
+            LogLine *logMsg = ReserveLog(c_logLineBufferSize, ring, m_overflowPolicy);
+            if (logMsg == nullptr)
+            {
+                return;
+            }
+
+            *logMsg = LogLine{
+                0,
+                std::chrono::system_clock::now(),
+                uge::ThreadId::GetCurrentThread().Get(),
+                LogLineType_Log,
+                level,
+                category,
+                nullptr};
+
+            if (m_formatMode == LogFormat_Deferred)
+            {
+                va_list argsCopy;
+                va_copy(argsCopy, args);
+                const UInt32 argsSize = EncodeLogArgs(reinterpret_cast<UByte *>(logMsg->GetPayload()), c_logLineBufferSize, format, argsCopy);
+                va_end(argsCopy);
+
+                if (argsSize != c_logArgsInvalid)
+                {
+                    logMsg->m_size = argsSize;
+                    logMsg->m_format = format;
+                    QueueLog(ring, logMsg);
+                    return;
+                }
+            }
+
+            const Int32 length = Vsnprintf(logMsg->GetPayload(), c_logLineBufferSize, format, args);
+            logMsg->m_size = length >= 0 && static_cast<UInt32>(length) < c_logLineBufferSize ? length + 1 : c_logLineBufferSize;
+            QueueLog(ring, logMsg);
+        }
+    }
+
+    /**
+     * @brief Pushes a flush log message to the log queue.
+     *
+     * @param mode The log mode to use.
+     */
+    void CLog::PushFlush(LogFlushMode mode)
+    {
+        UInt64 sequence;
+        QueueFlush(sequence);
+    }
+
+    /**
+     * @brief Queues a flush and waits until the messages the calling thread pushed before it have
+     * been sunk and the sinks flushed. A LogAsyncSink only hands the flush over to its own thread.
+     *
+     * @param timeoutMs The longest time to wait.
+     * @return true if the flush completed, false on timeout or if logging is disabled.
+     */
+    Bool CLog::FlushAndWait(UInt32 timeoutMs)
+    {
+        UInt64 sequence;
+        LogRing *ring = QueueFlush(sequence);
+        if (ring == nullptr)
+        {
+            return false;
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+        ScopedLock<Mutex> lock(m_flushLock);
+        while (ring->GetCompletedFlush() < sequence)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline)
+            {
+                return false;
+            }
+
+            m_flushDone.WaitTimeout(m_flushLock, static_cast<TimeoutMs_t>(std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count()));
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Queues a flush marker carrying the next flush sequence of the ring it's queued to.
+     *
+     * @param sequence Receives the sequence of the marker.
+     * @return The ring the marker was queued to, or nullptr if logging is disabled.
+     */
+    LogRing *CLog::QueueFlush(UInt64 &sequence)
+    {
+        if (!m_enabled)
+        {
+            return nullptr;
+        }
+
+        LogRing *ring = nullptr;
+        LogLine *logMsg = ReserveLog(sizeof(UInt64), ring, LogOverflow_Block);
+        *logMsg = LogLine{
+            sizeof(UInt64),
+            std::chrono::system_clock::now(),
+            uge::ThreadId::GetCurrentThread().Get(),
+            LogLineType_Flush,
+            LogLevel_Info,
+            LogCategory_Core,
+            nullptr};
+
+        // Taken before queueing, the shared ring is unlocked by QueueLog.
+        sequence = ring->NextFlushSequence();
+        Memcpy(logMsg->GetPayload(), &sequence, sizeof(sequence));
+
+        QueueLog(ring, logMsg);
+        return ring;
+    }
+
+    /**
+     * @brief Registers a new log sink to receive log messages.
+     *
+     * @param sink Pointer to the log sink to register.
+     */
+    void CLog::RegisterSink(LogSink *sink)
+    {
+        UGE_ASSERT(sink != nullptr, "Invalid sink pointer");
+
+        ScopedLock<Mutex> lock(m_sinkWriteLock);
+        LogSinkList sinkList = *static_cast<const LogSinkList *>(atomic::AtomicPtr::Fetch(&m_sinkList));
+        if (sinkList.m_count != c_logSinkMax)
+        {
+            sinkList.m_sinks[sinkList.m_count++] = sink;
+            PublishSinkList(sinkList);
+        }
+    }
+
+    /**
+     * @brief Unregisters a log sink from the logger. Once this returns the sink isn't used anymore
+     * and may be destroyed, so it must not be called from a sink.
+     *
+     * @param sink Pointer to the log sink to unregister.
+     */
+    void CLog::UnregisterSink(LogSink *sink)
+    {
+        UGE_ASSERT(sink != nullptr, "Invalid sink pointer");
+
+        ScopedLock<Mutex> lock(m_sinkWriteLock);
+        LogSinkList sinkList = *static_cast<const LogSinkList *>(atomic::AtomicPtr::Fetch(&m_sinkList));
+        LogSink **end = std::remove(sinkList.m_sinks, sinkList.m_sinks + sinkList.m_count, sink);
+        if (end != sinkList.m_sinks + sinkList.m_count)
+        {
+            std::fill(end, sinkList.m_sinks + sinkList.m_count, nullptr);
+            sinkList.m_count = static_cast<UInt32>(end - sinkList.m_sinks);
+            PublishSinkList(sinkList);
+        }
+    }
+
+    /**
+     * @brief Reads the filters of the registered sinks again, after one of them changed.
+     */
+    void CLog::UpdateSinkFilters()
+    {
+        ScopedLock<Mutex> lock(m_sinkWriteLock);
+        PublishSinkList(*static_cast<const LogSinkList *>(atomic::AtomicPtr::Fetch(&m_sinkList)));
+    }
+
+    /**
+     * @brief Publishes a new snapshot of the sinks and waits until no reader can still use the old
+     * one. Called with m_sinkWriteLock held.
+     */
+    void CLog::PublishSinkList(const LogSinkList &sinkList)
+    {
+        const LogSinkList *current = static_cast<const LogSinkList *>(atomic::AtomicPtr::Fetch(&m_sinkList));
+        LogSinkList *next = current == &m_sinkLists[0] ? &m_sinkLists[1] : &m_sinkLists[0];
+        *next = sinkList;
+        atomic::AtomicPtr::Exchange(&m_sinkList, next);
+
+        LogLevel sinkLevel = sinkList.m_count != 0 ? LogLevel_Fatal : LogLevel_Trace;
+        UInt64 sinkCategoryMask = sinkList.m_count != 0 ? 0 : UINT64_MAX;
+        for (UInt32 i = 0; i != sinkList.m_count; ++i)
+        {
+            sinkLevel = std::max(sinkLevel, sinkList.m_sinks[i]->GetLevel());
+            sinkCategoryMask |= sinkList.m_sinks[i]->GetCategoryMask();
+        }
+        atomic::Atomic32::Store(&m_sinkLevel, sinkLevel);
+        atomic::Atomic64::Store(&m_sinkCategoryMask, static_cast<AtomicLong>(sinkCategoryMask));
+
+        // Readers registered under the previous epoch may hold the old snapshot, new ones can only
+        // load the new one.
+        const UInt32 epoch = atomic::Atomic32::Fetch(&m_sinkEpoch);
+        atomic::Atomic32::Exchange(&m_sinkEpoch, epoch + 1);
+        while (atomic::Atomic32::Fetch(&m_sinkReaders[epoch & 1]) != 0)
+        {
+            Thread_Yield();
+        }
+    }
+
+    /**
+     * @brief Registers the caller as a reader of the current epoch and returns the published sinks,
+     * valid until EndSinkRead.
+     *
+     * @param readerSlot Receives the reader counter to pass to EndSinkRead.
+     */
+    UGE_FORCE_INLINE const LogSinkList *CLog::BeginSinkRead(UInt32 &readerSlot)
+    {
+        for (;;)
+        {
+            const UInt32 epoch = atomic::Atomic32::Fetch(&m_sinkEpoch);
+            readerSlot = epoch & 1;
+            atomic::Atomic32::Increment(&m_sinkReaders[readerSlot]);
+
+            // A writer moved to the next epoch in between and may not wait for this slot, retry.
+            if (atomic::Atomic32::Fetch(&m_sinkEpoch) == static_cast<AtomicInt>(epoch))
+            {
+                return static_cast<const LogSinkList *>(atomic::AtomicPtr::Fetch(&m_sinkList));
+            }
+
+            atomic::Atomic32::Decrement(&m_sinkReaders[readerSlot]);
+        }
+    }
+
+    UGE_FORCE_INLINE void CLog::EndSinkRead(UInt32 readerSlot)
+    {
+        atomic::Atomic32::Decrement(&m_sinkReaders[readerSlot]);
+    }
+
+    /**
+     * @brief Consumes the next batch of log messages from the log rings.
+     *
+     * Messages are copied out of the rings and formatted one after the other into the batch buffers,
+     * their ring space is released right away, and the whole batch is then handed to the sinks in
+     * a single call. A flush message ends the batch. Messages identical to the previous one are
+     * only counted, see SetRepeatCollapsing.
+     *
+     * @return true if a log message was consumed, false otherwise.
+     */
+    bool CLog::ConsumeNextLog()
+    {
+        // Only fails while FlushOnCrash owns the rings.
+        const AtomicInt threadId = static_cast<AtomicInt>(ThreadId::GetCurrentThread().Get());
+        if (atomic::Atomic32::CompareExchange(&m_consumerThreadId, threadId, 0) != 0)
+        {
+            return false;
+        }
+
+        const Bool consumed = ConsumeNextBatch();
+        atomic::Atomic32::Exchange(&m_consumerThreadId, 0);
+        return consumed;
+    }
+
+    /**
+     * @brief Body of ConsumeNextLog, called with the rings owned by the calling thread.
+     */
+    Bool CLog::ConsumeNextBatch()
+    {
+        const UInt32 recordMaxSize = (sizeof(LogLine) + c_logLineBufferSize + 7) & ~7u;
+
+        UInt32 entryCount = 0;
+        UInt32 recordsSize = 0;
+        UInt32 textLength = 0;
+        Bool consumed = false;
+        Bool flush = false;
+        LogRing *flushRing = nullptr;
+        UInt64 flushSequence = 0;
+
+        if (m_statsReportInterval.count() != 0)
+        {
+            const auto now = std::chrono::system_clock::now();
+            if (now - m_lastStatsReport >= m_statsReportInterval)
+            {
+                m_lastStatsReport = now;
+                AddStatsReport(entryCount, recordsSize, textLength);
+            }
+        }
+
+        // Keep room for a message and the repeat summary it may end.
+        while (!flush && entryCount + 2 <= c_logBatchMax && recordsSize + 2 * recordMaxSize <= c_logBatchRecordsSize && textLength + 2 * c_logFormattedLineSize <= c_logBatchTextSize)
+        {
+            LogRing *ring = FindOldestLog();
+            if (ring == nullptr)
+            {
+                break;
+            }
+
+            // Pin the record before reading it, the producer may have evicted the peeked one in the meantime.
+            const LogLine *message = static_cast<const LogLine *>(ring->Acquire());
+            if (message == nullptr)
+            {
+                continue;
+            }
+
+            m_stats.m_queueHighWater = std::max(m_stats.m_queueHighWater, ring->GetQueuedSize());
+
+            if (message->m_type == LogLineType_Flush)
+            {
+                flush = true;
+                flushRing = ring;
+                Memcpy(&flushSequence, message->GetPayload(), sizeof(flushSequence));
+            }
+            else if (IsRepeatedLog(*message))
+            {
+                if (m_repeatCount++ == 0)
+                {
+                    m_repeatStart = message->m_time;
+                }
+                m_repeatEnd = message->m_time;
+
+                // Endless repeats are still reported now and then.
+                if (m_repeatEnd - m_repeatStart >= c_logRepeatReportInterval)
+                {
+                    AddRepeatSummary(entryCount, recordsSize, textLength);
+                }
+            }
+            else
+            {
+                if (m_repeatCount != 0)
+                {
+                    AddRepeatSummary(entryCount, recordsSize, textLength);
+                }
+
+                AddBatchEntry(*message, entryCount, recordsSize, textLength);
+                if (m_collapseRepeats)
+                {
+                    Memcpy(m_lastRecord, message, sizeof(LogLine) + message->m_size);
+                }
+            }
+
+            consumed = true;
+            ring->Pop();
+            NotifyBlockedProducers();
+        }
+
+        // Pending repeats are reported by a flush, or once they're old enough when the rings run dry.
+        if (m_repeatCount != 0 && (flush || (!consumed && std::chrono::system_clock::now() - m_repeatStart >= c_logRepeatReportInterval)))
+        {
+            AddRepeatSummary(entryCount, recordsSize, textLength);
+        }
+
+        if (entryCount != 0)
+        {
+            RecordBatchStats(m_batchEntries, entryCount);
+            SinkLogBatch(LogBatch{m_batchEntries, entryCount, m_batchText, textLength});
+        }
+
+        if (flush)
+        {
+            ++m_stats.m_flushCount;
+            ConsumeFlushMessage();
+            flushRing->CompleteFlush(flushSequence);
+
+            ScopedLock<Mutex> lock(m_flushLock);
+            m_flushDone.WakeAll();
+        }
+
+        // Between batches, no record or flush marker of a reclaimed ring is in use anymore.
+        ReclaimRings();
+
+        if (!flush && !consumed)
+        {
+            ReportDroppedLogs();
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Adds a line with the main pipeline counters to the batch, see SetStatsReportInterval.
+     */
+    void CLog::AddStatsReport(UInt32 &entryCount, UInt32 &recordsSize, UInt32 &textLength)
+    {
+        struct
+        {
+            LogLine m_line;
+            char m_payload[256];
+        } report;
+
+        report.m_line = LogLine{
+            0,
+            m_lastStatsReport,
+            uge::ThreadId::GetCurrentThread().Get(),
+            LogLineType_Log,
+            LogLevel_Info,
+            LogCategory_Core,
+            nullptr};
+
+        const LogLatencyHistogram &latency = m_stats.m_latency;
+        Snprintf(report.m_payload, sizeof(report.m_payload), "Log stats: %llu messages, %u dropped, %llu flushes, ring high water %u bytes, latency p50 %lluus p99 %lluus max %lluus",
+                 m_stats.m_messageCount, static_cast<UInt32>(atomic::Atomic32::Fetch(&m_droppedCount)), m_stats.m_flushCount, m_stats.m_queueHighWater,
+                 latency.GetPercentile(50.0), latency.GetPercentile(99.0), latency.m_maxUs);
+        report.m_line.m_size = static_cast<UInt32>(Strlen(report.m_payload) + 1);
+
+        AddBatchEntry(report.m_line, entryCount, recordsSize, textLength);
+    }
+
+    /**
+     * @brief Counts a batch about to be sunk and records how long its messages waited.
+     */
+    void CLog::RecordBatchStats(const LogBatchEntry *entries, UInt32 count)
+    {
+        const auto now = std::chrono::system_clock::now();
+        for (UInt32 i = 0; i != count; ++i)
+        {
+            const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(now - entries[i].m_logLine->m_time).count();
+            m_stats.m_latency.Record(latency > 0 ? static_cast<UInt64>(latency) : 0);
+        }
+
+        m_stats.m_messageCount += count;
+        ++m_stats.m_batchCount;
+    }
+
+    /**
+     * @brief Drains the log rings and flushes the sinks from a crashing thread, see LogFlushOnCrash.
+     *
+     * The rings are taken over from the log thread once it's done with its current batch. Nothing
+     * is allocated and no lock is waited on past the budget: if the log thread doesn't let go of
+     * the rings in time, or if it's the one crashing, the queued messages are given up and the sinks,
+     * which may be halfway through a write, aren't touched. The reason is sunk last, straight from
+     * the calling thread.
+     *
+     * Taking the rings over only uses atomics, a monotonic clock and yields, which are safe from a
+     * signal handler. The drain itself isn't async-signal-safe: it formats with vsnprintf and writes
+     * through the sinks' own file calls. The sinks are only ever used by the rings' owner and were
+     * handed over between two batches, so none of their streams is locked or mid-update, but a
+     * crash inside the C runtime, e.g. in malloc, can still hang the drain past the budget.
+     *
+     * @param reason Line logged at LogLevel_Fatal after the queued messages, or nullptr.
+     * @param budgetMs Time after which the queued messages are given up.
+     */
+    void CLog::FlushOnCrash(const char *reason, UInt32 budgetMs)
+    {
+        if (!m_initialized)
+        {
+            return;
+        }
+
+        const UInt64 deadline = GetCrashClockMs() + budgetMs;
+        const AtomicInt threadId = static_cast<AtomicInt>(ThreadId::GetCurrentThread().Get());
+
+        AtomicInt owner;
+        while ((owner = atomic::Atomic32::CompareExchange(&m_consumerThreadId, threadId, 0)) != 0 && owner != threadId && GetCrashClockMs() < deadline)
+        {
+            Thread_Yield();
+        }
+
+        // Re-entered from a crash in the consumer itself, or the log thread kept the rings.
+        if (owner != 0)
+        {
+            return;
+        }
+
+        while (GetCrashClockMs() < deadline && ConsumeNextBatch())
+        {
+            continue;
+        }
+
+        if (reason != nullptr)
+        {
+            struct
+            {
+                LogLine m_line;
+                char m_payload[c_logLineBufferSize];
+            } crashLine;
+
+            Strcpy(crashLine.m_payload, reason, sizeof(crashLine.m_payload));
+            crashLine.m_line = LogLine{
+                static_cast<UInt32>(Strlen(crashLine.m_payload) + 1),
+                std::chrono::system_clock::now(),
+                static_cast<UInt32>(threadId),
+                LogLineType_Log,
+                LogLevel_Fatal,
+                LogCategory_Core,
+                nullptr};
+
+            ConsumeLogMessage(crashLine.m_line);
+        }
+
+        ConsumeFlushMessage();
+
+        // An assert may be continued from the debugger, give the rings back to the log thread.
+        atomic::Atomic32::Exchange(&m_consumerThreadId, 0);
+    }
+
+    /**
+     * @brief Copies a log line into the batch and formats it.
+     */
+    void CLog::AddBatchEntry(const LogLine &logLine, UInt32 &entryCount, UInt32 &recordsSize, UInt32 &textLength)
+    {
+        const UInt32 recordSize = sizeof(LogLine) + logLine.m_size;
+        LogLine *record = reinterpret_cast<LogLine *>(m_batchRecords + recordsSize);
+        Memcpy(record, &logLine, recordSize);
+        recordsSize += (recordSize + 7) & ~7u;
+
+        char *text = m_batchText + textLength;
+        const UInt32 length = FormatLogMessage(text, c_logFormattedLineSize, *record, m_timestampPrecision);
+
+        m_batchEntries[entryCount++] = LogBatchEntry{record, text, length};
+        textLength += length;
+    }
+
+    /**
+     * @brief Returns whether a log line is identical to the last one sunk, its time and thread aside.
+     */
+    Bool CLog::IsRepeatedLog(const LogLine &logLine) const
+    {
+        const LogLine &lastLine = *reinterpret_cast<const LogLine *>(m_lastRecord);
+        return m_collapseRepeats && logLine.m_type == lastLine.m_type && logLine.m_level == lastLine.m_level && logLine.m_category == lastLine.m_category && logLine.m_format == lastLine.m_format &&
+               logLine.m_size == lastLine.m_size && Memcmp(logLine.GetPayload(), lastLine.GetPayload(), logLine.m_size) == 0;
+    }
+
+    /**
+     * @brief Adds a "repeated N times" line for the repeats counted since the last message sunk.
+     */
+    void CLog::AddRepeatSummary(UInt32 &entryCount, UInt32 &recordsSize, UInt32 &textLength)
+    {
+        const LogLine &lastLine = *reinterpret_cast<const LogLine *>(m_lastRecord);
+
+        struct
+        {
+            LogLine m_line;
+            char m_payload[64];
+        } summary;
+
+        summary.m_line = LogLine{
+            0,
+            m_repeatEnd,
+            lastLine.m_threadId,
+            LogLineType_Log,
+            lastLine.m_level,
+            lastLine.m_category,
+            nullptr};
+
+        const Int32 length = Snprintf(summary.m_payload, sizeof(summary.m_payload), m_repeatCount == 1 ? "Last message repeated once" : "Last message repeated %u times", m_repeatCount);
+        summary.m_line.m_size = length + 1;
+        m_repeatCount = 0;
+
+        AddBatchEntry(summary.m_line, entryCount, recordsSize, textLength);
+    }
+
+    /**
+     * @brief Parks the log thread until a producer queues a message or WakeLogThread is called.
+     * Returns right away if messages were queued since the last ConsumeNextLog. Under LogWait_Poll,
+     * only takes one step of the backoff instead.
+     */
+    void CLog::WaitForLogs()
+    {
+        if (m_waitMode == LogWait_Poll)
+        {
+            PollForLogs();
+            return;
+        }
+
+        const auto spinEnd = std::chrono::steady_clock::now() + std::chrono::microseconds(c_logWaitSpinUs);
+        do
+        {
+            if (HasPendingLogs())
+            {
+                return;
+            }
+
+            Thread_Yield();
+        } while (std::chrono::steady_clock::now() < spinEnd);
+
+        // The exchange is a full barrier: either the producer sees the flag and releases the semaphore,
+        // or the ring re-check below sees the producer's message.
+        atomic::Atomic32::Exchange(&m_logThreadSleeping, 1);
+        if (HasPendingLogs())
+        {
+            atomic::Atomic32::Store(&m_logThreadSleeping, 0);
+            return;
+        }
+
+        m_logThreadWakeup.Acquire();
+    }
+
+    /**
+     * @brief One step of the LogWait_Poll backoff: returns right away for the first millisecond the
+     * rings are empty, yields until the tenth, then sleeps a millisecond.
+     */
+    void CLog::PollForLogs()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (m_stats.m_batchCount != m_pollBatchCount)
+        {
+            m_pollBatchCount = m_stats.m_batchCount;
+            m_pollIdleStart = now;
+        }
+
+        if (HasPendingLogs())
+        {
+            return;
+        }
+
+        const auto idleTime = now - m_pollIdleStart;
+        if (idleTime < c_logPollSpinTime)
+        {
+            return;
+        }
+
+        if (idleTime < c_logPollYieldTime)
+        {
+            Thread_Yield();
+        }
+        else
+        {
+            Thread_Sleep(1);
+        }
+    }
+
+    /**
+     * @brief Unconditionally wakes the log thread, e.g. to let it notice it's being stopped.
+     * The wakeup isn't lost if the log thread isn't parked yet.
+     */
+    void CLog::WakeLogThread()
+    {
+        atomic::Atomic32::Store(&m_logThreadSleeping, 0);
+        m_logThreadWakeup.Release(1);
+    }
+
+    /** @brief Sets the logging level for the Log object.
+     * The logging level determines which log messages will be printed.
+     * Messages with a level lower than the set level will be ignored.
+     *
+     * @param level The logging level to set.
+     */
+    void CLog::SetLevel(LogLevel level)
+    {
+        m_level = level;
+    }
+
+    /**
+     * @brief Restores the log level to the default value of LogLevel_Info.
+     */
+    void CLog::RestoreLevel()
+    {
+        m_level = LogLevel_Info;
+    }
+
+    /**
+     * @brief Sets whether messages are formatted on the calling thread or deferred to the log thread.
+     *
+     * @param mode The format mode to use for subsequently pushed messages.
+     */
+    void CLog::SetFormatMode(LogFormatMode mode)
+    {
+        m_formatMode = mode;
+    }
+
+    /**
+     * @brief Sets the sub-second precision of the timestamps of formatted lines.
+     *
+     * @param precision The precision to use for subsequently formatted lines.
+     */
+    void CLog::SetTimestampPrecision(LogTimestampPrecision precision)
+    {
+        m_timestampPrecision = precision;
+    }
+
+    /**
+     * @brief Sets what producers do when their log ring is full.
+     *
+     * @param policy The overflow policy to use for subsequently pushed messages.
+     */
+    void CLog::SetOverflowPolicy(LogOverflowPolicy policy)
+    {
+        m_overflowPolicy = policy;
+    }
+
+    /**
+     * @brief Sets how the log thread waits for messages, LogWait_Park by default. LogWait_Poll is the
+     * old backoff loop, kept to compare against. See LogWaitMode for the latency parking costs.
+     *
+     * @param mode The wait mode to use from the log thread's next wait.
+     */
+    void CLog::SetWaitMode(LogWaitMode mode)
+    {
+        m_waitMode = mode;
+    }
+
+    /**
+     * @brief Sets whether runs of identical messages are collapsed: the first one is sunk, the
+     * following ones are counted and reported as a single "Last message repeated N times" line
+     * when another message comes, on flush, or every c_logRepeatReportInterval. Off by default, a
+     * message logged on purpose once per frame or per item would otherwise only show up once.
+     *
+     * @param enable true to collapse repeated messages.
+     */
+    void CLog::SetRepeatCollapsing(Bool enable)
+    {
+        m_collapseRepeats = enable;
+    }
+
+    /**
+     * @brief Sets how often the log thread logs a line with the pipeline counters, see GetStats. The
+     * line is added to the next batch once the interval has elapsed, so an idle log reports nothing.
+     *
+     * @param seconds Interval between two reports, 0 to disable them, the default.
+     */
+    void CLog::SetStatsReportInterval(UInt32 seconds)
+    {
+        m_lastStatsReport = std::chrono::system_clock::now();
+        m_statsReportInterval = std::chrono::seconds(seconds);
+    }
+
+    /**
+     * @brief Returns a snapshot of the pipeline counters: messages and batches sunk, drops, the ring
+     * high water mark, the push to sink latency histogram, and the bytes and time of every
+     * registered sink. Lock-free, may be called from any thread.
+     */
+    LogStats CLog::GetStats()
+    {
+        LogStats stats = m_stats;
+        stats.m_droppedCount = static_cast<UInt32>(atomic::Atomic32::Fetch(&m_droppedCount));
+
+        UInt32 readerSlot;
+        const LogSinkList *sinkList = BeginSinkRead(readerSlot);
+        stats.m_sinkCount = sinkList->m_count;
+        for (UInt32 i = 0; i != sinkList->m_count; ++i)
+        {
+            const LogSink *sink = sinkList->m_sinks[i];
+            stats.m_sinks[i] = LogSinkStats{sink, sink->m_bytesWritten, sink->m_sinkTimeUs};
+        }
+        EndSinkRead(readerSlot);
+
+        return stats;
+    }
+
+    /**
+     * @brief Returns the number of messages dropped by the overflow policy since the log was created.
+     */
+    UInt32 CLog::GetDroppedCount() const
+    {
+        return static_cast<UInt32>(m_droppedCount);
+    }
+
+    /**
+     * @brief Toggles the logging of a specific category.
+     *
+     * @param category The category to toggle.
+     * @param enable Whether to enable or disable the logging of the category.
+     */
+    void CLog::ToggleLogCategory(LogCategory category, Bool enable)
+    {
+        if (enable)
+        {
+            m_categoryMask |= (1ull << category);
+        }
+        else
+        {
+            m_categoryMask &= ~(1ull << category);
         }
     }
 
     /**
-     * @brief Disables logging if it has been initialized.
+     * @brief Consumes a log line by formatting it and sinking it to the appropriate log sink.
+     *
+     * @param logLine The log line to consume.
      */
-    void CLog::Disable()
+    void CLog::ConsumeLogMessage(const LogLine &logLine)
     {
-        if (m_initialized)
-        {
-            m_enabled = false;
-        }
+        char formattedMsg[c_logFormattedLineSize];
+
+        FormatLogMessage(formattedMsg, sizeof(formattedMsg), logLine, m_timestampPrecision);
+        SinkLog(formattedMsg, logLine);
     }
 
     /**
-     * @brief Returns a boolean value indicating whether logging is enabled or not.
+     * @brief Flushes all the log sinks.
      *
-     * @return Bool - true if logging is enabled, false otherwise.
+     * This function reads the published sink list and calls the Flush() function of every sink.
+     *
+     * @return void
      */
-    Bool CLog::IsEnabled() const
+    void CLog::ConsumeFlushMessage()
     {
-        return m_enabled;
+        UInt32 readerSlot;
+        const LogSinkList *sinkList = BeginSinkRead(readerSlot);
+        for (UInt32 i = 0; i != sinkList->m_count; ++i)
+        {
+            sinkList->m_sinks[i]->Flush();
+        }
+        EndSinkRead(readerSlot);
     }
 
     /**
-     * Logs a message with the specified log level and category.
+     * @brief Reserves room for a log line in the calling thread's ring, applying the overflow policy
+     * if the ring is full.
      *
-     * @param level The log level of the message.
-     * @param category The log category of the message.
-     * @param format The format string of the message.
-     * @param ... The variable arguments to be formatted according to the format string.
+     * @param payloadSize The maximum payload size the log line may use.
+     * @param ring Receives the ring the log line must be queued to.
+     * @param policy What to do if the ring is full.
+     * @return The log line to fill in and pass to QueueLog, or nullptr if the message was dropped.
      */
-    void CLog::PushMessage(LogLevel level, LogCategory category, const char *format, ...)
+    LogLine *CLog::ReserveLog(UInt32 payloadSize, LogRing *&ring, LogOverflowPolicy policy)
     {
-        if (CanLog(level, category))
+        ring = GetProducerRing();
+        if (ring == nullptr)
         {
-            va_list argList;
-            va_start(argList, format);
-            PushMessage(level, category, format, argList);
-            va_end(argList);
+            ring = &m_sharedRing;
+            m_sharedRingLock.Lock();
+        }
+
+        const UInt32 recordSize = sizeof(LogLine) + payloadSize;
+        void *record = ring->Reserve(recordSize);
+        if (record != nullptr)
+        {
+            return static_cast<LogLine *>(record);
+        }
+
+        switch (policy)
+        {
+        case LogOverflow_Block:
+            // The increment orders the registration before the retries, see NotifyBlockedProducers.
+            atomic::Atomic32::Increment(&m_blockedProducerCount);
+            while ((record = ring->Reserve(recordSize)) == nullptr)
+            {
+                m_producerWakeup.TryAcquire(c_logProducerWaitMs);
+            }
+            atomic::Atomic32::Decrement(&m_blockedProducerCount);
+            break;
+        case LogOverflow_DropOldest:
+            while (record == nullptr && ring->DropOldest())
+            {
+                atomic::Atomic32::Increment(&m_droppedCount);
+                record = ring->Reserve(recordSize);
+            }
+            break;
+        case LogOverflow_Spill:
+            if (ring != &m_sharedRing)
+            {
+                ring = &m_sharedRing;
+                m_sharedRingLock.Lock();
+                record = ring->Reserve(recordSize);
+            }
+            break;
+        default:
+            break;
+        }
+
+        if (record == nullptr)
+        {
+            atomic::Atomic32::Increment(&m_droppedCount);
+            if (ring == &m_sharedRing)
+            {
+                m_sharedRingLock.Unlock();
+            }
+            ring = nullptr;
         }
+
+        return static_cast<LogLine *>(record);
     }
 
     /**
-     * @brief Logs a message with the specified log level, category, format and arguments.
+     * @brief Reserves a deferred log line for PushPackedArgs and fills in its header.
      *
+     * @param type LogLineType_Log for a formatted message, LogLineType_Fields for a structured one.
      * @param level The log level of the message.
      * @param category The category of the message.
-     * @param format The format string of the message.
-     * @param args The arguments to be formatted into the message.
+     * @param format The format string the arguments are encoded for, or the structured message.
+     * @param argsSize The exact size of the encoded arguments.
+     * @param ring Receives the ring the log line must be queued to.
+     * @return The log line to write the arguments to and pass to QueueLog, or nullptr if the message was dropped.
      */
-    void CLog::PushMessage(LogLevel level, LogCategory category, const char *format, va_list args)
+    LogLine *CLog::BeginMessage(LogLineType type, LogLevel level, LogCategory category, const char *format, UInt32 argsSize, LogRing *&ring)
     {
-        if (CanLog(level, category))
+        LogLine *logMsg = ReserveLog(argsSize, ring, m_overflowPolicy);
+        if (logMsg != nullptr)
         {
-            LogLine logMsg{
-                0,
+            *logMsg = LogLine{
+                argsSize,
                 std::chrono::system_clock::now(),
                 uge::ThreadId::GetCurrentThread().Get(),
-                LogLineType_Log,
+                type,
                 level,
-                category};
-
-            Vsnprintf(logMsg.m_buffer, sizeof(logMsg.m_buffer), format, args);
-            QueueLog(std::move(logMsg));
+                category,
+                format};
         }
+
+        return logMsg;
     }
 
     /**
-     * @brief Pushes a flush log message to the log queue.
+     * @brief Queues a log line previously returned by ReserveLog to be written to the log.
      *
-     * @param mode The log mode to use.
+     * @param ring The ring the log line was reserved from.
+     * @param logLine The log line to queue, its m_size must hold the payload size actually used.
      */
-    void CLog::PushFlush(LogFlushMode mode)
+    void CLog::QueueLog(LogRing *ring, LogLine *logLine)
     {
-        if (m_enabled)
+        ring->Commit(sizeof(LogLine) + logLine->m_size);
+
+        if (ring == &m_sharedRing)
         {
-            LogLine logMsg{
-                0,
-                std::chrono::system_clock::now(),
-                uge::ThreadId::GetCurrentThread().Get(),
-                LogLineType_Flush,
-                LogLevel_Info,
-                LogCategory_Core};
+            m_sharedRingLock.Unlock();
+        }
 
-            QueueLog(std::move(logMsg));
+        if (m_flushMode == LogMode_Sync)
+        {
+            ConsumeSynchronously();
+        }
+        else
+        {
+            NotifyLogThread();
         }
     }
 
     /**
-     * @brief Registers a new log sink to receive log messages.
-     *
-     * @param sink Pointer to the log sink to register.
+     * @brief Formats and sinks everything queued on the calling thread, see LogMode_Sync. Producers
+     * serialize here, so a message has reached the sinks when its push returns. A sink logging from
+     * its SinkLog only queues the message, it's sunk by the next push.
      */
-    void CLog::RegisterSink(LogSink *sink)
+    void CLog::ConsumeSynchronously()
     {
-        UGE_ASSERT(sink != nullptr, "Invalid sink pointer");
-
-        ScopedLock<RWSpinLock> lock(m_sinkLock);
-        for (UInt32 i = 0; i != c_logSinkMax; ++i)
+        ScopedLock<Mutex> lock(m_syncConsumerLock);
+        while (ConsumeNextLog())
         {
-            if (m_sinks[i] == nullptr)
-            {
-                m_sinks[i] = sink;
-                return;
-            }
+            continue;
         }
     }
 
     /**
-     * @brief Unregisters a log sink from the logger.
+     * @brief Returns the ring owned by the calling thread, registering one on the thread's first log.
      *
-     * @param sink Pointer to the log sink to unregister.
+     * @return The calling thread's ring, or nullptr if every ring is taken and the shared queue must be used.
      */
-    void CLog::UnregisterSink(LogSink *sink)
+    LogRing *CLog::GetProducerRing()
     {
-        UGE_ASSERT(sink != nullptr, "Invalid sink pointer");
+        struct ProducerRingCache
+        {
+            UInt32 m_instanceId;
+            LogRing *m_ring;
+        };
+        thread_local ProducerRingCache s_cache = {0, nullptr};
+
+        if (s_cache.m_instanceId == m_instanceId)
+        {
+            return s_cache.m_ring;
+        }
 
-        ScopedLock<RWSpinLock> lock(m_sinkLock);
-        auto iter = std::remove(std::begin(m_sinks), std::end(m_sinks), sink);
-        if (iter != std::end(m_sinks))
+        // A thread may log through several CLog instances, so look for a ring registered by an earlier visit.
+        LogRing *ring = t_producerRings.Find(m_instanceId);
+        if (ring == nullptr)
         {
-            *iter = nullptr;
+            ring = new LogRing(uge::ThreadId::GetCurrentThread().Get());
+
+            UInt32 slot = 0;
+            while (slot != c_logRingMax && atomic::AtomicPtr::CompareExchange(&m_rings[slot], ring, nullptr) != nullptr)
+            {
+                ++slot;
+            }
+
+            if (slot != c_logRingMax)
+            {
+                AtomicInt ringCount = atomic::Atomic32::Fetch(&m_ringCount);
+                while (ringCount <= static_cast<AtomicInt>(slot) && atomic::Atomic32::CompareExchange(&m_ringCount, slot + 1, ringCount) != ringCount)
+                {
+                    ringCount = atomic::Atomic32::Fetch(&m_ringCount);
+                }
+
+                t_producerRings.Add(m_instanceId, ring);
+            }
+            else
+            {
+                delete ring;
+                ring = nullptr;
+            }
         }
+
+        s_cache.m_instanceId = m_instanceId;
+        s_cache.m_ring = ring;
+        return ring;
     }
 
     /**
-     * @brief Consumes the next log message from the log queue.
+     * @brief Merges the producer rings by finding the one whose head message is the oldest.
+     * Only meant to be called by the log thread.
      *
-     * @return true if a log message was consumed, false otherwise.
+     * @return The ring holding the oldest message, or nullptr if every ring is empty.
      */
-    bool CLog::ConsumeNextLog()
+    LogRing *CLog::FindOldestLog()
     {
-        bool result = false;
-
-        LogLine message;
-        if (m_logQueue.DequeueMessage(message))
+        LogRing *oldestRing = &m_sharedRing;
+        const LogLine *oldest = static_cast<const LogLine *>(m_sharedRing.Peek());
+        if (oldest == nullptr)
         {
-            m_lastFlushTime = std::chrono::system_clock::now();
-            message.m_type == LogLineType_Log ? ConsumeLogMessage(message) : ConsumeFlushMessage();
-            result = true;
+            oldestRing = nullptr;
         }
 
-        if (!result)
+        const UInt32 ringCount = std::min<UInt32>(atomic::Atomic32::Fetch(&m_ringCount), c_logRingMax);
+        for (UInt32 i = 0; i != ringCount; ++i)
         {
-            m_logQueue.Wait(m_lastFlushTime);
+            LogRing *ring = static_cast<LogRing *>(atomic::AtomicPtr::Fetch(&m_rings[i]));
+            if (ring == nullptr)
+            {
+                continue;
+            }
+
+            const LogLine *head = static_cast<const LogLine *>(ring->Peek());
+            if (head != nullptr && (oldest == nullptr || head->m_time < oldest->m_time))
+            {
+                oldest = head;
+                oldestRing = ring;
+            }
         }
 
-        return result;
+        return oldestRing;
     }
 
-    /** @brief Sets the logging level for the Log object.
-     * The logging level determines which log messages will be printed.
-     * Messages with a level lower than the set level will be ignored.
-     *
-     * @param level The logging level to set.
+    /**
+     * @brief Frees the slots of the rings whose thread exited once they're drained, and deletes the
+     * rings. Only meant to be called by the log thread, between batches.
      */
-    void CLog::SetLevel(LogLevel level)
+    void CLog::ReclaimRings()
     {
-        m_level = level;
+        UInt32 usedCount = 0;
+        const UInt32 ringCount = std::min<UInt32>(atomic::Atomic32::Fetch(&m_ringCount), c_logRingMax);
+        for (UInt32 i = 0; i != ringCount; ++i)
+        {
+            LogRing *ring = static_cast<LogRing *>(atomic::AtomicPtr::Fetch(&m_rings[i]));
+            if (ring == nullptr)
+            {
+                continue;
+            }
+
+            // Released before peeking, so a message committed before the thread exited is seen.
+            if (ring->IsReleasedBy(LogRingOwner_Producer) && ring->Peek() == nullptr)
+            {
+                atomic::AtomicPtr::Store(&m_rings[i], nullptr);
+                ring->Release(LogRingOwner_Log);
+                continue;
+            }
+
+            ++usedCount;
+        }
+
+        m_stats.m_ringCount = usedCount;
     }
 
     /**
-     * @brief Restores the log level to the default value of LogLevel_Info.
+     * @brief Returns whether any ring holds a message, only meant to be called by the log thread.
      */
-    void CLog::RestoreLevel()
+    Bool CLog::HasPendingLogs()
     {
-        m_level = LogLevel_Info;
+        if (m_sharedRing.Peek() != nullptr)
+        {
+            return true;
+        }
+
+        const UInt32 ringCount = std::min<UInt32>(atomic::Atomic32::Fetch(&m_ringCount), c_logRingMax);
+        for (UInt32 i = 0; i != ringCount; ++i)
+        {
+            LogRing *ring = static_cast<LogRing *>(atomic::AtomicPtr::Fetch(&m_rings[i]));
+            if (ring != nullptr && ring->Peek() != nullptr)
+            {
+                return true;
+            }
+        }
+
+        return false;
     }
 
     /**
-     * @brief Toggles the logging of a specific category.
-     *
-     * @param category The category to toggle.
-     * @param enable Whether to enable or disable the logging of the category.
+     * @brief Wakes the log thread if it's parked in WaitForLogs, called after every commit.
+     * In the common case the log thread is busy and this costs a fence and a read of an unchanged flag.
      */
-    void CLog::ToggleLogCategory(LogCategory category, Bool enable)
+    void CLog::NotifyLogThread()
     {
-        if (enable)
-        {
-            m_categoryMask |= (1ull << category);
-        }
-        else
+        atomic::MemoryFence();
+        if (atomic::Atomic32::Fetch(&m_logThreadSleeping) != 0 && atomic::Atomic32::Exchange(&m_logThreadSleeping, 0) != 0)
         {
-            m_categoryMask &= ~(1ull << category);
+            m_logThreadWakeup.Release(1);
         }
     }
 
     /**
-     * @brief Consumes a log line by formatting it and sinking it to the appropriate log sink.
-     *
-     * @param logLine The log line to consume.
+     * @brief Wakes a producer waiting for ring space, called by the log thread after every pop.
      */
-    void CLog::ConsumeLogMessage(const LogLine &logLine)
+    void CLog::NotifyBlockedProducers()
     {
-        char formattedMsg[4096];
-
-        FormatLogMessage(formattedMsg, sizeof(formattedMsg), logLine);
-        SinkLog(formattedMsg, logLine);
+        atomic::MemoryFence();
+        if (atomic::Atomic32::Fetch(&m_blockedProducerCount) != 0)
+        {
+            m_producerWakeup.Release(1);
+        }
     }
 
     /**
-     * @brief Flushes all the log sinks.
+     * @brief Sends the formatted message and log line to the registered sinks accepting it.
      *
-     * This function acquires a shared lock on the sink lock and then iterates over all the log sinks
-     * and calls their Flush() function.
-     *
-     * @return void
+     * @param formattedMsg The formatted message to be sent to the sinks.
+     * @param logLine The log line containing metadata about the log message.
      */
-    void CLog::ConsumeFlushMessage()
+    void CLog::SinkLog(const char *formattedMsg, const LogLine &logLine)
     {
-        ScopedSharedLock<RWSpinLock> lock(m_sinkLock);
-
-        for (UInt32 i = 0; i != c_logSinkMax; ++i)
+        UInt32 readerSlot;
+        const LogSinkList *sinkList = BeginSinkRead(readerSlot);
+        for (UInt32 i = 0; i != sinkList->m_count; ++i)
         {
-            if (!m_sinks[i])
+            if (sinkList->m_sinks[i]->Accepts(logLine.m_level, logLine.m_category))
             {
-                break;
+                sinkList->m_sinks[i]->SinkLog(formattedMsg, logLine);
             }
-
-            m_sinks[i]->Flush();
         }
+        EndSinkRead(readerSlot);
     }
 
     /**
-     * @brief Queues a log message to be written to the log.
+     * @brief Sends a batch of formatted messages to the registered sinks, each sink only getting the
+     * messages its filter accepts.
      *
-     * @param logLine The log message to be queued.
+     * @param batch The messages to be sent to the sinks.
      */
-    void CLog::QueueLog(LogLine &&logLine)
+    void CLog::SinkLogBatch(const LogBatch &batch)
     {
-        if (!m_logQueue.QueueMessage(std::move(logLine)))
+        LogLevel batchLevel = LogLevel_Fatal;
+        UInt64 batchCategoryMask = 0;
+        for (UInt32 i = 0; i != batch.m_count; ++i)
+        {
+            batchLevel = std::max(batchLevel, batch.m_entries[i].m_logLine->m_level);
+            batchCategoryMask |= 1ull << batch.m_entries[i].m_logLine->m_category;
+        }
+
+        UInt32 readerSlot;
+        const LogSinkList *sinkList = BeginSinkRead(readerSlot);
+        for (UInt32 i = 0; i != sinkList->m_count; ++i)
         {
-            std::chrono::system_clock::time_point lastOperation = std::chrono::system_clock::now();
+            LogSink *sink = sinkList->m_sinks[i];
+            const auto sinkStart = std::chrono::steady_clock::now();
+            if (batchLevel <= sink->GetLevel() && (batchCategoryMask & ~sink->GetCategoryMask()) == 0)
+            {
+                sink->SinkLogBatch(batch);
+                sink->m_bytesWritten += batch.m_textLength;
+                sink->m_sinkTimeUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sinkStart).count();
+                continue;
+            }
+
+            // Copy the accepted lines, the text of a batch must be contiguous.
+            UInt32 count = 0;
+            UInt32 textLength = 0;
+            for (UInt32 j = 0; j != batch.m_count; ++j)
+            {
+                const LogBatchEntry &entry = batch.m_entries[j];
+                if (sink->Accepts(entry.m_logLine->m_level, entry.m_logLine->m_category))
+                {
+                    Memcpy(m_filteredText + textLength, entry.m_text, entry.m_length);
+                    m_filteredEntries[count++] = LogBatchEntry{entry.m_logLine, m_filteredText + textLength, entry.m_length};
+                    textLength += entry.m_length;
+                }
+            }
 
-            do
+            if (count != 0)
             {
-                m_logQueue.Wait(lastOperation);
-            } while (!m_logQueue.QueueMessage(std::move(logLine)));
+                sink->SinkLogBatch(LogBatch{m_filteredEntries, count, m_filteredText, textLength});
+                sink->m_bytesWritten += textLength;
+                sink->m_sinkTimeUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sinkStart).count();
+            }
         }
+        EndSinkRead(readerSlot);
     }
 
     /**
-     * @brief Queues a log message to be written to the log.
-     *
-     * @param logLine The log message to be queued.
-     * @return True if the message was queued successfully, false otherwise.
+     * @brief Emits a synthetic warning with the number of messages dropped since the last report.
+     * Called by the log thread once the rings are drained, i.e. once the pressure has cleared.
      */
-    Bool CLog::TryQueueLog(LogLine &&logLine)
+    void CLog::ReportDroppedLogs()
     {
-        return m_logQueue.QueueMessage(std::move(logLine));
-    }
+        const UInt32 droppedCount = static_cast<UInt32>(atomic::Atomic32::Fetch(&m_droppedCount));
+        if (droppedCount == m_reportedDroppedCount)
+        {
+            return;
+        }
 
-    /**
-     * @brief Sends the formatted message and log line to all registered sinks.
-     *
-     * @param formattedMsg The formatted message to be sent to the sinks.
-     * @param logLine The log line containing metadata about the log message.
-     */
-    void CLog::SinkLog(const char *formattedMsg, const LogLine &logLine)
-    {
-        ScopedSharedLock<RWSpinLock> lock(m_sinkLock);
-        for (UInt32 i = 0; i != c_logSinkMax; ++i)
+        struct
         {
-            if (!m_sinks[i])
-            {
-                break;
-            }
+            LogLine m_line;
+            char m_payload[128];
+        } report;
 
-            m_sinks[i]->SinkLog(formattedMsg, logLine);
-        }
+        report.m_line = LogLine{
+            0,
+            std::chrono::system_clock::now(),
+            uge::ThreadId::GetCurrentThread().Get(),
+            LogLineType_Log,
+            LogLevel_Warning,
+            LogCategory_Core,
+            nullptr};
+
+        const Int32 length = Snprintf(report.m_payload, sizeof(report.m_payload), "Log overflow: %u messages dropped", droppedCount - m_reportedDroppedCount);
+        report.m_line.m_size = length + 1;
+        m_reportedDroppedCount = droppedCount;
+
+        ConsumeLogMessage(report.m_line);
     }
 
     namespace priv
@@ -390,12 +1511,13 @@ namespace uge::log
     void InitLog(LogFlushMode mode)
     {
         auto &log = GetLog();
-        if (IsDebuggerPresent())
+        if (dbg::IsDebuggerAttached())
         {
             log.RegisterSink(&s_debugSink);
         }
 
         log.Init(mode);
+        dbg::InstallCrashHandler();
     }
 
     /**
@@ -403,29 +1525,117 @@ namespace uge::log
      */
     void DeinitLog()
     {
+        dbg::UninstallCrashHandler();
+
         auto &log = GetLog();
         log.Deinit();
         log.UnregisterSink(&s_debugSink);
     }
 
+    namespace
+    {
+        /**
+         * @brief The "[YYYY.MM.DD HH:MM:SS" part of the timestamp, rendered once per second.
+         */
+        struct LogTimestampCache
+        {
+            Int64 m_second;
+            UInt32 m_length;
+            char m_text[32];
+        };
+
+        /**
+         * @brief Writes value as a zero padded decimal number of exactly digitCount digits.
+         */
+        void WriteDecimalDigits(char *buffer, UInt32 value, UInt32 digitCount)
+        {
+            for (UInt32 i = digitCount; i != 0; --i)
+            {
+                buffer[i - 1] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+        }
+    }
+
     /**
      * @brief Formats the log message with timestamp, log level and message buffer.
      *
+     * The date and time part of the timestamp only changes once per second, so it is cached per
+     * thread and only the sub-second digits are rendered for every line.
+     *
      * @param buffer The buffer to store the formatted log message.
      * @param bufferSize The size of the buffer.
      * @param logLine The log line containing the message, timestamp and log level.
+     * @param precision The sub-second precision of the timestamp.
+     * @return The length of the formatted message, excluding the terminator.
      */
-    void FormatLogMessage(char *buffer, UInt32 bufferSize, const LogLine &logLine)
+    UInt32 FormatLogMessage(char *buffer, UInt32 bufferSize, const LogLine &logLine, LogTimestampPrecision precision)
     {
-        auto time = std::chrono::system_clock::to_time_t(logLine.m_time);
-        std::tm localTime;
-        localtime_s(&localTime, &time);
+        thread_local LogTimestampCache s_timestampCache = {INT64_MIN, 0, {}};
+
+        if (bufferSize == 0)
+        {
+            return 0;
+        }
+
+        const auto sinceEpoch = logLine.m_time.time_since_epoch();
+        const auto seconds = std::chrono::floor<std::chrono::seconds>(sinceEpoch);
+        if (seconds.count() != s_timestampCache.m_second)
+        {
+            const std::time_t time = static_cast<std::time_t>(seconds.count());
+            std::tm localTime;
+            Localtime(localTime, time);
+
+            s_timestampCache.m_length = static_cast<UInt32>(strftime(s_timestampCache.m_text, sizeof(s_timestampCache.m_text), "[%Y.%m.%d %H:%M:%S", &localTime));
+            s_timestampCache.m_second = seconds.count();
+        }
+
+        char prefix[64];
+        UInt32 prefixLength = s_timestampCache.m_length;
+        Memcpy(prefix, s_timestampCache.m_text, prefixLength);
+
+        if (precision != LogTimestamp_Seconds)
+        {
+            const UInt32 microseconds = static_cast<UInt32>(std::chrono::duration_cast<std::chrono::microseconds>(sinceEpoch - seconds).count());
+            const Bool milliseconds = precision == LogTimestamp_Milliseconds;
+
+            prefix[prefixLength++] = '.';
+            WriteDecimalDigits(prefix + prefixLength, milliseconds ? microseconds / 1000 : microseconds, milliseconds ? 3 : 6);
+            prefixLength += milliseconds ? 3 : 6;
+        }
+
+        prefix[prefixLength++] = ']';
+        Memcpy(prefix + prefixLength, c_loggerLevelString[logLine.m_level], c_loggerLevelStringLength[logLine.m_level]);
+        prefixLength += c_loggerLevelStringLength[logLine.m_level];
+        prefix[prefixLength++] = ' ';
 
-        strftime(buffer, bufferSize, "[%Y.%m.%d %X]", &localTime);
-        Strcat(buffer, c_loggerLevelString[logLine.m_level], bufferSize);
-        Strcat(buffer, " ", bufferSize);
-        Strcat(buffer, logLine.m_buffer, bufferSize);
-        Strcat(buffer, "\n", bufferSize);
+        // Keep room for the new line and the terminator.
+        UInt32 length = std::min(prefixLength, bufferSize - 1);
+        Memcpy(buffer, prefix, length);
+
+        if (length + 2 < bufferSize)
+        {
+            if (logLine.m_type == LogLineType_Fields)
+            {
+                length += FormatLogFields(buffer + length, bufferSize - length - 1, logLine.m_format, reinterpret_cast<const UByte *>(logLine.GetPayload()), logLine.m_size);
+            }
+            else if (logLine.m_format != nullptr)
+            {
+                // Deferred message, format it straight into the output after the prefix.
+                length += DecodeLogArgs(buffer + length, bufferSize - length - 1, logLine.m_format, reinterpret_cast<const UByte *>(logLine.GetPayload()), logLine.m_size);
+            }
+            else
+            {
+                const UInt32 messageLength = std::min<UInt32>(static_cast<UInt32>(Strlen(logLine.GetPayload())), bufferSize - length - 2);
+                Memcpy(buffer + length, logLine.GetPayload(), messageLength);
+                length += messageLength;
+            }
+
+            buffer[length++] = '\n';
+        }
+
+        buffer[length] = '\0';
+        return length;
     }
 
     /**
@@ -462,7 +1672,7 @@ namespace uge::log
         const char *currentLine = message;
         while (const char *nextLine = Strchr(currentLine, '\n'))
         {
-            const UInt32 currentLineLength = std::min<UInt32>(nextLine - currentLine, sizeof(LogLine::m_buffer) - 1);
+            const UInt32 currentLineLength = std::min<UInt32>(nextLine - currentLine, c_logLineBufferSize - 1);
 
             LogMsg(level, category, "%.*s", currentLineLength, currentLine);
 
@@ -482,8 +1692,46 @@ namespace uge::log
         GetLog().PushFlush(mode);
     }
 
+    /**
+     * @brief Flushes the log buffer and waits for the sinks to be flushed, see CLog::FlushAndWait.
+     *
+     * @param timeoutMs The longest time to wait.
+     * @return true if the flush completed in time.
+     */
+    Bool LogFlushAndWait(UInt32 timeoutMs)
+    {
+        return GetLog().FlushAndWait(timeoutMs);
+    }
+
+    LogStats GetLogStats()
+    {
+        return GetLog().GetStats();
+    }
+
+    /**
+     * @brief Writes out everything logged so far from a thread about to take the process down, called
+     * by the dbg crash handlers and CAssert::OnAssert. Gives up on the queued messages after
+     * c_logCrashFlushBudgetMs.
+     *
+     * @param reason Logged at LogLevel_Fatal after the queued messages, or nullptr.
+     */
+    void LogFlushOnCrash(const char *reason)
+    {
+        GetLog().FlushOnCrash(reason, c_logCrashFlushBudgetMs);
+    }
+
     Bool CanLog(LogLevel level, LogCategory category)
     {
         return GetLog().CanLog(level, category);
     }
+
+    const char *GetLogLevelName(LogLevel level)
+    {
+        return level <= LogLevel_Trace ? c_logLevelName[level] : "Unknown";
+    }
+
+    const char *GetLogCategoryName(LogCategory category)
+    {
+        return category < LogCategory_MAX ? c_logCategoryName[category] : "Unknown";
+    }
 }
@@ -1,34 +1,77 @@
 #ifndef __CORESYSTEM_LOG_H__
 #define __CORESYSTEM_LOG_H__
 
+#include "logLine.h"
 #include "logSink.h"
-#include "logQueue.h"
+#include "logArgs.h"
+#include "logFormat.h"
+#include "logFields.h"
+#include "logRateLimiter.h"
+#include "logHistogram.h"
+#include "logRing.h"
+#include "threads/threads.h"
 #include "logThread.h"
-#include "threads/readWriteSpinLock.h"
 
 namespace uge::log
 {
+    constexpr LogLevel c_logMinLevel = UGE_LOG_MIN_LEVEL;
+    constexpr UInt64 c_logCategoryMask = UGE_LOG_CATEGORY_MASK;
+
+    /**
+     * @brief Returns whether UGE_LOG_* calls of this level and category are compiled in at all,
+     * see UGE_LOG_MIN_LEVEL and UGE_LOG_CATEGORY_MASK.
+     */
+    constexpr Bool IsLogCompiledIn(LogLevel level, LogCategory category)
+    {
+        return level <= c_logMinLevel && (c_logCategoryMask & (1ull << category)) != 0;
+    }
+
+    /**
+     * @brief Where queued messages are formatted and handed to the sinks.
+     */
     enum LogFlushMode : UByte
     {
-        LogMode_ASync
+        LogMode_ASync, // On the log thread.
+        LogMode_Sync   // On the logging thread before the push returns, no log thread is started.
     };
 
-    enum LogLevel : UByte
+    /**
+     * @brief Controls where a message's printf formatting happens.
+     *
+     * This only concerns the va_list PushMessage, the default is LogFormat_Immediate since its format
+     * may be a temporary buffer. LogFormat_Deferred only copies the format pointer and the encoded
+     * arguments on the calling thread and formats on the log thread, so the format string must
+     * outlive the queued message. Formats that can't be encoded fall back to immediate formatting.
+     * Log and the UGE_LOG_* macros always defer, their format is a constant checked at compile time.
+     */
+    enum LogFormatMode : UByte
     {
-        LogLevel_Fatal,
-        LogLevel_Error,
-        LogLevel_Warning,
-        LogLevel_Info,
-        LogLevel_Debug,
-        LogLevel_Trace
+        LogFormat_Immediate,
+        LogFormat_Deferred
     };
 
-    enum LogCategory
+    /**
+     * @brief Sub-second digits appended to the timestamp of every formatted line.
+     */
+    enum LogTimestampPrecision : UByte
     {
-        LogCategory_Core,
-        LogCategory_Game,
+        LogTimestamp_Seconds,
+        LogTimestamp_Milliseconds,
+        LogTimestamp_Microseconds
+    };
 
-        LogCategory_MAX
+    /**
+     * @brief How the log thread waits once the rings are empty.
+     *
+     * LogWait_Park, the default, costs no CPU when idle, but a line logged once the rings have been
+     * empty for more than 50us pays for the semaphore wake up: 15 to 25us from enqueue to sink,
+     * against 9 to 13us with LogWait_Poll, which takes about 2% of a core when idle (Release build,
+     * LogBenchmarks.IdleCpuAndLatency on a single core VM). Lines logged in bursts don't pay it.
+     */
+    enum LogWaitMode : UByte
+    {
+        LogWait_Park, // Poll briefly, then sleep on a semaphore the producers release.
+        LogWait_Poll  // Spin for 1ms, yield until 10ms, then sleep 1ms at a time, never woken by the producers.
     };
 
     struct LogCategoryPairs
@@ -38,7 +81,62 @@ namespace uge::log
     };
     extern CORESYSTEM_API LogCategoryPairs g_logCategories[];
 
+    /**
+     * @brief What a producer does when its log ring is full.
+     */
+    enum LogOverflowPolicy : UByte
+    {
+        LogOverflow_Block,      // Wait for the log thread to free space.
+        LogOverflow_DropNewest, // Drop the message being pushed.
+        LogOverflow_DropOldest, // Evict the oldest queued messages of the thread's ring.
+        LogOverflow_Spill       // Move to the shared ring, dropping the message if it's full too.
+    };
+
     const UInt32 c_logSinkMax = 8;
+    const UInt32 c_logRingMax = 64;
+
+    /**
+     * @brief Immutable snapshot of the registered sinks, see CLog::RegisterSink.
+     */
+    struct LogSinkList
+    {
+        UInt32 m_count;
+        LogSink *m_sinks[c_logSinkMax];
+    };
+
+    /**
+     * @brief What a sink was handed and how long it took, see CLog::GetStats.
+     */
+    struct LogSinkStats
+    {
+        const LogSink *m_sink;
+        UInt64 m_bytesWritten;
+        UInt64 m_sinkTimeUs;
+    };
+
+    /**
+     * @brief Snapshot of the log pipeline counters, see CLog::GetStats.
+     *
+     * The counters are written by the consumer only and read without locking: each of them is read
+     * whole, but a snapshot may mix counters of consecutive batches.
+     */
+    struct LogStats
+    {
+        UInt64 m_messageCount;   // Lines handed to the sinks in batches, summaries and reports included.
+        UInt64 m_batchCount;     // SinkLogBatch calls.
+        UInt64 m_flushCount;     // Flush markers consumed.
+        UInt32 m_droppedCount;   // Messages dropped by the overflow policies.
+        UInt32 m_queueHighWater; // Most bytes seen queued in a single ring.
+        UInt32 m_ringCount;      // Producer rings in use, those of exited threads leave once drained.
+        LogLatencyHistogram m_latency;
+
+        UInt32 m_sinkCount;
+        LogSinkStats m_sinks[c_logSinkMax];
+    };
+
+    const UInt32 c_logBatchMax = 256;
+    const UInt32 c_logBatchRecordsSize = 64 * 1024;
+    const UInt32 c_logBatchTextSize = 64 * 1024;
 
     class CORESYSTEM_API CLog
     {
@@ -54,64 +152,201 @@ namespace uge::log
         Bool IsEnabled() const;
         Bool CanLog(LogLevel level, LogCategory category) const
         {
-            return m_enabled && (level <= m_level) && (m_categoryMask & (1ull << category));
+            // The sink filters are folded in, so nothing no sink wants is queued or formatted.
+            return m_enabled && (level <= m_level) && (level <= atomic::Atomic32::Fetch(const_cast<AtomicInt *>(&m_sinkLevel))) &&
+                   (m_categoryMask & static_cast<UInt64>(atomic::Atomic64::Fetch(const_cast<AtomicLong *>(&m_sinkCategoryMask))) & (1ull << category));
         }
 
         void PushMessage(LogLevel level, LogCategory category, const char *format, ...);
         void PushMessage(LogLevel level, LogCategory category, const char *format, va_list args);
+        template <typename... TArgs>
+        void PushMessageArgs(LogLevel level, LogCategory category, const char *format, const TArgs &...args);
+        template <typename... TArgs>
+        void PushFields(LogLevel level, LogCategory category, const char *message, const TArgs &...fields);
         void PushFlush(LogFlushMode mode);
+        Bool FlushAndWait(UInt32 timeoutMs);
 
         void RegisterSink(LogSink *sink);
         void UnregisterSink(LogSink *sink);
+        void UpdateSinkFilters();
 
         bool ConsumeNextLog();
+        void WaitForLogs();
+        void WakeLogThread();
+        void FlushOnCrash(const char *reason, UInt32 budgetMs);
 
         void SetLevel(LogLevel level);
         void RestoreLevel();
+        void SetFormatMode(LogFormatMode mode);
+        void SetTimestampPrecision(LogTimestampPrecision precision);
+        void SetOverflowPolicy(LogOverflowPolicy policy);
+        void SetWaitMode(LogWaitMode mode);
+        void SetRepeatCollapsing(Bool enable);
+        void SetStatsReportInterval(UInt32 seconds);
+        LogStats GetStats();
+        UInt32 GetDroppedCount() const;
         void ToggleLogCategory(LogCategory category, Bool enable = true);
 
     private:
+        Bool ConsumeNextBatch();
+        void ConsumeSynchronously();
+        LogRing *QueueFlush(UInt64 &sequence);
         void ConsumeLogMessage(const LogLine &logLine);
+        void AddBatchEntry(const LogLine &logLine, UInt32 &entryCount, UInt32 &recordsSize, UInt32 &textLength);
+        Bool IsRepeatedLog(const LogLine &logLine) const;
+        void AddRepeatSummary(UInt32 &entryCount, UInt32 &recordsSize, UInt32 &textLength);
+        void AddStatsReport(UInt32 &entryCount, UInt32 &recordsSize, UInt32 &textLength);
+        void RecordBatchStats(const LogBatchEntry *entries, UInt32 count);
         void ConsumeFlushMessage();
-        void QueueLog(LogLine &&logLine);
-        Bool TryQueueLog(LogLine &&logLine);
+        void PollForLogs();
+        LogLine *ReserveLog(UInt32 payloadSize, LogRing *&ring, LogOverflowPolicy policy);
+        LogLine *BeginMessage(LogLineType type, LogLevel level, LogCategory category, const char *format, UInt32 argsSize, LogRing *&ring);
+        template <typename... TArgs>
+        void PushPackedArgs(LogLineType type, LogLevel level, LogCategory category, const char *format, const TArgs &...args);
+        void QueueLog(LogRing *ring, LogLine *logLine);
+        LogRing *GetProducerRing();
+        LogRing *FindOldestLog();
+        void ReclaimRings();
+        Bool HasPendingLogs();
+        void NotifyLogThread();
+        void NotifyBlockedProducers();
         void SinkLog(const char *formattedMsg, const LogLine &logLine);
+        void SinkLogBatch(const LogBatch &batch);
+        const LogSinkList *BeginSinkRead(UInt32 &readerSlot);
+        void EndSinkRead(UInt32 readerSlot);
+        void PublishSinkList(const LogSinkList &sinkList);
+        void ReportDroppedLogs();
 
         Bool m_enabled;
         Bool m_initialized;
         LogLevel m_level;
         LogFlushMode m_flushMode;
+        LogFormatMode m_formatMode;
+        LogTimestampPrecision m_timestampPrecision;
+        LogOverflowPolicy m_overflowPolicy;
         UInt64 m_categoryMask;
-        std::chrono::system_clock::time_point m_lastFlushTime;
 
-        RWSpinLock m_sinkLock;
+        // Copy-on-write sink registry: the sinks are read from the published snapshot without locking.
+        // Writers serialize on m_sinkWriteLock, publish the other snapshot and wait for the readers of
+        // the previous epoch before returning, which also frees the old snapshot for the next writer.
+        Mutex m_sinkWriteLock;
+        LogSinkList m_sinkLists[2];
+        AtomicPointer m_sinkList;
+        AtomicInt m_sinkEpoch;
+        AtomicInt m_sinkReaders[2];
 
-        LogSink *m_sinks[c_logSinkMax];
+        // Union of the registered sinks' filters, written by PublishSinkList while producers read them.
+        // Nothing is filtered while no sink is registered, lines logged before the first RegisterSink
+        // are queued for it.
+        AtomicInt m_sinkLevel;
+        AtomicLong m_sinkCategoryMask;
 
         LogThread *m_logThreadPtr;
         LogThread m_logThreadInstance;
 
-        LogQueue<LogLine> m_logQueue;
+        // Producer rings by slot. A slot is freed once its thread exited and the ring drained, see
+        // ReclaimRings, m_ringCount is one past the highest slot ever taken.
+        UInt32 m_instanceId;
+        AtomicInt m_ringCount;
+        AtomicPointer m_rings[c_logRingMax];
+
+        AtomicInt m_droppedCount;
+        UInt32 m_reportedDroppedCount;
+
+        // Shared ring for threads registering after every ring is taken and for LogOverflow_Spill,
+        // producers serialize on m_sharedRingLock.
+        Mutex m_sharedRingLock;
+        LogRing m_sharedRing;
+
+        // Eventcount style wakeups: the log thread raises m_logThreadSleeping before re-checking the
+        // rings and parking, so producers only pay for a semaphore release when it's actually asleep.
+        AtomicInt m_logThreadSleeping;
+        Semaphore m_logThreadWakeup;
+
+        // LogWait_Poll backoff, owned by the log thread: it restarts whenever a batch was consumed since.
+        LogWaitMode m_waitMode;
+        UInt64 m_pollBatchCount;
+        std::chrono::steady_clock::time_point m_pollIdleStart;
+
+        // Producers blocked on a full ring (LogOverflow_Block), woken as the log thread frees space.
+        AtomicInt m_blockedProducerCount;
+        Semaphore m_producerWakeup;
+
+        // Id of the thread consuming the rings, 0 if none. Normally the log thread, but FlushOnCrash
+        // takes over from the crashing thread.
+        AtomicInt m_consumerThreadId;
+
+        // Producers consuming their own messages in LogMode_Sync serialize on m_syncConsumerLock.
+        Mutex m_syncConsumerLock;
+
+        // Threads in FlushAndWait, woken whenever a flush marker has been sunk.
+        Mutex m_flushLock;
+        ConditionVariable m_flushDone;
+
+        // Batch assembled by the log thread: copies of the consumed records and their formatted lines.
+        LogBatchEntry m_batchEntries[c_logBatchMax];
+        UGE_ALIGNED_VAR(UByte, 8) m_batchRecords[c_logBatchRecordsSize];
+        char m_batchText[c_logBatchTextSize];
+
+        // Repeat collapsing, owned by the log thread: the last message sunk, and how many identical
+        // messages followed it since it or the last "repeated" summary.
+        Bool m_collapseRepeats;
+        UInt32 m_repeatCount;
+        std::chrono::system_clock::time_point m_repeatStart;
+        std::chrono::system_clock::time_point m_repeatEnd;
+        UGE_ALIGNED_VAR(UByte, 8) m_lastRecord[sizeof(LogLine) + c_logLineBufferSize];
+
+        // Pipeline counters, written by the consumer, see GetStats. A report is added to the batches
+        // every m_statsReportInterval when it isn't zero.
+        LogStats m_stats;
+        std::chrono::seconds m_statsReportInterval;
+        std::chrono::system_clock::time_point m_lastStatsReport;
+
+        // Part of the batch a sink's filter accepts, when it doesn't accept all of it.
+        LogBatchEntry m_filteredEntries[c_logBatchMax];
+        char m_filteredText[c_logBatchTextSize];
     };
 
     CORESYSTEM_API CLog &GetLog();
     CORESYSTEM_API void InitLog(LogFlushMode mode = LogMode_ASync);
     CORESYSTEM_API void DeinitLog();
-    CORESYSTEM_API void FormatLogMessage(char *buffer, UInt32 bufferSize, const LogLine &logLine);
+    CORESYSTEM_API UInt32 FormatLogMessage(char *buffer, UInt32 bufferSize, const LogLine &logLine, LogTimestampPrecision precision = LogTimestamp_Milliseconds);
     CORESYSTEM_API void LogMsg(LogLevel level, LogCategory category, const char *format, ...);
     CORESYSTEM_API void LogMessage(LogLevel level, const char *message, LogCategory category);
     CORESYSTEM_API void LogFlush(LogFlushMode mode = LogMode_ASync);
+    CORESYSTEM_API Bool LogFlushAndWait(UInt32 timeoutMs);
+    CORESYSTEM_API LogStats GetLogStats();
+    CORESYSTEM_API void LogFlushOnCrash(const char *reason);
     CORESYSTEM_API Bool CanLog(LogLevel level, LogCategory category);
+    CORESYSTEM_API const char *GetLogLevelName(LogLevel level);
+    CORESYSTEM_API const char *GetLogCategoryName(LogCategory category);
+
+    template <LogLevel TLevel, LogCategory TCategory, typename... TArgs>
+    void Log(LogFormatString<std::type_identity_t<TArgs>...> format, const TArgs &...args);
+
+    template <LogLevel TLevel, LogCategory TCategory, typename... TArgs>
+    void Log(LogRateLimiter &limiter, LogFormatString<std::type_identity_t<TArgs>...> format, const TArgs &...args);
+
+    template <LogLevel TLevel, LogCategory TCategory, typename... TArgs>
+    void LogFields(const char *message, const TArgs &...fields);
+
+    template <LogLevel TLevel, LogCategory TCategory, typename... TArgs>
+    void LogFields(LogRateLimiter &limiter, const char *message, const TArgs &...fields);
 }
 
+#include "log.inl"
+
 #ifdef UGE_LOG_ENABLED
-#define INTERNAL_LOG(level, category, message, ...)                    \
-    do                                                                 \
-    {                                                                  \
-        if (uge::log::CanLog(level, category))                         \
-        {                                                              \
-            uge::log::LogMsg(level, category, message, ##__VA_ARGS__); \
-        }                                                              \
+// Calls compiled out by IsLogCompiledIn leave neither code nor format string behind, their format
+// is still checked against the arguments. Every call site has its own LogRateLimiter.
+#define INTERNAL_LOG(level, category, message, ...)                                   \
+    do                                                                                \
+    {                                                                                 \
+        if constexpr (uge::log::IsLogCompiledIn(level, category))                     \
+        {                                                                             \
+            static constinit uge::log::LogRateLimiter s_logRateLimiter;               \
+            uge::log::Log<level, category>(s_logRateLimiter, message, ##__VA_ARGS__); \
+        }                                                                             \
     } while ((void)0, 0)
 
 #define UGE_LOG_FATAL(category, message, ...) INTERNAL_LOG(uge::log::LogLevel_Fatal, category, message, ##__VA_ARGS__)
@@ -121,6 +356,25 @@ namespace uge::log
 #define UGE_LOG_DEBUG(category, message, ...) INTERNAL_LOG(uge::log::LogLevel_Debug, category, message, ##__VA_ARGS__)
 #define UGE_LOG_TRACE(category, message, ...) INTERNAL_LOG(uge::log::LogLevel_Trace, category, message, ##__VA_ARGS__)
 
+// Structured messages: a plain message followed by key/value pairs, e.g.
+// UGE_LOG_INFO_KV(LogCategory_Game, "Entity spawned", "entity", id, "ms", time), see LogFields.
+#define INTERNAL_LOG_KV(level, category, message, ...)                                      \
+    do                                                                                      \
+    {                                                                                       \
+        if constexpr (uge::log::IsLogCompiledIn(level, category))                           \
+        {                                                                                   \
+            static constinit uge::log::LogRateLimiter s_logRateLimiter;                     \
+            uge::log::LogFields<level, category>(s_logRateLimiter, message, ##__VA_ARGS__); \
+        }                                                                                   \
+    } while ((void)0, 0)
+
+#define UGE_LOG_FATAL_KV(category, message, ...) INTERNAL_LOG_KV(uge::log::LogLevel_Fatal, category, message, ##__VA_ARGS__)
+#define UGE_LOG_ERROR_KV(category, message, ...) INTERNAL_LOG_KV(uge::log::LogLevel_Error, category, message, ##__VA_ARGS__)
+#define UGE_LOG_WARNING_KV(category, message, ...) INTERNAL_LOG_KV(uge::log::LogLevel_Warning, category, message, ##__VA_ARGS__)
+#define UGE_LOG_INFO_KV(category, message, ...) INTERNAL_LOG_KV(uge::log::LogLevel_Info, category, message, ##__VA_ARGS__)
+#define UGE_LOG_DEBUG_KV(category, message, ...) INTERNAL_LOG_KV(uge::log::LogLevel_Debug, category, message, ##__VA_ARGS__)
+#define UGE_LOG_TRACE_KV(category, message, ...) INTERNAL_LOG_KV(uge::log::LogLevel_Trace, category, message, ##__VA_ARGS__)
+
 #define UGE_LOG_FLUSH() uge::log::LogFlush()
 
 #define UGE_ENABLE_LOG() uge::log::GetLog().Enable()
@@ -154,6 +408,34 @@ namespace uge::log
     do                                        \
     {                                         \
     } while ((void)0, 0)
+#define INTERNAL_LOG_KV(level, category, message, ...) \
+    do                                                 \
+    {                                                  \
+    } while ((void)0, 0)
+#define UGE_LOG_FATAL_KV(category, message, ...) \
+    do                                           \
+    {                                            \
+    } while ((void)0, 0)
+#define UGE_LOG_ERROR_KV(category, message, ...) \
+    do                                           \
+    {                                            \
+    } while ((void)0, 0)
+#define UGE_LOG_WARNING_KV(category, message, ...) \
+    do                                             \
+    {                                              \
+    } while ((void)0, 0)
+#define UGE_LOG_INFO_KV(category, message, ...) \
+    do                                          \
+    {                                           \
+    } while ((void)0, 0)
+#define UGE_LOG_DEBUG_KV(category, message, ...) \
+    do                                           \
+    {                                            \
+    } while ((void)0, 0)
+#define UGE_LOG_TRACE_KV(category, message, ...) \
+    do                                           \
+    {                                            \
+    } while ((void)0, 0)
 #define UGE_LOG_FLUSH() \
     do                  \
     {                   \
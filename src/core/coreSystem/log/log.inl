@@ -0,0 +1,143 @@
+#ifndef __CORESYSTEM_LOG_INL__
+#define __CORESYSTEM_LOG_INL__
+
+namespace uge::log
+{
+    /**
+     * @brief Queues a message whose arguments are packed according to their C++ types.
+     * This is the back end of Log, the format must match the arguments as checked by ValidateLogFormat.
+     * Messages pushed this way are always formatted on the log thread.
+     *
+     * @param level The log level of the message.
+     * @param category The category of the message.
+     * @param format The format string of the message, must outlive the queued message.
+     * @param args The arguments to be formatted into the message.
+     */
+    template <typename... TArgs>
+    UGE_FORCE_INLINE void CLog::PushMessageArgs(LogLevel level, LogCategory category, const char *format, const TArgs &...args)
+    {
+        PushPackedArgs(LogLineType_Log, level, category, format, args...);
+    }
+
+    /**
+     * @brief Queues a structured message, its fields are packed like the arguments of PushMessageArgs.
+     * This is the back end of LogFields, the fields must pass IsLogFieldList.
+     *
+     * @param level The log level of the message.
+     * @param category The category of the message.
+     * @param message The message, printed as is, must outlive the queued message.
+     * @param fields The key/value pairs of the message.
+     */
+    template <typename... TArgs>
+    UGE_FORCE_INLINE void CLog::PushFields(LogLevel level, LogCategory category, const char *message, const TArgs &...fields)
+    {
+        PushPackedArgs(LogLineType_Fields, level, category, message, fields...);
+    }
+
+    template <typename... TArgs>
+    UGE_FORCE_INLINE void CLog::PushPackedArgs(LogLineType type, LogLevel level, LogCategory category, const char *format, const TArgs &...args)
+    {
+        static_assert(LogArgPacker<TArgs...>::c_fixedSize <= c_logLineBufferSize, "Too many log arguments");
+
+        LogArgPacker<TArgs...> packer;
+        const UInt32 argsSize = packer.Measure(c_logLineBufferSize, args...);
+
+        LogRing *ring = nullptr;
+        LogLine *logMsg = BeginMessage(type, level, category, format, argsSize, ring);
+        if (logMsg != nullptr)
+        {
+            packer.Write(reinterpret_cast<UByte *>(logMsg->GetPayload()), argsSize, args...);
+            QueueLog(ring, logMsg);
+        }
+    }
+
+    /**
+     * @brief Logs a message whose format string is checked against its arguments at compile time.
+     * The arguments are packed by type, so only the bytes they need are reserved in the log ring.
+     *
+     * @param format The format string of the message.
+     * @param args The arguments to be formatted into the message.
+     */
+    template <LogLevel TLevel, LogCategory TCategory, typename... TArgs>
+    UGE_FORCE_INLINE void Log(LogFormatString<std::type_identity_t<TArgs>...> format, const TArgs &...args)
+    {
+        if constexpr (IsLogCompiledIn(TLevel, TCategory))
+        {
+            CLog &log = GetLog();
+            if (log.CanLog(TLevel, TCategory))
+            {
+                log.PushMessageArgs(TLevel, TCategory, format.Get(), args...);
+            }
+        }
+    }
+
+    /**
+     * @brief Logs a message like Log, unless the call site's rate limiter suppresses it, see
+     * IsLogRateLimited. Messages the log level or category filters out don't use up the limiter's budget.
+     *
+     * @param limiter The rate limiter of the call site.
+     * @param format The format string of the message.
+     * @param args The arguments to be formatted into the message.
+     */
+    template <LogLevel TLevel, LogCategory TCategory, typename... TArgs>
+    UGE_FORCE_INLINE void Log(LogRateLimiter &limiter, LogFormatString<std::type_identity_t<TArgs>...> format, const TArgs &...args)
+    {
+        if constexpr (IsLogCompiledIn(TLevel, TCategory))
+        {
+            CLog &log = GetLog();
+            if (log.CanLog(TLevel, TCategory) && (!IsLogRateLimited(TLevel) || limiter.TryAcquire()))
+            {
+                limiter.ReportSuppressed(TLevel, TCategory);
+                log.PushMessageArgs(TLevel, TCategory, format.Get(), args...);
+            }
+        }
+    }
+
+    /**
+     * @brief Logs a structured message: a plain message and typed key/value fields, e.g.
+     * LogFields<LogLevel_Info, LogCategory_Game>("Entity spawned", "entity", id, "ms", time).
+     * The values are packed like Log's arguments and only turned into text by the sinks.
+     *
+     * @param message The message, printed as is.
+     * @param fields Pairs of a string key and a value.
+     */
+    template <LogLevel TLevel, LogCategory TCategory, typename... TArgs>
+    UGE_FORCE_INLINE void LogFields(const char *message, const TArgs &...fields)
+    {
+        static_assert(IsLogFieldList<std::decay_t<TArgs>...>(), "Fields must be pairs of a string key and a value that can be logged");
+
+        if constexpr (IsLogCompiledIn(TLevel, TCategory))
+        {
+            CLog &log = GetLog();
+            if (log.CanLog(TLevel, TCategory))
+            {
+                log.PushFields(TLevel, TCategory, message, fields...);
+            }
+        }
+    }
+
+    /**
+     * @brief Logs a structured message like LogFields, unless the call site's rate limiter suppresses it.
+     *
+     * @param limiter The rate limiter of the call site.
+     * @param message The message, printed as is.
+     * @param fields Pairs of a string key and a value.
+     */
+    template <LogLevel TLevel, LogCategory TCategory, typename... TArgs>
+    UGE_FORCE_INLINE void LogFields(LogRateLimiter &limiter, const char *message, const TArgs &...fields)
+    {
+        static_assert(IsLogFieldList<std::decay_t<TArgs>...>(), "Fields must be pairs of a string key and a value that can be logged");
+
+        if constexpr (IsLogCompiledIn(TLevel, TCategory))
+        {
+            CLog &log = GetLog();
+            if (log.CanLog(TLevel, TCategory) && (!IsLogRateLimited(TLevel) || limiter.TryAcquire()))
+            {
+                limiter.ReportSuppressed(TLevel, TCategory);
+                log.PushFields(TLevel, TCategory, message, fields...);
+            }
+        }
+    }
+}
+
+#endif // __CORESYSTEM_LOG_INL__
@@ -0,0 +1,383 @@
+#include "build.h"
+
+#include "logArgs.h"
+
+namespace uge::log
+{
+    namespace
+    {
+        /**
+         * @brief Reads back the tagged arguments written by LogArgWriter.
+         */
+        class LogArgReader
+        {
+        public:
+            LogArgReader(const UByte *args, UInt32 argsSize)
+                : m_args(args), m_argsSize(argsSize), m_position(0)
+            {
+            }
+
+            Bool ReadInt32(Int32 &value)
+            {
+                return Read(LogArgType_Int32, &value, sizeof(value));
+            }
+
+            /**
+             * @brief Formats the next argument with the given single-conversion format string.
+             *
+             * @return The number of characters written, or -1 if the argument is missing or the output was truncated.
+             */
+            Int32 Format(char *buffer, UInt32 bufferSize, const char *specFormat, LogArgType type)
+            {
+                Int32 result = -1;
+                switch (type)
+                {
+                case LogArgType_Int32:
+                {
+                    Int32 value = 0;
+                    result = Read(type, &value, sizeof(value)) ? Snprintf(buffer, bufferSize, specFormat, value) : -1;
+                    break;
+                }
+                case LogArgType_Int64:
+                {
+                    Int64 value = 0;
+                    result = Read(type, &value, sizeof(value)) ? Snprintf(buffer, bufferSize, specFormat, value) : -1;
+                    break;
+                }
+                case LogArgType_Double:
+                {
+                    Double value = 0.0;
+                    result = Read(type, &value, sizeof(value)) ? Snprintf(buffer, bufferSize, specFormat, value) : -1;
+                    break;
+                }
+                case LogArgType_Pointer:
+                {
+                    UInt64 value = 0;
+                    result = Read(type, &value, sizeof(value)) ? Snprintf(buffer, bufferSize, specFormat, reinterpret_cast<const void *>(value)) : -1;
+                    break;
+                }
+                case LogArgType_String:
+                {
+                    const AnsiChar *value = ReadChars<AnsiChar>(type);
+                    result = value != nullptr ? Snprintf(buffer, bufferSize, specFormat, value) : -1;
+                    break;
+                }
+                case LogArgType_WideString:
+                {
+                    const UniChar *value = ReadChars<UniChar>(type);
+                    result = value != nullptr ? Snprintf(buffer, bufferSize, specFormat, value) : -1;
+                    break;
+                }
+                default:
+                    break;
+                }
+
+                return result < static_cast<Int32>(bufferSize) ? result : -1;
+            }
+
+        private:
+            Bool Read(LogArgType type, void *value, UInt32 size)
+            {
+                if (m_position + 1 + size > m_argsSize || GetLogArgStorageType(static_cast<LogArgType>(m_args[m_position])) != type)
+                {
+                    return false;
+                }
+
+                Memcpy(value, m_args + m_position + 1, size);
+                m_position += 1 + size;
+                return true;
+            }
+
+            template <typename TChar>
+            const TChar *ReadChars(LogArgType type)
+            {
+                const UInt32 headerSize = 1 + sizeof(UInt16);
+                if (m_position + headerSize > m_argsSize || m_args[m_position] != type)
+                {
+                    return nullptr;
+                }
+
+                UInt16 count = 0;
+                Memcpy(&count, m_args + m_position + 1, sizeof(count));
+                if (count == 0 || m_position + headerSize + count * sizeof(TChar) > m_argsSize)
+                {
+                    return nullptr;
+                }
+
+                const TChar *value = reinterpret_cast<const TChar *>(m_args + m_position + headerSize);
+                m_position += headerSize + count * sizeof(TChar);
+                return value;
+            }
+
+            const UByte *m_args;
+            UInt32 m_argsSize;
+            UInt32 m_position;
+        };
+
+        /**
+         * @brief Rebuilds a single conversion with '*' replaced by the decoded width/precision and the
+         * length modifier replaced by the one matching the encoded argument type. 'h' and 'hh' are
+         * kept, the argument is stored promoted to an Int32.
+         */
+        void BuildSpecFormat(char *specFormat, UInt32 specFormatSize, const LogFormatSpec &spec, Int32 width, Int32 precision)
+        {
+            UInt32 length = 0;
+            const char *cursor = spec.m_begin;
+
+            specFormat[length++] = *cursor++;
+            while (length + 1 < specFormatSize && (*cursor == '-' || *cursor == '+' || *cursor == ' ' || *cursor == '#' || *cursor == '0' || *cursor == '\''))
+            {
+                specFormat[length++] = *cursor++;
+            }
+
+            if (spec.m_widthArg)
+            {
+                length += Snprintf(specFormat + length, specFormatSize - length, "%d", width);
+                ++cursor;
+            }
+            else
+            {
+                while (length + 1 < specFormatSize && *cursor >= '0' && *cursor <= '9')
+                {
+                    specFormat[length++] = *cursor++;
+                }
+            }
+
+            // A negative precision passed through '*' behaves as if the precision was omitted.
+            if (*cursor == '.' && precision >= 0)
+            {
+                length += Snprintf(specFormat + length, specFormatSize - length, ".%d", precision);
+            }
+
+            const char *lengthModifier = "";
+            if (spec.m_argType == LogArgType_Int64)
+            {
+                lengthModifier = "ll";
+            }
+            else if (spec.m_shortCount != 0)
+            {
+                lengthModifier = spec.m_shortCount == 1 ? "h" : "hh";
+            }
+            else if (spec.m_wide)
+            {
+                lengthModifier = "l";
+            }
+
+            const char conversion = spec.m_conversion == 'S' ? 's' : spec.m_conversion == 'C' ? 'c' : spec.m_conversion;
+            Snprintf(specFormat + length, specFormatSize - length, "%s%c", lengthModifier, conversion);
+        }
+    }
+
+    /**
+     * @brief Encodes the arguments referenced by format into a compact tagged binary form.
+     * Strings are copied by value, every other argument is stored as a fixed-size scalar.
+     *
+     * @param buffer The buffer receiving the encoded arguments.
+     * @param bufferSize The size of the buffer.
+     * @param format The printf style format string describing the arguments.
+     * @param args The arguments to encode.
+     * @return The number of bytes written, or c_logArgsInvalid if the format can't be deferred.
+     */
+    UInt32 EncodeLogArgs(UByte *buffer, UInt32 bufferSize, const char *format, va_list args)
+    {
+        LogArgWriter writer(buffer, bufferSize);
+
+        const char *cursor = Strchr(format, '%');
+        while (cursor != nullptr)
+        {
+            LogFormatSpec spec;
+            if (!ParseLogFormatSpec(cursor, spec))
+            {
+                return c_logArgsInvalid;
+            }
+
+            Int32 precision = spec.m_precision;
+            if (spec.m_widthArg)
+            {
+                writer.WriteInt32(va_arg(args, Int32));
+            }
+
+            if (spec.m_precisionArg)
+            {
+                precision = va_arg(args, Int32);
+                writer.WriteInt32(precision);
+            }
+
+            switch (spec.m_argType)
+            {
+            case LogArgType_Int32:
+                writer.WriteInt32(va_arg(args, Int32));
+                break;
+            case LogArgType_Int64:
+                writer.WriteInt64(va_arg(args, Int64));
+                break;
+            case LogArgType_Double:
+                writer.WriteDouble(va_arg(args, Double));
+                break;
+            case LogArgType_Pointer:
+                writer.WritePointer(va_arg(args, const void *));
+                break;
+            case LogArgType_String:
+                writer.WriteString(va_arg(args, const AnsiChar *), precision);
+                break;
+            case LogArgType_WideString:
+                writer.WriteString(va_arg(args, const UniChar *), precision);
+                break;
+            default:
+                break;
+            }
+
+            cursor = Strchr(spec.m_end, '%');
+        }
+
+        return writer.HasOverflowed() ? c_logArgsInvalid : writer.GetSize();
+    }
+
+    /**
+     * @brief Formats a deferred message from its format string and encoded arguments.
+     *
+     * @param buffer The buffer receiving the formatted, null terminated text.
+     * @param bufferSize The size of the buffer.
+     * @param format The format string the arguments were encoded with.
+     * @param args The encoded arguments.
+     * @param argsSize The size of the encoded arguments.
+     * @return The number of characters written, excluding the terminator.
+     */
+    Int32 DecodeLogArgs(char *buffer, UInt32 bufferSize, const char *format, const UByte *args, UInt32 argsSize)
+    {
+        if (bufferSize == 0)
+        {
+            return 0;
+        }
+
+        LogArgReader reader(args, argsSize);
+        UInt32 length = 0;
+
+        const char *cursor = format;
+        while (*cursor != '\0' && length + 1 < bufferSize)
+        {
+            const char *nextSpec = Strchr(cursor, '%');
+            const UInt32 literalLength = static_cast<UInt32>(nextSpec != nullptr ? nextSpec - cursor : Strlen(cursor));
+            const UInt32 copyLength = std::min(literalLength, bufferSize - length - 1);
+
+            Memcpy(buffer + length, cursor, copyLength);
+            length += copyLength;
+            if (nextSpec == nullptr || copyLength != literalLength)
+            {
+                break;
+            }
+
+            LogFormatSpec spec;
+            if (!ParseLogFormatSpec(nextSpec, spec))
+            {
+                break;
+            }
+
+            cursor = spec.m_end;
+            if (spec.m_argType == LogArgType_None)
+            {
+                buffer[length++] = '%';
+                continue;
+            }
+
+            Int32 width = 0;
+            Int32 precision = spec.m_precision;
+            if ((spec.m_widthArg && !reader.ReadInt32(width)) || (spec.m_precisionArg && !reader.ReadInt32(precision)))
+            {
+                break;
+            }
+
+            char specFormat[32];
+            BuildSpecFormat(specFormat, sizeof(specFormat), spec, width, precision);
+
+            buffer[length] = '\0';
+            const Int32 written = reader.Format(buffer + length, bufferSize - length, specFormat, spec.m_argType);
+            if (written < 0)
+            {
+                length += static_cast<UInt32>(Strlen(buffer + length));
+                break;
+            }
+
+            length += written;
+        }
+
+        buffer[length] = '\0';
+        return static_cast<Int32>(length);
+    }
+
+    /**
+     * @brief Reads the next encoded argument, whatever its type.
+     *
+     * @param args The encoded arguments.
+     * @param argsSize The size of the encoded arguments.
+     * @param position The offset of the argument to read, moved past it.
+     * @param value Receives the argument.
+     * @return false at the end of the arguments or if they are malformed.
+     */
+    Bool ReadLogArg(const UByte *args, UInt32 argsSize, UInt32 &position, LogArgValue &value)
+    {
+        if (position >= argsSize)
+        {
+            return false;
+        }
+
+        value.m_type = static_cast<LogArgType>(args[position]);
+        value.m_length = 0;
+
+        UInt32 size = 0;
+        switch (value.m_type)
+        {
+        case LogArgType_Int32:
+        case LogArgType_UInt32:
+            size = sizeof(value.m_int32);
+            break;
+        case LogArgType_Int64:
+        case LogArgType_UInt64:
+        case LogArgType_Double:
+        case LogArgType_Pointer:
+            size = sizeof(UInt64);
+            break;
+        case LogArgType_String:
+        case LogArgType_WideString:
+        {
+            const UInt32 headerSize = 1 + sizeof(UInt16);
+            const UInt32 charSize = value.m_type == LogArgType_String ? sizeof(AnsiChar) : sizeof(UniChar);
+
+            UInt16 count = 0;
+            if (position + headerSize > argsSize)
+            {
+                return false;
+            }
+
+            Memcpy(&count, args + position + 1, sizeof(count));
+            if (count == 0 || position + headerSize + count * charSize > argsSize)
+            {
+                return false;
+            }
+
+            value.m_length = count - 1;
+            if (value.m_type == LogArgType_String)
+            {
+                value.m_string = reinterpret_cast<const AnsiChar *>(args + position + headerSize);
+            }
+            else
+            {
+                value.m_wideString = reinterpret_cast<const UniChar *>(args + position + headerSize);
+            }
+            position += headerSize + count * charSize;
+            return true;
+        }
+        default:
+            return false;
+        }
+
+        if (position + 1 + size > argsSize)
+        {
+            return false;
+        }
+
+        Memcpy(&value.m_int64, args + position + 1, size);
+        position += 1 + size;
+        return true;
+    }
+}
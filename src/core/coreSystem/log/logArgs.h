@@ -0,0 +1,108 @@
+#ifndef __CORESYSTEM_LOGARGS_H__
+#define __CORESYSTEM_LOGARGS_H__
+
+namespace uge::log
+{
+    /**
+     * @brief Tag written in front of every encoded log argument so the log thread can
+     * read the arguments back without trusting the caller's va_list.
+     */
+    enum LogArgType : UByte
+    {
+        LogArgType_None,
+        LogArgType_Int32,
+        LogArgType_Int64,
+
+        // Stored like their signed counterparts, kept apart so fields print unsigned values as such.
+        LogArgType_UInt32,
+        LogArgType_UInt64,
+
+        LogArgType_Double,
+        LogArgType_Pointer,
+        LogArgType_String,
+        LogArgType_WideString
+    };
+
+    /**
+     * @brief A single printf conversion specification parsed out of a log format string.
+     */
+    struct LogFormatSpec
+    {
+        const char *m_begin;
+        const char *m_end;
+        LogArgType m_argType;
+        char m_conversion;
+        Bool m_wide;
+        Bool m_widthArg;
+        Bool m_precisionArg;
+        Int32 m_precision;
+
+        // 1 for 'h', 2 for 'hh': the decoded integer is printed truncated like printf would.
+        UByte m_shortCount;
+    };
+
+    /**
+     * @brief An encoded argument read back by ReadLogArg. Strings point into the encoded arguments.
+     */
+    struct LogArgValue
+    {
+        LogArgType m_type;
+
+        // Characters of strings, terminator excluded.
+        UInt32 m_length;
+
+        union
+        {
+            Int32 m_int32;
+            Int64 m_int64;
+            UInt32 m_uint32;
+            UInt64 m_uint64;
+            Double m_double;
+            UInt64 m_pointer;
+            const AnsiChar *m_string;
+            const UniChar *m_wideString;
+        };
+    };
+
+    const UInt32 c_logArgsInvalid = UINT32_MAX;
+
+    constexpr LogArgType GetLogArgStorageType(LogArgType type);
+    constexpr Bool ParseLogFormatSpec(const char *cursor, LogFormatSpec &spec);
+
+    class LogArgWriter
+    {
+    public:
+        LogArgWriter(UByte *buffer, UInt32 bufferSize);
+
+        void WriteInt32(Int32 value);
+        void WriteInt64(Int64 value);
+        void WriteUInt32(UInt32 value);
+        void WriteUInt64(UInt64 value);
+        void WriteDouble(Double value);
+        void WritePointer(const void *value);
+        void WriteString(const AnsiChar *value, Int32 precision = -1);
+        void WriteString(const UniChar *value, Int32 precision = -1);
+
+        UInt32 GetSize() const;
+        Bool HasOverflowed() const;
+
+    private:
+        void Write(LogArgType type, const void *value, UInt32 size);
+
+        template <typename TChar>
+        void WriteChars(LogArgType type, const TChar *value, Int32 precision);
+
+        UByte *m_buffer;
+        UInt32 m_bufferSize;
+        UInt32 m_size;
+        Bool m_overflow;
+    };
+
+    CORESYSTEM_API UInt32 EncodeLogArgs(UByte *buffer, UInt32 bufferSize, const char *format, va_list args);
+    CORESYSTEM_API Int32 DecodeLogArgs(char *buffer, UInt32 bufferSize, const char *format, const UByte *args, UInt32 argsSize);
+    CORESYSTEM_API Bool ReadLogArg(const UByte *args, UInt32 argsSize, UInt32 &position, LogArgValue &value);
+}
+
+#include "logArgs.inl"
+
+#endif // __CORESYSTEM_LOGARGS_H__
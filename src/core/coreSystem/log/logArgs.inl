@@ -0,0 +1,281 @@
+#ifndef __CORESYSTEM_LOGARGS_INL__
+#define __CORESYSTEM_LOGARGS_INL__
+
+namespace uge::log
+{
+    /**
+     * @brief Returns the type an argument is stored as, unsigned integers are stored like signed ones
+     * and printf conversions take either.
+     */
+    constexpr LogArgType GetLogArgStorageType(LogArgType type)
+    {
+        switch (type)
+        {
+        case LogArgType_UInt32:
+            return LogArgType_Int32;
+        case LogArgType_UInt64:
+            return LogArgType_Int64;
+        default:
+            return type;
+        }
+    }
+
+    /**
+     * @brief Parses the printf conversion specification starting at cursor.
+     *
+     * @param cursor Pointer to the '%' that starts the specification.
+     * @param spec Receives the parsed specification.
+     * @return true if the specification is supported, false otherwise (e.g. %n or long double).
+     */
+    constexpr Bool ParseLogFormatSpec(const char *cursor, LogFormatSpec &spec)
+    {
+        spec = LogFormatSpec{cursor, cursor, LogArgType_None, '\0', false, false, false, -1, 0};
+
+        ++cursor;
+        if (*cursor == '%')
+        {
+            spec.m_conversion = '%';
+            spec.m_end = cursor + 1;
+            return true;
+        }
+
+        while (*cursor == '-' || *cursor == '+' || *cursor == ' ' || *cursor == '#' || *cursor == '0' || *cursor == '\'')
+        {
+            ++cursor;
+        }
+
+        if (*cursor == '*')
+        {
+            spec.m_widthArg = true;
+            ++cursor;
+        }
+        else
+        {
+            while (*cursor >= '0' && *cursor <= '9')
+            {
+                ++cursor;
+            }
+        }
+
+        if (*cursor == '.')
+        {
+            ++cursor;
+            if (*cursor == '*')
+            {
+                spec.m_precisionArg = true;
+                ++cursor;
+            }
+            else
+            {
+                spec.m_precision = 0;
+                while (*cursor >= '0' && *cursor <= '9')
+                {
+                    spec.m_precision = spec.m_precision * 10 + (*cursor - '0');
+                    ++cursor;
+                }
+            }
+        }
+
+        UInt32 shortCount = 0;
+        Bool wideArg = false;
+        Bool largeArg = false;
+        UInt32 longCount = 0;
+        for (Bool parsingLength = true; parsingLength;)
+        {
+            switch (*cursor)
+            {
+            case 'h':
+                ++shortCount;
+                ++cursor;
+                break;
+            case 'l':
+                ++longCount;
+                ++cursor;
+                break;
+            case 'w':
+                wideArg = true;
+                ++cursor;
+                break;
+            case 'j':
+            case 'z':
+            case 't':
+                largeArg = sizeof(size_t) == sizeof(Int64);
+                ++cursor;
+                break;
+            case 'I':
+                if (cursor[1] == '6' && cursor[2] == '4')
+                {
+                    largeArg = true;
+                    cursor += 3;
+                }
+                else if (cursor[1] == '3' && cursor[2] == '2')
+                {
+                    cursor += 3;
+                }
+                else
+                {
+                    largeArg = sizeof(size_t) == sizeof(Int64);
+                    ++cursor;
+                }
+                break;
+            case 'L':
+                // long double can't be read back as a Double on every platform.
+                return false;
+            default:
+                parsingLength = false;
+                break;
+            }
+        }
+
+        spec.m_conversion = *cursor;
+        switch (*cursor)
+        {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            largeArg = largeArg || longCount > 1 || (longCount == 1 && sizeof(long) == sizeof(Int64));
+            spec.m_argType = largeArg ? LogArgType_Int64 : LogArgType_Int32;
+            spec.m_shortCount = static_cast<UByte>(largeArg ? 0 : std::min<UInt32>(shortCount, 2));
+            break;
+        case 'c':
+            spec.m_argType = LogArgType_Int32;
+            spec.m_wide = (longCount > 0 || wideArg) && shortCount == 0;
+            break;
+        case 'C':
+            spec.m_argType = LogArgType_Int32;
+            spec.m_wide = shortCount == 0;
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            spec.m_argType = LogArgType_Double;
+            break;
+        case 'p':
+            spec.m_argType = LogArgType_Pointer;
+            break;
+        case 's':
+            spec.m_wide = (longCount > 0 || wideArg) && shortCount == 0;
+            spec.m_argType = spec.m_wide ? LogArgType_WideString : LogArgType_String;
+            break;
+        case 'S':
+            spec.m_wide = shortCount == 0;
+            spec.m_argType = spec.m_wide ? LogArgType_WideString : LogArgType_String;
+            break;
+        default:
+            return false;
+        }
+
+        spec.m_end = cursor + 1;
+        return true;
+    }
+
+    UGE_INLINE LogArgWriter::LogArgWriter(UByte *buffer, UInt32 bufferSize)
+        : m_buffer(buffer), m_bufferSize(bufferSize), m_size(0), m_overflow(false)
+    {
+    }
+
+    UGE_FORCE_INLINE void LogArgWriter::WriteInt32(Int32 value)
+    {
+        Write(LogArgType_Int32, &value, sizeof(value));
+    }
+
+    UGE_FORCE_INLINE void LogArgWriter::WriteInt64(Int64 value)
+    {
+        Write(LogArgType_Int64, &value, sizeof(value));
+    }
+
+    UGE_FORCE_INLINE void LogArgWriter::WriteUInt32(UInt32 value)
+    {
+        Write(LogArgType_UInt32, &value, sizeof(value));
+    }
+
+    UGE_FORCE_INLINE void LogArgWriter::WriteUInt64(UInt64 value)
+    {
+        Write(LogArgType_UInt64, &value, sizeof(value));
+    }
+
+    UGE_FORCE_INLINE void LogArgWriter::WriteDouble(Double value)
+    {
+        Write(LogArgType_Double, &value, sizeof(value));
+    }
+
+    UGE_FORCE_INLINE void LogArgWriter::WritePointer(const void *value)
+    {
+        const UInt64 address = reinterpret_cast<UInt64>(value);
+        Write(LogArgType_Pointer, &address, sizeof(address));
+    }
+
+    UGE_INLINE void LogArgWriter::WriteString(const AnsiChar *value, Int32 precision)
+    {
+        WriteChars(LogArgType_String, value != nullptr ? value : "(null)", precision);
+    }
+
+    UGE_INLINE void LogArgWriter::WriteString(const UniChar *value, Int32 precision)
+    {
+        WriteChars(LogArgType_WideString, value != nullptr ? value : L"(null)", precision);
+    }
+
+    UGE_FORCE_INLINE UInt32 LogArgWriter::GetSize() const
+    {
+        return m_size;
+    }
+
+    UGE_FORCE_INLINE Bool LogArgWriter::HasOverflowed() const
+    {
+        return m_overflow;
+    }
+
+    UGE_FORCE_INLINE void LogArgWriter::Write(LogArgType type, const void *value, UInt32 size)
+    {
+        if (m_overflow || m_size + 1 + size > m_bufferSize)
+        {
+            m_overflow = true;
+            return;
+        }
+
+        m_buffer[m_size] = type;
+        Memcpy(m_buffer + m_size + 1, value, size);
+        m_size += 1 + size;
+    }
+
+    /**
+     * @brief Copies a string into the argument buffer as [type][UInt16 count][chars][terminator].
+     * Strings that don't fit are truncated rather than failing the whole message.
+     */
+    template <typename TChar>
+    inline void LogArgWriter::WriteChars(LogArgType type, const TChar *value, Int32 precision)
+    {
+        const UInt32 headerSize = 1 + sizeof(UInt16);
+        if (m_overflow || m_size + headerSize + sizeof(TChar) > m_bufferSize)
+        {
+            m_overflow = true;
+            return;
+        }
+
+        const UInt32 maxLength = (m_bufferSize - m_size - headerSize) / sizeof(TChar) - 1;
+        UInt32 length = 0;
+        while (length < maxLength && (precision < 0 || length < static_cast<UInt32>(precision)) && value[length] != 0)
+        {
+            ++length;
+        }
+
+        const UInt16 count = static_cast<UInt16>(length + 1);
+        const TChar terminator = 0;
+
+        m_buffer[m_size] = type;
+        Memcpy(m_buffer + m_size + 1, &count, sizeof(count));
+        Memcpy(m_buffer + m_size + headerSize, value, length * sizeof(TChar));
+        Memcpy(m_buffer + m_size + headerSize + length * sizeof(TChar), &terminator, sizeof(TChar));
+        m_size += headerSize + count * sizeof(TChar);
+    }
+}
+
+#endif // __CORESYSTEM_LOGARGS_INL__
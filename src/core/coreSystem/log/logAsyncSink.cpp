@@ -0,0 +1,177 @@
+#include "build.h"
+
+#include "logLine.h"
+#include "logAsyncSink.h"
+
+namespace uge::log
+{
+    const char *c_logAsyncSinkThreadName = "LogSinkThread";
+    const UInt32 c_logAsyncSinkThreadStackSize = 128 * 1024;
+
+    /**
+     * @brief Header of a queued message, followed by the LogLine with its payload and the formatted text.
+     */
+    struct LogAsyncRecord
+    {
+        UInt32 m_size;
+        UInt32 m_textLength;
+    };
+
+    LogAsyncSinkThread::LogAsyncSinkThread(LogAsyncSink *sink)
+        : Thread(c_logAsyncSinkThreadName, c_logAsyncSinkThreadStackSize), m_sink(sink)
+    {
+    }
+
+    void LogAsyncSinkThread::ThreadFunc()
+    {
+        m_sink->Run();
+    }
+
+    /**
+     * @brief Starts the sink's thread.
+     *
+     * @param sink The sink to run on the thread.
+     * @param queueSize The size of the queue between the log thread and the sink's thread.
+     */
+    LogAsyncSink::LogAsyncSink(LogSink *sink, UInt32 queueSize)
+        : m_sink(sink), m_thread(this), m_running(true), m_queue(queueSize), m_queueSize(0), m_flushQueued(false), m_wakeup(0, 1), m_droppedCount(0), m_sinkQueue(queueSize)
+    {
+        UGE_ASSERT(sink != nullptr, "Invalid sink pointer");
+
+        SetFilter(sink->GetLevel(), sink->GetCategoryMask());
+        m_thread.Init();
+    }
+
+    /**
+     * @brief Sinks what's still queued, flushes the wrapped sink and stops the sink's thread.
+     */
+    LogAsyncSink::~LogAsyncSink()
+    {
+        m_running = false;
+        m_wakeup.Release(1);
+        m_thread.Join();
+    }
+
+    void LogAsyncSink::SinkLog(const char *formattedMsg, const LogLine &logLine)
+    {
+        m_queueLock.Lock();
+        Queue(formattedMsg, static_cast<UInt32>(Strlen(formattedMsg)), logLine);
+        m_queueLock.Unlock();
+
+        m_wakeup.Release(1);
+    }
+
+    void LogAsyncSink::SinkLogBatch(const LogBatch &batch)
+    {
+        m_queueLock.Lock();
+        for (UInt32 i = 0; i != batch.m_count; ++i)
+        {
+            Queue(batch.m_entries[i].m_text, batch.m_entries[i].m_length, *batch.m_entries[i].m_logLine);
+        }
+        m_queueLock.Unlock();
+
+        m_wakeup.Release(1);
+    }
+
+    /**
+     * @brief Flushes the wrapped sink on the sink's thread, once the messages queued so far are sunk.
+     */
+    void LogAsyncSink::Flush()
+    {
+        m_queueLock.Lock();
+        m_flushQueued = true;
+        m_queueLock.Unlock();
+
+        m_wakeup.Release(1);
+    }
+
+    /**
+     * @brief Returns the number of messages dropped because the queue was full.
+     */
+    UInt32 LogAsyncSink::GetDroppedCount() const
+    {
+        return atomic::Atomic32::Fetch(const_cast<AtomicInt *>(&m_droppedCount));
+    }
+
+    /**
+     * @brief Copies a message into the queue, called with m_queueLock held.
+     */
+    void LogAsyncSink::Queue(const char *text, UInt32 length, const LogLine &logLine)
+    {
+        const UInt32 lineSize = sizeof(LogLine) + logLine.m_size;
+        const UInt32 recordSize = (sizeof(LogAsyncRecord) + lineSize + length + 7) & ~7u;
+        if (m_queueSize + recordSize > m_queue.size())
+        {
+            atomic::Atomic32::Increment(&m_droppedCount);
+            return;
+        }
+
+        UByte *record = m_queue.data() + m_queueSize;
+        const LogAsyncRecord header = {recordSize, length};
+        Memcpy(record, &header, sizeof(header));
+        Memcpy(record + sizeof(header), &logLine, lineSize);
+        Memcpy(record + sizeof(header) + lineSize, text, length);
+        m_queueSize += recordSize;
+    }
+
+    void LogAsyncSink::Run()
+    {
+        for (;;)
+        {
+            m_wakeup.Acquire();
+            const Bool running = m_running;
+
+            m_queueLock.Lock();
+            m_queue.swap(m_sinkQueue);
+            const UInt32 queueSize = m_queueSize;
+            const Bool flush = m_flushQueued;
+            m_queueSize = 0;
+            m_flushQueued = false;
+            m_queueLock.Unlock();
+
+            SinkQueue(m_sinkQueue.data(), queueSize);
+
+            if (flush || !running)
+            {
+                m_sink->Flush();
+            }
+
+            if (!running)
+            {
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Hands the queued messages to the wrapped sink, in batches with contiguous text.
+     */
+    void LogAsyncSink::SinkQueue(const UByte *queue, UInt32 size)
+    {
+        UInt32 count = 0;
+        UInt32 textLength = 0;
+        for (UInt32 offset = 0; offset != size;)
+        {
+            LogAsyncRecord header;
+            Memcpy(&header, queue + offset, sizeof(header));
+
+            if (count == c_logBatchMax || textLength + header.m_textLength > c_logBatchTextSize)
+            {
+                m_sink->SinkLogBatch(LogBatch{m_batchEntries, count, m_batchText, textLength});
+                count = 0;
+                textLength = 0;
+            }
+
+            const LogLine *logLine = reinterpret_cast<const LogLine *>(queue + offset + sizeof(header));
+            Memcpy(m_batchText + textLength, reinterpret_cast<const char *>(logLine->GetPayload()) + logLine->m_size, header.m_textLength);
+            m_batchEntries[count++] = LogBatchEntry{logLine, m_batchText + textLength, header.m_textLength};
+            textLength += header.m_textLength;
+            offset += header.m_size;
+        }
+
+        if (count != 0)
+        {
+            m_sink->SinkLogBatch(LogBatch{m_batchEntries, count, m_batchText, textLength});
+        }
+    }
+}
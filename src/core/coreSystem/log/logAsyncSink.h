@@ -0,0 +1,71 @@
+#ifndef __CORESYSTEM_LOGASYNCSINK_H__
+#define __CORESYSTEM_LOGASYNCSINK_H__
+
+#include "logSink.h"
+#include <vector>
+
+namespace uge::log
+{
+    const UInt32 c_logAsyncQueueDefaultSize = 1024 * 1024;
+
+    class LogAsyncSink;
+
+    class CORESYSTEM_API LogAsyncSinkThread : public Thread
+    {
+    public:
+        LogAsyncSinkThread(LogAsyncSink *sink);
+
+        virtual void ThreadFunc();
+
+    private:
+        LogAsyncSink *m_sink;
+    };
+
+    /**
+     * @brief Runs another sink on its own thread, so a slow sink doesn't hold up the log thread and
+     * the sinks after it.
+     *
+     * The log thread only copies the messages into a queue of queueSize bytes; the sink's thread swaps
+     * the queue out and hands the messages to the wrapped sink in batches. Messages that don't fit in
+     * a full queue are dropped and counted rather than blocking the log thread. The filter is the
+     * wrapped sink's, and the wrapped sink must outlive this one.
+     */
+    class CORESYSTEM_API LogAsyncSink : public LogSink
+    {
+        friend class LogAsyncSinkThread;
+
+    public:
+        LogAsyncSink(LogSink *sink, UInt32 queueSize = c_logAsyncQueueDefaultSize);
+        virtual ~LogAsyncSink();
+
+        virtual void SinkLog(const char *formattedMsg, const LogLine &logLine);
+        virtual void SinkLogBatch(const LogBatch &batch);
+        virtual void Flush();
+
+        UInt32 GetDroppedCount() const;
+
+    private:
+        void Queue(const char *text, UInt32 length, const LogLine &logLine);
+        void Run();
+        void SinkQueue(const UByte *queue, UInt32 size);
+
+        LogSink *m_sink;
+        LogAsyncSinkThread m_thread;
+        Bool m_running;
+
+        // Filled by the log thread, swapped with m_sinkQueue by the sink's thread.
+        Mutex m_queueLock;
+        std::vector<UByte> m_queue;
+        UInt32 m_queueSize;
+        Bool m_flushQueued;
+        Semaphore m_wakeup;
+        AtomicInt m_droppedCount;
+
+        // Owned by the sink's thread.
+        std::vector<UByte> m_sinkQueue;
+        LogBatchEntry m_batchEntries[c_logBatchMax];
+        char m_batchText[c_logBatchTextSize];
+    };
+}
+
+#endif // __CORESYSTEM_LOGASYNCSINK_H__
@@ -0,0 +1,101 @@
+#include "build.h"
+
+#include "logLine.h"
+#include "logBinaryFileSink.h"
+#include "file/file.h"
+
+namespace uge::log
+{
+    LogBinaryFileSink::LogBinaryFileSink()
+        : m_file(nullptr), m_bufferSize(0)
+    {
+    }
+
+    LogBinaryFileSink::~LogBinaryFileSink()
+    {
+        CloseFile();
+    }
+
+    void LogBinaryFileSink::SinkLog(const char *formattedMsg, const LogLine &logLine)
+    {
+        if (m_file != nullptr)
+        {
+            Encode(logLine);
+            WriteBuffer();
+        }
+    }
+
+    void LogBinaryFileSink::SinkLogBatch(const LogBatch &batch)
+    {
+        if (m_file != nullptr)
+        {
+            for (UInt32 i = 0; i != batch.m_count; ++i)
+            {
+                Encode(*batch.m_entries[i].m_logLine);
+            }
+            WriteBuffer();
+        }
+    }
+
+    void LogBinaryFileSink::Flush()
+    {
+        if (m_file != nullptr)
+        {
+            file::FileFlush(m_file);
+        }
+    }
+
+    /**
+     * @brief Creates the file and writes the header, the dictionaries start empty.
+     */
+    Bool LogBinaryFileSink::OpenFile(const char *filename)
+    {
+        CloseFile();
+
+        if (!file::FileOpen(&m_file, filename, "wb"))
+        {
+            return false;
+        }
+
+        m_encoder.Reset();
+        m_bufferSize = m_encoder.EncodeHeader(m_buffer, sizeof(m_buffer));
+        WriteBuffer();
+        return true;
+    }
+
+    Bool LogBinaryFileSink::CloseFile()
+    {
+        if (m_file != nullptr)
+        {
+            file::FileFlush(m_file);
+            file::FileClose(m_file);
+            m_file = nullptr;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Appends a log line to the staging buffer, writing the buffer out first if it's full.
+     * Lines too large for an empty buffer are dropped.
+     */
+    void LogBinaryFileSink::Encode(const LogLine &logLine)
+    {
+        UInt32 size = m_encoder.Encode(m_buffer + m_bufferSize, sizeof(m_buffer) - m_bufferSize, logLine);
+        if (size == 0 && m_bufferSize != 0)
+        {
+            WriteBuffer();
+            size = m_encoder.Encode(m_buffer, sizeof(m_buffer), logLine);
+        }
+
+        m_bufferSize += size;
+    }
+
+    void LogBinaryFileSink::WriteBuffer()
+    {
+        if (m_bufferSize != 0)
+        {
+            file::FileWrite(m_file, m_buffer, m_bufferSize);
+            m_bufferSize = 0;
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef __CORESYSTEM_LOGBINARYFILESINK_H__
+#define __CORESYSTEM_LOGBINARYFILESINK_H__
+
+#include "logSink.h"
+#include "logBinaryFormat.h"
+#include <stdio.h>
+
+namespace uge::log
+{
+    const UInt32 c_logBinaryBufferSize = 64 * 1024;
+
+    /**
+     * @brief File sink writing the binary log format, see LogBinaryRecordType. Deferred messages are
+     * stored as a format id and their arguments, the formatted text handed to the sink is ignored;
+     * the logDecoder tool turns the file back into text.
+     */
+    class CORESYSTEM_API LogBinaryFileSink : public LogSink
+    {
+    public:
+        LogBinaryFileSink();
+        virtual ~LogBinaryFileSink();
+
+        virtual void SinkLog(const char *formattedMsg, const LogLine &logLine);
+        virtual void SinkLogBatch(const LogBatch &batch);
+        virtual void Flush();
+
+        Bool OpenFile(const char *filename);
+        Bool CloseFile();
+
+    private:
+        void Encode(const LogLine &logLine);
+        void WriteBuffer();
+
+        FILE *m_file;
+        LogBinaryEncoder m_encoder;
+
+        UInt32 m_bufferSize;
+        UByte m_buffer[c_logBinaryBufferSize];
+    };
+}
+
+#endif // __CORESYSTEM_LOGBINARYFILESINK_H__
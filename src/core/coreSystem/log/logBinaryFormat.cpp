@@ -0,0 +1,674 @@
+#include "build.h"
+
+#include "logLine.h"
+#include "logBinaryFormat.h"
+
+namespace uge::log
+{
+    namespace
+    {
+        const UByte c_logBinaryFloatMarker = 0;
+        const UByte c_logBinaryDoubleMarker = 1;
+
+        /**
+         * @brief Appends bytes and varints to a buffer, remembering if anything didn't fit.
+         */
+        class LogBinaryWriter
+        {
+        public:
+            LogBinaryWriter(UByte *buffer, UInt32 bufferSize)
+                : m_buffer(buffer), m_bufferSize(bufferSize), m_size(0), m_overflow(false)
+            {
+            }
+
+            void WriteByte(UByte value)
+            {
+                WriteBytes(&value, 1);
+            }
+
+            void WriteBytes(const void *value, UInt32 size)
+            {
+                if (m_overflow || m_size + size > m_bufferSize)
+                {
+                    m_overflow = true;
+                    return;
+                }
+
+                Memcpy(m_buffer + m_size, value, size);
+                m_size += size;
+            }
+
+            void WriteVarint(UInt64 value)
+            {
+                UByte bytes[10];
+                UInt32 count = 0;
+                while (value >= 0x80)
+                {
+                    bytes[count++] = static_cast<UByte>(value | 0x80);
+                    value >>= 7;
+                }
+                bytes[count++] = static_cast<UByte>(value);
+
+                WriteBytes(bytes, count);
+            }
+
+            void WriteSignedVarint(Int64 value)
+            {
+                WriteVarint((static_cast<UInt64>(value) << 1) ^ static_cast<UInt64>(value >> 63));
+            }
+
+            UInt32 GetSize() const
+            {
+                return m_overflow ? 0 : m_size;
+            }
+
+        private:
+            UByte *m_buffer;
+            UInt32 m_bufferSize;
+            UInt32 m_size;
+            Bool m_overflow;
+        };
+
+        /**
+         * @brief Reads bytes and varints back, failing rather than reading past the end.
+         */
+        class LogBinaryReader
+        {
+        public:
+            LogBinaryReader(const UByte *data, UInt32 size, UInt32 &position)
+                : m_data(data), m_size(size), m_position(position)
+            {
+            }
+
+            Bool ReadByte(UByte &value)
+            {
+                if (m_position >= m_size)
+                {
+                    return false;
+                }
+
+                value = m_data[m_position++];
+                return true;
+            }
+
+            const UByte *ReadBytes(UInt64 size)
+            {
+                if (size > m_size - m_position)
+                {
+                    return nullptr;
+                }
+
+                const UByte *bytes = m_data + m_position;
+                m_position += static_cast<UInt32>(size);
+                return bytes;
+            }
+
+            Bool ReadVarint(UInt64 &value)
+            {
+                value = 0;
+                for (UInt32 shift = 0; shift < 64; shift += 7)
+                {
+                    UByte byte;
+                    if (!ReadByte(byte))
+                    {
+                        return false;
+                    }
+
+                    value |= static_cast<UInt64>(byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0)
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            Bool ReadSignedVarint(Int64 &value)
+            {
+                UInt64 encoded;
+                if (!ReadVarint(encoded))
+                {
+                    return false;
+                }
+
+                value = static_cast<Int64>(encoded >> 1) ^ -static_cast<Int64>(encoded & 1);
+                return true;
+            }
+
+        private:
+            const UByte *m_data;
+            UInt32 m_size;
+            UInt32 &m_position;
+        };
+
+        Int64 GetLogTimeUs(const LogLine &logLine)
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(logLine.m_time.time_since_epoch()).count();
+        }
+
+        /**
+         * @brief Re-encodes the tagged LogArgWriter arguments without their tags, the decoder gets the
+         * types back from the format string.
+         *
+         * @param skipKeys Leaves out every other argument, the keys of a structured message's fields.
+         * @return false if the arguments are malformed.
+         */
+        Bool WriteCompactArgs(LogBinaryWriter &writer, const UByte *args, UInt32 argsSize, Bool skipKeys)
+        {
+            UInt32 position = 0;
+            for (UInt32 argIndex = 0; position < argsSize; ++argIndex)
+            {
+                if (skipKeys && (argIndex & 1) == 0)
+                {
+                    LogArgValue key;
+                    if (!ReadLogArg(args, argsSize, position, key) || key.m_type != LogArgType_String)
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+
+                // The decoder reads unsigned values back as signed ones of the same size, the
+                // format's conversion prints them unsigned again.
+                const LogArgType type = GetLogArgStorageType(static_cast<LogArgType>(args[position++]));
+                switch (type)
+                {
+                case LogArgType_Int32:
+                {
+                    Int32 value;
+                    if (position + sizeof(value) > argsSize)
+                    {
+                        return false;
+                    }
+                    Memcpy(&value, args + position, sizeof(value));
+                    position += sizeof(value);
+                    writer.WriteSignedVarint(value);
+                    break;
+                }
+                case LogArgType_Int64:
+                case LogArgType_Pointer:
+                {
+                    Int64 value;
+                    if (position + sizeof(value) > argsSize)
+                    {
+                        return false;
+                    }
+                    Memcpy(&value, args + position, sizeof(value));
+                    position += sizeof(value);
+                    if (type == LogArgType_Int64)
+                    {
+                        writer.WriteSignedVarint(value);
+                    }
+                    else
+                    {
+                        writer.WriteVarint(static_cast<UInt64>(value));
+                    }
+                    break;
+                }
+                case LogArgType_Double:
+                {
+                    Double value;
+                    if (position + sizeof(value) > argsSize)
+                    {
+                        return false;
+                    }
+                    Memcpy(&value, args + position, sizeof(value));
+                    position += sizeof(value);
+
+                    // Most logged values come from Floats, they fit in half the size without loss.
+                    const Float narrowed = static_cast<Float>(value);
+                    if (static_cast<Double>(narrowed) == value)
+                    {
+                        writer.WriteByte(c_logBinaryFloatMarker);
+                        writer.WriteBytes(&narrowed, sizeof(narrowed));
+                    }
+                    else
+                    {
+                        writer.WriteByte(c_logBinaryDoubleMarker);
+                        writer.WriteBytes(&value, sizeof(value));
+                    }
+                    break;
+                }
+                case LogArgType_String:
+                case LogArgType_WideString:
+                {
+                    const UInt32 charSize = type == LogArgType_String ? sizeof(AnsiChar) : sizeof(UniChar);
+                    UInt16 count;
+                    if (position + sizeof(count) > argsSize)
+                    {
+                        return false;
+                    }
+                    Memcpy(&count, args + position, sizeof(count));
+                    position += sizeof(count);
+                    if (count == 0 || position + count * charSize > argsSize)
+                    {
+                        return false;
+                    }
+
+                    // The terminator isn't stored.
+                    writer.WriteVarint(count - 1);
+                    writer.WriteBytes(args + position, (count - 1) * charSize);
+                    position += count * charSize;
+                    break;
+                }
+                default:
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Reads the compact arguments of a message back into the LogArgWriter encoding, walking
+         * the format string like EncodeLogArgs does.
+         *
+         * @return false if the arguments are malformed or don't match the format.
+         */
+        Bool ReadCompactArgs(LogBinaryReader &reader, LogArgWriter &writer, const char *format)
+        {
+            const char *cursor = Strchr(format, '%');
+            while (cursor != nullptr)
+            {
+                LogFormatSpec spec;
+                if (!ParseLogFormatSpec(cursor, spec))
+                {
+                    return false;
+                }
+
+                const LogArgType types[] = {spec.m_widthArg ? LogArgType_Int32 : LogArgType_None, spec.m_precisionArg ? LogArgType_Int32 : LogArgType_None, spec.m_argType};
+                for (LogArgType type : types)
+                {
+                    switch (type)
+                    {
+                    case LogArgType_Int32:
+                    case LogArgType_Int64:
+                    {
+                        Int64 value;
+                        if (!reader.ReadSignedVarint(value))
+                        {
+                            return false;
+                        }
+
+                        if (type == LogArgType_Int32)
+                        {
+                            writer.WriteInt32(static_cast<Int32>(value));
+                        }
+                        else
+                        {
+                            writer.WriteInt64(value);
+                        }
+                        break;
+                    }
+                    case LogArgType_Pointer:
+                    {
+                        UInt64 value;
+                        if (!reader.ReadVarint(value))
+                        {
+                            return false;
+                        }
+                        writer.WritePointer(reinterpret_cast<const void *>(value));
+                        break;
+                    }
+                    case LogArgType_Double:
+                    {
+                        UByte marker;
+                        if (!reader.ReadByte(marker))
+                        {
+                            return false;
+                        }
+
+                        Double value;
+                        if (marker == c_logBinaryFloatMarker)
+                        {
+                            Float narrowed;
+                            const UByte *bytes = reader.ReadBytes(sizeof(narrowed));
+                            if (bytes == nullptr)
+                            {
+                                return false;
+                            }
+                            Memcpy(&narrowed, bytes, sizeof(narrowed));
+                            value = narrowed;
+                        }
+                        else
+                        {
+                            const UByte *bytes = reader.ReadBytes(sizeof(value));
+                            if (bytes == nullptr)
+                            {
+                                return false;
+                            }
+                            Memcpy(&value, bytes, sizeof(value));
+                        }
+                        writer.WriteDouble(value);
+                        break;
+                    }
+                    case LogArgType_String:
+                    case LogArgType_WideString:
+                    {
+                        const UInt32 charSize = type == LogArgType_String ? sizeof(AnsiChar) : sizeof(UniChar);
+                        UInt64 length;
+                        const UByte *chars = reader.ReadVarint(length) && length < c_logLineBufferSize ? reader.ReadBytes(length * charSize) : nullptr;
+                        if (chars == nullptr)
+                        {
+                            return false;
+                        }
+
+                        // Copied out so the characters are terminated and aligned.
+                        if (type == LogArgType_String)
+                        {
+                            AnsiChar value[c_logLineBufferSize];
+                            Memcpy(value, chars, static_cast<UInt32>(length));
+                            value[length] = '\0';
+                            writer.WriteString(value);
+                        }
+                        else
+                        {
+                            UniChar value[c_logLineBufferSize];
+                            Memcpy(value, chars, static_cast<UInt32>(length * charSize));
+                            value[length] = 0;
+                            writer.WriteString(value);
+                        }
+                        break;
+                    }
+                    default:
+                        break;
+                    }
+                }
+
+                cursor = Strchr(spec.m_end, '%');
+            }
+
+            return !writer.HasOverflowed();
+        }
+    }
+
+    LogBinaryEncoder::LogBinaryEncoder()
+        : m_formatCount(0), m_lastTime(0)
+    {
+    }
+
+    /**
+     * @brief Forgets the dictionaries, for a new file starting with EncodeHeader.
+     */
+    void LogBinaryEncoder::Reset()
+    {
+        m_formatIds.clear();
+        m_fieldsFormatIds.clear();
+        m_formatCount = 0;
+        m_threadIndexes.clear();
+        m_lastTime = 0;
+    }
+
+    /**
+     * @brief Writes the file header.
+     *
+     * @return The number of bytes written, 0 if the buffer is too small.
+     */
+    UInt32 LogBinaryEncoder::EncodeHeader(UByte *buffer, UInt32 bufferSize) const
+    {
+        LogBinaryWriter writer(buffer, bufferSize);
+        writer.WriteBytes(c_logBinaryMagic, sizeof(c_logBinaryMagic));
+        writer.WriteBytes(&c_logBinaryVersion, sizeof(c_logBinaryVersion));
+        return writer.GetSize();
+    }
+
+    /**
+     * @brief Encodes a log line, preceded by the dictionary records of its call site and thread if
+     * they weren't written yet.
+     *
+     * @param buffer The buffer receiving the records.
+     * @param bufferSize The size of the buffer.
+     * @param logLine The log line to encode.
+     * @return The number of bytes written, 0 if the buffer is too small or the line is malformed, in
+     * which case the encoder is left untouched.
+     */
+    UInt32 LogBinaryEncoder::Encode(UByte *buffer, UInt32 bufferSize, const LogLine &logLine)
+    {
+        LogBinaryWriter writer(buffer, bufferSize);
+        const UInt32 levelCategory = (static_cast<UInt32>(logLine.m_category) << 3) | logLine.m_level;
+
+        // Structured messages get a format holding their message and keys, see BuildLogFieldsFormat.
+        const Bool fields = logLine.m_type == LogLineType_Fields;
+        char fieldsFormat[c_logFormattedLineSize];
+        const char *format = logLine.m_format;
+        const FormatId *knownFormat = nullptr;
+        if (fields)
+        {
+            if (BuildLogFieldsFormat(fieldsFormat, sizeof(fieldsFormat), logLine.m_format, reinterpret_cast<const UByte *>(logLine.GetPayload()), logLine.m_size) == 0)
+            {
+                return 0;
+            }
+
+            format = fieldsFormat;
+            const auto known = m_fieldsFormatIds.find(std::string_view(fieldsFormat));
+            knownFormat = known != m_fieldsFormatIds.end() ? &known->second : nullptr;
+        }
+        else if (format != nullptr)
+        {
+            const auto known = m_formatIds.find(format);
+            knownFormat = known != m_formatIds.end() ? &known->second : nullptr;
+        }
+
+        // A format string logged with another level or category gets a new call site record.
+        Bool newFormat = false;
+        FormatId formatId = {m_formatCount, levelCategory};
+        if (format != nullptr)
+        {
+            newFormat = knownFormat == nullptr || knownFormat->m_levelCategory != levelCategory;
+            if (newFormat)
+            {
+                const UInt32 length = static_cast<UInt32>(Strlen(format)) + 1;
+                writer.WriteVarint(LogBinaryRecord_Format);
+                writer.WriteVarint(levelCategory);
+                writer.WriteVarint(length);
+                writer.WriteBytes(format, length);
+            }
+            else
+            {
+                formatId = *knownFormat;
+            }
+        }
+
+        const auto thread = m_threadIndexes.find(logLine.m_threadId);
+        const Bool newThread = thread == m_threadIndexes.end();
+        const UInt32 threadIndex = newThread ? static_cast<UInt32>(m_threadIndexes.size()) : thread->second;
+        if (newThread)
+        {
+            writer.WriteVarint(LogBinaryRecord_Thread);
+            writer.WriteVarint(logLine.m_threadId);
+        }
+
+        const Int64 time = GetLogTimeUs(logLine);
+        if (format != nullptr)
+        {
+            writer.WriteVarint((static_cast<UInt64>(formatId.m_id) << 2) | LogBinaryRecord_Message);
+            writer.WriteSignedVarint(time - m_lastTime);
+            writer.WriteVarint(threadIndex);
+            if (!WriteCompactArgs(writer, reinterpret_cast<const UByte *>(logLine.GetPayload()), logLine.m_size, fields))
+            {
+                return 0;
+            }
+        }
+        else
+        {
+            const UInt32 length = static_cast<UInt32>(Strnlen(logLine.GetPayload(), logLine.m_size));
+            writer.WriteVarint(LogBinaryRecord_Text);
+            writer.WriteSignedVarint(time - m_lastTime);
+            writer.WriteVarint(threadIndex);
+            writer.WriteVarint(levelCategory);
+            writer.WriteVarint(length);
+            writer.WriteBytes(logLine.GetPayload(), length);
+        }
+
+        const UInt32 size = writer.GetSize();
+        if (size != 0)
+        {
+            if (newFormat)
+            {
+                if (fields)
+                {
+                    m_fieldsFormatIds.insert_or_assign(std::string(format), formatId);
+                }
+                else
+                {
+                    m_formatIds[format] = formatId;
+                }
+                ++m_formatCount;
+            }
+
+            if (newThread)
+            {
+                m_threadIndexes.emplace(logLine.m_threadId, threadIndex);
+            }
+
+            m_lastTime = time;
+        }
+
+        return size;
+    }
+
+    /**
+     * @brief Starts decoding a binary log file held in memory, data must outlive the decoder.
+     */
+    LogBinaryDecoder::LogBinaryDecoder(const UByte *data, UInt32 size)
+        : m_data(data), m_size(size), m_position(c_logBinaryHeaderSize), m_valid(false), m_lastTime(0)
+    {
+        UInt32 version = 0;
+        if (size >= c_logBinaryHeaderSize && Memcmp(data, c_logBinaryMagic, sizeof(c_logBinaryMagic)) == 0)
+        {
+            Memcpy(&version, data + sizeof(c_logBinaryMagic), sizeof(version));
+        }
+
+        m_valid = version == c_logBinaryVersion;
+    }
+
+    /**
+     * @brief Returns false if the header is wrong or a malformed record was met.
+     */
+    Bool LogBinaryDecoder::IsValid() const
+    {
+        return m_valid;
+    }
+
+    Bool LogBinaryDecoder::IsAtEnd() const
+    {
+        return !m_valid || m_position >= m_size;
+    }
+
+    /**
+     * @brief Decodes the next message and formats it like FormatLogMessage.
+     *
+     * @param buffer The buffer receiving the formatted, null terminated line.
+     * @param bufferSize The size of the buffer.
+     * @param length Receives the length of the formatted line.
+     * @param precision Sub-second digits of the timestamp.
+     * @return false at the end of the data or on a malformed record, see IsValid.
+     */
+    Bool LogBinaryDecoder::DecodeNext(char *buffer, UInt32 bufferSize, UInt32 &length, LogTimestampPrecision precision)
+    {
+        UGE_ALIGNED_VAR(UByte, 8) record[sizeof(LogLine) + c_logLineBufferSize];
+        LogBinaryReader reader(m_data, m_size, m_position);
+
+        while (!IsAtEnd())
+        {
+            UInt64 tag;
+            UInt64 levelCategory;
+            m_valid = reader.ReadVarint(tag);
+            if (!m_valid)
+            {
+                break;
+            }
+
+            const LogBinaryRecordType type = static_cast<LogBinaryRecordType>(tag & 3);
+            if (type == LogBinaryRecord_Format)
+            {
+                UInt64 size;
+                const UByte *format = reader.ReadVarint(levelCategory) && reader.ReadVarint(size) && size != 0 ? reader.ReadBytes(size) : nullptr;
+                m_valid = format != nullptr && format[size - 1] == '\0';
+                if (m_valid)
+                {
+                    m_formats.push_back(Format{reinterpret_cast<const char *>(format), static_cast<UInt32>(levelCategory)});
+                }
+                continue;
+            }
+
+            if (type == LogBinaryRecord_Thread)
+            {
+                UInt64 threadId;
+                m_valid = reader.ReadVarint(threadId);
+                if (m_valid)
+                {
+                    m_threadIds.push_back(static_cast<UInt32>(threadId));
+                }
+                continue;
+            }
+
+            const UInt64 formatId = tag >> 2;
+            Int64 timeDelta;
+            UInt64 threadIndex;
+            m_valid = reader.ReadSignedVarint(timeDelta) && reader.ReadVarint(threadIndex) && threadIndex < m_threadIds.size();
+            if (m_valid)
+            {
+                if (type == LogBinaryRecord_Message)
+                {
+                    m_valid = formatId < m_formats.size();
+                    levelCategory = m_valid ? m_formats[static_cast<size_t>(formatId)].m_levelCategory : 0;
+                }
+                else
+                {
+                    m_valid = reader.ReadVarint(levelCategory);
+                }
+            }
+
+            m_valid = m_valid && (levelCategory >> 3) < LogCategory_MAX && (levelCategory & 7) <= LogLevel_Trace;
+            if (!m_valid)
+            {
+                break;
+            }
+
+            m_lastTime += timeDelta;
+
+            LogLine *logLine = reinterpret_cast<LogLine *>(record);
+            *logLine = LogLine{
+                0,
+                std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(m_lastTime))),
+                m_threadIds[static_cast<size_t>(threadIndex)],
+                LogLineType_Log,
+                static_cast<LogLevel>(levelCategory & 7),
+                static_cast<LogCategory>(levelCategory >> 3),
+                nullptr};
+
+            if (type == LogBinaryRecord_Message)
+            {
+                logLine->m_format = m_formats[static_cast<size_t>(formatId)].m_format;
+
+                LogArgWriter writer(reinterpret_cast<UByte *>(logLine->GetPayload()), c_logLineBufferSize);
+                m_valid = ReadCompactArgs(reader, writer, logLine->m_format);
+                logLine->m_size = writer.GetSize();
+            }
+            else
+            {
+                UInt64 textLength;
+                const UByte *text = reader.ReadVarint(textLength) && textLength < c_logLineBufferSize ? reader.ReadBytes(textLength) : nullptr;
+                m_valid = text != nullptr;
+                if (m_valid)
+                {
+                    Memcpy(logLine->GetPayload(), text, static_cast<UInt32>(textLength));
+                    logLine->GetPayload()[textLength] = '\0';
+                    logLine->m_size = static_cast<UInt32>(textLength) + 1;
+                }
+            }
+
+            if (!m_valid)
+            {
+                break;
+            }
+
+            length = FormatLogMessage(buffer, bufferSize, *logLine, precision);
+            return true;
+        }
+
+        return false;
+    }
+}
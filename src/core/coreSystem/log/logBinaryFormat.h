@@ -0,0 +1,108 @@
+#ifndef __CORESYSTEM_LOGBINARYFORMAT_H__
+#define __CORESYSTEM_LOGBINARYFORMAT_H__
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace uge::log
+{
+    /**
+     * @brief Binary log files start with c_logBinaryMagic and c_logBinaryVersion, then hold a
+     * sequence of records. Integers are LEB128 varints, signed ones zigzag encoded. Every record
+     * starts with a tag, (id << 2) | LogBinaryRecordType, the id being the format id of messages.
+     *
+     * Format and thread records extend the dictionaries, their ids are implicit and sequential. A
+     * format record stands for a call site: [category << 3 | level][length][format, terminated].
+     * Message records only reference them: [tag][time delta in us][thread index][arguments]. The
+     * arguments aren't tagged, their types come from the format string: integers and pointers are
+     * varints, doubles are a marker byte followed by a Float when it's exact or a Double, strings are
+     * their length followed by their characters.
+     * Text records hold already formatted messages: [tag][time delta][thread][category << 3 | level][length][text].
+     * Structured messages are stored as message records too, their call site format being built by
+     * BuildLogFieldsFormat: the message and the keys are in the format, only the values are in
+     * the message records.
+     */
+    enum LogBinaryRecordType : UByte
+    {
+        LogBinaryRecord_Format,
+        LogBinaryRecord_Thread,
+        LogBinaryRecord_Message,
+        LogBinaryRecord_Text
+    };
+
+    const char c_logBinaryMagic[8] = {'U', 'G', 'E', 'B', 'L', 'O', 'G', '\0'};
+    const UInt32 c_logBinaryVersion = 1;
+    const UInt32 c_logBinaryHeaderSize = sizeof(c_logBinaryMagic) + sizeof(UInt32);
+
+    /**
+     * @brief Encodes log lines into the binary log format, writing the dictionary records the first
+     * time a format string or a thread is seen.
+     */
+    class CORESYSTEM_API LogBinaryEncoder
+    {
+    public:
+        LogBinaryEncoder();
+
+        void Reset();
+        UInt32 EncodeHeader(UByte *buffer, UInt32 bufferSize) const;
+        UInt32 Encode(UByte *buffer, UInt32 bufferSize, const LogLine &logLine);
+
+    private:
+        struct FormatId
+        {
+            UInt32 m_id;
+            UInt32 m_levelCategory;
+        };
+
+        struct FieldsFormatHash
+        {
+            using is_transparent = void;
+
+            size_t operator()(std::string_view format) const
+            {
+                return std::hash<std::string_view>()(format);
+            }
+        };
+
+        // The last format record written for each format string, and for each format built for
+        // structured messages.
+        std::unordered_map<const char *, FormatId> m_formatIds;
+        std::unordered_map<std::string, FormatId, FieldsFormatHash, std::equal_to<>> m_fieldsFormatIds;
+        UInt32 m_formatCount;
+        std::unordered_map<UInt32, UInt32> m_threadIndexes;
+        Int64 m_lastTime;
+    };
+
+    /**
+     * @brief Reads a binary log file back, formatting each message like FormatLogMessage.
+     */
+    class CORESYSTEM_API LogBinaryDecoder
+    {
+    public:
+        LogBinaryDecoder(const UByte *data, UInt32 size);
+
+        Bool IsValid() const;
+        Bool IsAtEnd() const;
+        Bool DecodeNext(char *buffer, UInt32 bufferSize, UInt32 &length, LogTimestampPrecision precision = LogTimestamp_Milliseconds);
+
+    private:
+        const UByte *m_data;
+        UInt32 m_size;
+        UInt32 m_position;
+        Bool m_valid;
+
+        struct Format
+        {
+            const char *m_format;
+            UInt32 m_levelCategory;
+        };
+
+        std::vector<Format> m_formats;
+        std::vector<UInt32> m_threadIds;
+        Int64 m_lastTime;
+    };
+}
+
+#endif // __CORESYSTEM_LOGBINARYFORMAT_H__
@@ -0,0 +1,223 @@
+#include "build.h"
+
+#include "logLine.h"
+#include "logCompressedFileSink.h"
+#include "compression/lzCompression.h"
+#include "file/file.h"
+
+namespace uge::log
+{
+    /**
+     * @brief FNV-1a checksum of a block's stored data, catching blocks torn or zero filled by a crash.
+     */
+    UInt32 GetLogBlockChecksum(const UByte *data, UInt32 size)
+    {
+        UInt32 checksum = 2166136261u;
+        for (UInt32 i = 0; i != size; ++i)
+        {
+            checksum = (checksum ^ data[i]) * 16777619u;
+        }
+        return checksum;
+    }
+
+    LogCompressedFileSink::LogCompressedFileSink()
+        : m_file(nullptr), m_blockLength(0)
+    {
+    }
+
+    LogCompressedFileSink::~LogCompressedFileSink()
+    {
+        CloseFile();
+    }
+
+    void LogCompressedFileSink::SinkLog(const char *formattedMsg, const LogLine &logLine)
+    {
+        Write(formattedMsg, static_cast<UInt32>(Strlen(formattedMsg)));
+    }
+
+    void LogCompressedFileSink::SinkLogBatch(const LogBatch &batch)
+    {
+        if (m_file != nullptr && m_blockLength + batch.m_textLength <= m_block.size())
+        {
+            Memcpy(m_block.data() + m_blockLength, batch.m_text, batch.m_textLength);
+            m_blockLength += batch.m_textLength;
+            return;
+        }
+
+        // The batch straddles blocks, write it line by line so lines aren't split across blocks.
+        for (UInt32 i = 0; i != batch.m_count; ++i)
+        {
+            Write(batch.m_entries[i].m_text, batch.m_entries[i].m_length);
+        }
+    }
+
+    void LogCompressedFileSink::Flush()
+    {
+        if (m_file != nullptr)
+        {
+            WriteBlock();
+            file::FileFlush(m_file);
+        }
+    }
+
+    /**
+     * @brief Creates the file and writes its header.
+     *
+     * @param filename The file to create.
+     * @param blockSize The amount of text compressed at once, larger blocks compress better.
+     * @return true if the file could be created.
+     */
+    Bool LogCompressedFileSink::OpenFile(const char *filename, UInt32 blockSize)
+    {
+        UGE_ASSERT(blockSize != 0 && blockSize <= c_logCompressedBlockMaxSize, "Invalid block size");
+
+        CloseFile();
+
+        if (!file::FileOpen(&m_file, filename, "wb"))
+        {
+            return false;
+        }
+
+        m_block.resize(blockSize);
+        m_compressedBlock.resize(compression::LzCompressBound(blockSize));
+        m_blockLength = 0;
+
+        file::FileWrite(m_file, c_logCompressedMagic, sizeof(c_logCompressedMagic));
+        file::FileWrite(m_file, &c_logCompressedVersion, sizeof(c_logCompressedVersion));
+        return true;
+    }
+
+    Bool LogCompressedFileSink::CloseFile()
+    {
+        if (m_file != nullptr)
+        {
+            Flush();
+            file::FileClose(m_file);
+            m_file = nullptr;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Appends text to the current block, writing the block out before a line that doesn't fit.
+     * Only lines longer than a whole block are split.
+     */
+    void LogCompressedFileSink::Write(const char *text, UInt32 length)
+    {
+        if (m_file == nullptr)
+        {
+            return;
+        }
+
+        const UInt32 blockSize = static_cast<UInt32>(m_block.size());
+        while (length != 0)
+        {
+            if (m_blockLength + length > blockSize && m_blockLength != 0)
+            {
+                WriteBlock();
+            }
+
+            const UInt32 copyLength = std::min(length, blockSize - m_blockLength);
+            Memcpy(m_block.data() + m_blockLength, text, copyLength);
+            m_blockLength += copyLength;
+            text += copyLength;
+            length -= copyLength;
+        }
+    }
+
+    void LogCompressedFileSink::WriteBlock()
+    {
+        if (m_blockLength == 0)
+        {
+            return;
+        }
+
+        const UInt32 compressedSize = compression::LzCompress(m_block.data(), m_blockLength, m_compressedBlock.data(), m_blockLength - 1);
+        const Bool stored = compressedSize == 0;
+        const UByte *data = stored ? m_block.data() : m_compressedBlock.data();
+
+        LogCompressedBlockHeader header;
+        header.m_marker = c_logCompressedBlockMarker;
+        header.m_rawSize = m_blockLength;
+        header.m_storedSize = stored ? m_blockLength : compressedSize;
+        header.m_checksum = GetLogBlockChecksum(data, header.m_storedSize);
+
+        file::FileWrite(m_file, &header, sizeof(header));
+        file::FileWrite(m_file, data, header.m_storedSize);
+        m_blockLength = 0;
+    }
+
+    /**
+     * @brief Starts decoding a compressed log file held in memory, data must outlive the decoder.
+     */
+    LogCompressedDecoder::LogCompressedDecoder(const UByte *data, UInt32 size)
+        : m_data(data), m_size(size), m_position(c_logCompressedHeaderSize), m_valid(false)
+    {
+        UInt32 version = 0;
+        if (size >= c_logCompressedHeaderSize && Memcmp(data, c_logCompressedMagic, sizeof(c_logCompressedMagic)) == 0)
+        {
+            Memcpy(&version, data + sizeof(c_logCompressedMagic), sizeof(version));
+        }
+
+        m_valid = version == c_logCompressedVersion;
+    }
+
+    /**
+     * @brief Returns false if the header is wrong or a truncated or corrupted block was met.
+     */
+    Bool LogCompressedDecoder::IsValid() const
+    {
+        return m_valid;
+    }
+
+    Bool LogCompressedDecoder::IsAtEnd() const
+    {
+        return !m_valid || m_position >= m_size;
+    }
+
+    /**
+     * @brief Decodes the next block.
+     *
+     * @param buffer The buffer receiving the text, c_logCompressedBlockMaxSize always fits.
+     * @param bufferSize The size of the buffer.
+     * @param length Receives the length of the text.
+     * @return false at the end of the data or on a truncated or corrupted block, see IsValid.
+     */
+    Bool LogCompressedDecoder::DecodeNextBlock(UByte *buffer, UInt32 bufferSize, UInt32 &length)
+    {
+        if (IsAtEnd())
+        {
+            return false;
+        }
+
+        LogCompressedBlockHeader header;
+        m_valid = m_size - m_position >= sizeof(header);
+        if (m_valid)
+        {
+            Memcpy(&header, m_data + m_position, sizeof(header));
+            m_position += sizeof(header);
+            m_valid = header.m_marker == c_logCompressedBlockMarker && header.m_rawSize <= bufferSize && header.m_storedSize <= header.m_rawSize && header.m_storedSize <= m_size - m_position;
+        }
+
+        const UByte *data = m_data + m_position;
+        m_valid = m_valid && GetLogBlockChecksum(data, header.m_storedSize) == header.m_checksum;
+        if (!m_valid)
+        {
+            return false;
+        }
+
+        if (header.m_storedSize == header.m_rawSize)
+        {
+            Memcpy(buffer, data, header.m_rawSize);
+            length = header.m_rawSize;
+        }
+        else
+        {
+            length = compression::LzDecompress(data, header.m_storedSize, buffer, header.m_rawSize);
+            m_valid = length == header.m_rawSize;
+        }
+
+        m_position += header.m_storedSize;
+        return m_valid;
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef __CORESYSTEM_LOGCOMPRESSEDFILESINK_H__
+#define __CORESYSTEM_LOGCOMPRESSEDFILESINK_H__
+
+#include "logSink.h"
+#include <stdio.h>
+#include <vector>
+
+namespace uge::log
+{
+    /**
+     * @brief Compressed log files start with c_logCompressedMagic and c_logCompressedVersion, then
+     * hold blocks of formatted text, each a LogCompressedBlockHeader followed by the block data.
+     * Blocks are compressed on their own, so every complete block of a file cut short by a crash
+     * still decodes. A block compression doesn't shrink is stored as is, m_storedSize == m_rawSize.
+     */
+    struct LogCompressedBlockHeader
+    {
+        UInt32 m_marker;
+        UInt32 m_rawSize;
+        UInt32 m_storedSize;
+        UInt32 m_checksum;
+    };
+
+    const char c_logCompressedMagic[8] = {'U', 'G', 'E', 'L', 'Z', 'L', 'O', 'G'};
+    const UInt32 c_logCompressedVersion = 1;
+    const UInt32 c_logCompressedHeaderSize = sizeof(c_logCompressedMagic) + sizeof(UInt32);
+    const UInt32 c_logCompressedBlockMarker = 0x4B4C4247; // "GBLK"
+    const UInt32 c_logCompressedBlockDefaultSize = 256 * 1024;
+    const UInt32 c_logCompressedBlockMaxSize = 16 * 1024 * 1024;
+
+    CORESYSTEM_API UInt32 GetLogBlockChecksum(const UByte *data, UInt32 size);
+
+    /**
+     * @brief File sink accumulating formatted lines into blocks of blockSize bytes, compressed with
+     * the LZ codec on the log thread as they fill up. Flush compresses and writes the partial block,
+     * frequent flushes mean smaller blocks and a worse ratio.
+     */
+    class CORESYSTEM_API LogCompressedFileSink : public LogSink
+    {
+    public:
+        LogCompressedFileSink();
+        virtual ~LogCompressedFileSink();
+
+        virtual void SinkLog(const char *formattedMsg, const LogLine &logLine);
+        virtual void SinkLogBatch(const LogBatch &batch);
+        virtual void Flush();
+
+        Bool OpenFile(const char *filename, UInt32 blockSize = c_logCompressedBlockDefaultSize);
+        Bool CloseFile();
+
+    private:
+        void Write(const char *text, UInt32 length);
+        void WriteBlock();
+
+        FILE *m_file;
+        UInt32 m_blockLength;
+        std::vector<UByte> m_block;
+        std::vector<UByte> m_compressedBlock;
+    };
+
+    /**
+     * @brief Reads a compressed log file back block by block.
+     */
+    class CORESYSTEM_API LogCompressedDecoder
+    {
+    public:
+        LogCompressedDecoder(const UByte *data, UInt32 size);
+
+        Bool IsValid() const;
+        Bool IsAtEnd() const;
+        Bool DecodeNextBlock(UByte *buffer, UInt32 bufferSize, UInt32 &length);
+
+    private:
+        const UByte *m_data;
+        UInt32 m_size;
+        UInt32 m_position;
+        Bool m_valid;
+    };
+}
+
+#endif // __CORESYSTEM_LOGCOMPRESSEDFILESINK_H__
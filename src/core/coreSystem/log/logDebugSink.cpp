@@ -1,6 +1,6 @@
 #include "build.h"
 
-#include "logQueue.h"
+#include "logLine.h"
 #include "logDebugSink.h"
 
 namespace uge::log
@@ -15,7 +15,7 @@ namespace uge::log
 
     void LogDebugSink::SinkLog(const char *formattedMsg, const LogLine &logLine)
     {
-        ::OutputDebugStringA(formattedMsg);
+        dbg::DebugOutput(formattedMsg);
     }
 
     void LogDebugSink::Flush()
@@ -0,0 +1,449 @@
+#include "build.h"
+
+#include <charconv>
+#include <cmath>
+
+#include "logLine.h"
+#include "logFields.h"
+
+namespace uge::log
+{
+    namespace
+    {
+        /**
+         * @brief Appends text to a null terminated buffer. An append that doesn't fit writes nothing
+         * and marks the builder as overflowed, Rewind goes back to a previous length.
+         */
+        class LogTextBuilder
+        {
+        public:
+            LogTextBuilder(char *buffer, UInt32 bufferSize)
+                : m_buffer(buffer), m_limit(bufferSize != 0 ? bufferSize - 1 : 0), m_length(0), m_overflow(bufferSize == 0)
+            {
+                if (bufferSize != 0)
+                {
+                    m_buffer[0] = '\0';
+                }
+            }
+
+            void Append(const char *text, UInt32 length)
+            {
+                if (m_overflow || m_length + length > m_limit)
+                {
+                    m_overflow = true;
+                    return;
+                }
+
+                Memcpy(m_buffer + m_length, text, length);
+                m_length += length;
+                m_buffer[m_length] = '\0';
+            }
+
+            void Append(char value)
+            {
+                Append(&value, 1);
+            }
+
+            void AppendFormat(const char *format, ...)
+            {
+                if (m_overflow)
+                {
+                    return;
+                }
+
+                va_list argList;
+                va_start(argList, format);
+                const Int32 written = Vsnprintf(m_buffer + m_length, m_limit - m_length + 1, format, argList);
+                va_end(argList);
+
+                if (written < 0 || m_length + written > m_limit)
+                {
+                    m_buffer[m_length] = '\0';
+                    m_overflow = true;
+                    return;
+                }
+
+                m_length += written;
+            }
+
+            template <typename T>
+            void AppendNumber(T value)
+            {
+                char digits[32];
+                const std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+                Append(digits, static_cast<UInt32>(result.ptr - digits));
+            }
+
+            /**
+             * @brief Keeps the last count characters of the buffer for a later append.
+             */
+            void Reserve(UInt32 count)
+            {
+                m_limit -= count;
+            }
+
+            void Release(UInt32 count)
+            {
+                m_limit += count;
+            }
+
+            void Rewind(UInt32 length)
+            {
+                m_length = length;
+                m_buffer[m_length] = '\0';
+                m_overflow = false;
+            }
+
+            UInt32 GetLength() const
+            {
+                return m_length;
+            }
+
+            Bool HasOverflowed() const
+            {
+                return m_overflow;
+            }
+
+        private:
+            char *m_buffer;
+            UInt32 m_limit;
+            UInt32 m_length;
+            Bool m_overflow;
+        };
+
+        /**
+         * @brief Returns the printf conversion a field value is rendered with in text, the binary
+         * format relies on the same conversions to render the fields identically once decoded.
+         */
+        const char *GetLogFieldConversion(LogArgType type)
+        {
+            switch (type)
+            {
+            case LogArgType_Int32:
+                return "%d";
+            case LogArgType_Int64:
+                return "%lld";
+            case LogArgType_UInt32:
+                return "%u";
+            case LogArgType_UInt64:
+                return "%llu";
+            case LogArgType_Double:
+                return "%g";
+            case LogArgType_Pointer:
+                return "%p";
+            case LogArgType_String:
+                return "\"%s\"";
+            case LogArgType_WideString:
+                return "\"%ls\"";
+            default:
+                return nullptr;
+            }
+        }
+
+        void AppendFieldValue(LogTextBuilder &builder, const LogArgValue &value)
+        {
+            const char *conversion = GetLogFieldConversion(value.m_type);
+            switch (value.m_type)
+            {
+            case LogArgType_Int32:
+                builder.AppendFormat(conversion, value.m_int32);
+                break;
+            case LogArgType_Int64:
+                builder.AppendFormat(conversion, value.m_int64);
+                break;
+            case LogArgType_UInt32:
+                builder.AppendFormat(conversion, value.m_uint32);
+                break;
+            case LogArgType_UInt64:
+                builder.AppendFormat(conversion, value.m_uint64);
+                break;
+            case LogArgType_Double:
+                builder.AppendFormat(conversion, value.m_double);
+                break;
+            case LogArgType_Pointer:
+                builder.AppendFormat(conversion, reinterpret_cast<const void *>(value.m_pointer));
+                break;
+            case LogArgType_String:
+                builder.AppendFormat(conversion, value.m_string);
+                break;
+            case LogArgType_WideString:
+                builder.AppendFormat(conversion, value.m_wideString);
+                break;
+            default:
+                break;
+            }
+        }
+
+        /**
+         * @brief Appends text to a printf format, doubling its '%' so it's printed as is.
+         */
+        void AppendFormatLiteral(LogTextBuilder &builder, const char *text, UInt32 length)
+        {
+            while (length != 0)
+            {
+                const char *percent = static_cast<const char *>(memchr(text, '%', length));
+                const UInt32 literalLength = percent != nullptr ? static_cast<UInt32>(percent - text) + 1 : length;
+                builder.Append(text, literalLength);
+                if (percent != nullptr)
+                {
+                    builder.Append('%');
+                }
+
+                text += literalLength;
+                length -= literalLength;
+            }
+        }
+
+        /**
+         * @brief Appends a quoted JSON string, truncating the text rather than the closing quote.
+         */
+        template <typename TChar>
+        void AppendJsonString(LogTextBuilder &builder, const TChar *text, UInt32 length)
+        {
+            builder.Append('"');
+            if (builder.HasOverflowed())
+            {
+                return;
+            }
+
+            builder.Reserve(1);
+
+            for (UInt32 i = 0; i != length && !builder.HasOverflowed(); ++i)
+            {
+                const UInt32 previousLength = builder.GetLength();
+                const UInt32 character = static_cast<std::make_unsigned_t<TChar>>(text[i]);
+                switch (character)
+                {
+                case '"':
+                    builder.Append("\\\"", 2);
+                    break;
+                case '\\':
+                    builder.Append("\\\\", 2);
+                    break;
+                case '\n':
+                    builder.Append("\\n", 2);
+                    break;
+                case '\r':
+                    builder.Append("\\r", 2);
+                    break;
+                case '\t':
+                    builder.Append("\\t", 2);
+                    break;
+                default:
+                    // Narrow strings are expected to be UTF-8 and are copied as is, wide ones are escaped.
+                    if (character < 0x20 || (sizeof(TChar) != 1 && character >= 0x80))
+                    {
+                        builder.AppendFormat("\\u%04x", character & 0xFFFF);
+                    }
+                    else
+                    {
+                        builder.Append(static_cast<char>(character));
+                    }
+                    break;
+                }
+
+                if (builder.HasOverflowed())
+                {
+                    builder.Rewind(previousLength);
+                    break;
+                }
+            }
+
+            builder.Release(1);
+            builder.Append('"');
+        }
+
+        void AppendJsonValue(LogTextBuilder &builder, const LogArgValue &value)
+        {
+            switch (value.m_type)
+            {
+            case LogArgType_Int32:
+                builder.AppendNumber(value.m_int32);
+                break;
+            case LogArgType_Int64:
+                builder.AppendNumber(value.m_int64);
+                break;
+            case LogArgType_UInt32:
+                builder.AppendNumber(value.m_uint32);
+                break;
+            case LogArgType_UInt64:
+                builder.AppendNumber(value.m_uint64);
+                break;
+            case LogArgType_Double:
+                // JSON has no representation for infinities and NaNs.
+                if (std::isfinite(value.m_double))
+                {
+                    builder.AppendNumber(value.m_double);
+                }
+                else
+                {
+                    builder.Append("null", 4);
+                }
+                break;
+            case LogArgType_Pointer:
+                builder.AppendFormat("\"%p\"", reinterpret_cast<const void *>(value.m_pointer));
+                break;
+            case LogArgType_String:
+                AppendJsonString(builder, value.m_string, value.m_length);
+                break;
+            case LogArgType_WideString:
+                AppendJsonString(builder, value.m_wideString, value.m_length);
+                break;
+            default:
+                break;
+            }
+        }
+
+        /**
+         * @brief Reads the next key/value pair of a structured message's fields.
+         *
+         * @return false at the end of the fields or if they are malformed.
+         */
+        Bool ReadLogField(const UByte *fields, UInt32 fieldsSize, UInt32 &position, LogArgValue &key, LogArgValue &value)
+        {
+            return ReadLogArg(fields, fieldsSize, position, key) && key.m_type == LogArgType_String && ReadLogArg(fields, fieldsSize, position, value);
+        }
+    }
+
+    /**
+     * @brief Formats a structured message as text: the message followed by " key=value" for each
+     * field. Fields that don't fit are left out whole.
+     *
+     * @param buffer The buffer receiving the formatted, null terminated text.
+     * @param bufferSize The size of the buffer.
+     * @param message The message of the structured log line.
+     * @param fields The encoded fields.
+     * @param fieldsSize The size of the encoded fields.
+     * @return The number of characters written, excluding the terminator.
+     */
+    UInt32 FormatLogFields(char *buffer, UInt32 bufferSize, const char *message, const UByte *fields, UInt32 fieldsSize)
+    {
+        LogTextBuilder builder(buffer, bufferSize);
+        builder.Append(message, std::min<UInt32>(static_cast<UInt32>(Strlen(message)), bufferSize != 0 ? bufferSize - 1 : 0));
+
+        UInt32 position = 0;
+        LogArgValue key;
+        LogArgValue value;
+        while (!builder.HasOverflowed() && ReadLogField(fields, fieldsSize, position, key, value))
+        {
+            const UInt32 fieldStart = builder.GetLength();
+            builder.Append(' ');
+            builder.Append(key.m_string, key.m_length);
+            builder.Append('=');
+            AppendFieldValue(builder, value);
+
+            if (builder.HasOverflowed())
+            {
+                builder.Rewind(fieldStart);
+                break;
+            }
+        }
+
+        return builder.GetLength();
+    }
+
+    /**
+     * @brief Builds the printf format rendering a structured message like FormatLogFields when given
+     * the field values alone, keys left out: the message and the keys are part of the format.
+     *
+     * @param buffer The buffer receiving the null terminated format.
+     * @param bufferSize The size of the buffer.
+     * @param message The message of the structured log line.
+     * @param fields The encoded fields.
+     * @param fieldsSize The size of the encoded fields.
+     * @return The length of the format, 0 if it doesn't fit or the fields are malformed.
+     */
+    UInt32 BuildLogFieldsFormat(char *buffer, UInt32 bufferSize, const char *message, const UByte *fields, UInt32 fieldsSize)
+    {
+        LogTextBuilder builder(buffer, bufferSize);
+        AppendFormatLiteral(builder, message, static_cast<UInt32>(Strlen(message)));
+
+        UInt32 position = 0;
+        LogArgValue key;
+        LogArgValue value;
+        while (ReadLogField(fields, fieldsSize, position, key, value))
+        {
+            builder.Append(' ');
+            AppendFormatLiteral(builder, key.m_string, key.m_length);
+            builder.Append('=');
+
+            const char *conversion = GetLogFieldConversion(value.m_type);
+            builder.Append(conversion, static_cast<UInt32>(Strlen(conversion)));
+        }
+
+        return position == fieldsSize && !builder.HasOverflowed() ? builder.GetLength() : 0;
+    }
+
+    /**
+     * @brief Formats a log line as a JSON object on its own line, for log ingestion:
+     * {"time":<microseconds since epoch>,"level":..,"category":..,"thread":..,"msg":..} followed by
+     * the fields of structured messages as members. Fields that don't fit are left out whole.
+     *
+     * @param buffer The buffer receiving the formatted, null terminated line.
+     * @param bufferSize The size of the buffer.
+     * @param logLine The log line to format.
+     * @return The length of the formatted line, excluding the terminator.
+     */
+    UInt32 FormatLogJson(char *buffer, UInt32 bufferSize, const LogLine &logLine)
+    {
+        // Room for closing the object.
+        const UInt32 endLength = 2;
+        if (bufferSize <= endLength)
+        {
+            return 0;
+        }
+
+        LogTextBuilder builder(buffer, bufferSize);
+        builder.Reserve(endLength);
+
+        const Int64 time = std::chrono::duration_cast<std::chrono::microseconds>(logLine.m_time.time_since_epoch()).count();
+        builder.Append("{\"time\":", 8);
+        builder.AppendNumber(time);
+        builder.AppendFormat(",\"level\":\"%s\",\"category\":\"%s\",\"thread\":%u,\"msg\":", GetLogLevelName(logLine.m_level), GetLogCategoryName(logLine.m_category), logLine.m_threadId);
+
+        if (logLine.m_type == LogLineType_Fields)
+        {
+            AppendJsonString(builder, logLine.m_format, static_cast<UInt32>(Strlen(logLine.m_format)));
+
+            const UByte *fields = reinterpret_cast<const UByte *>(logLine.GetPayload());
+            UInt32 position = 0;
+            LogArgValue key;
+            LogArgValue value;
+            while (!builder.HasOverflowed() && ReadLogField(fields, logLine.m_size, position, key, value))
+            {
+                const UInt32 fieldStart = builder.GetLength();
+                builder.Append(',');
+                AppendJsonString(builder, key.m_string, key.m_length);
+                builder.Append(':');
+                AppendJsonValue(builder, value);
+
+                if (builder.HasOverflowed())
+                {
+                    builder.Rewind(fieldStart);
+                    break;
+                }
+            }
+        }
+        else if (logLine.m_format != nullptr)
+        {
+            char message[c_logFormattedLineSize];
+            const Int32 length = DecodeLogArgs(message, sizeof(message), logLine.m_format, reinterpret_cast<const UByte *>(logLine.GetPayload()), logLine.m_size);
+            AppendJsonString(builder, message, static_cast<UInt32>(std::max(length, 0)));
+        }
+        else
+        {
+            AppendJsonString(builder, logLine.GetPayload(), static_cast<UInt32>(Strnlen(logLine.GetPayload(), logLine.m_size)));
+        }
+
+        if (builder.HasOverflowed())
+        {
+            // Only a buffer too small for the header gets here.
+            builder.Rewind(0);
+            return 0;
+        }
+
+        builder.Release(endLength);
+        builder.Append("}\n", endLength);
+        return builder.GetLength();
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef __CORESYSTEM_LOGFIELDS_H__
+#define __CORESYSTEM_LOGFIELDS_H__
+
+namespace uge::log
+{
+    /**
+     * @brief Structured messages (LogLineType_Fields) keep their message, a plain string, in
+     * m_format and carry typed key/value fields as their payload: each key is a string argument
+     * followed by its value, both in the LogArgWriter encoding. Values are only turned into text
+     * by the sinks: as " key=value" after the message (FormatLogMessage), as JSON members
+     * (FormatLogJson), or kept binary (LogBinaryEncoder).
+     */
+    template <typename... TArgs>
+    constexpr Bool IsLogFieldList();
+
+    CORESYSTEM_API UInt32 FormatLogFields(char *buffer, UInt32 bufferSize, const char *message, const UByte *fields, UInt32 fieldsSize);
+    CORESYSTEM_API UInt32 BuildLogFieldsFormat(char *buffer, UInt32 bufferSize, const char *message, const UByte *fields, UInt32 fieldsSize);
+    CORESYSTEM_API UInt32 FormatLogJson(char *buffer, UInt32 bufferSize, const LogLine &logLine);
+}
+
+#include "logFields.inl"
+
+#endif // __CORESYSTEM_LOGFIELDS_H__
@@ -0,0 +1,33 @@
+#ifndef __CORESYSTEM_LOGFIELDS_INL__
+#define __CORESYSTEM_LOGFIELDS_INL__
+
+namespace uge::log
+{
+    /**
+     * @brief Returns whether the arguments are key/value pairs: a string key followed by a value of
+     * any type that can be logged. T is expected to be decayed.
+     */
+    template <typename... TArgs>
+    constexpr Bool IsLogFieldList()
+    {
+        constexpr UInt32 argCount = sizeof...(TArgs);
+        constexpr LogArgType argTypes[] = {GetLogArgType<TArgs>()..., LogArgType_None};
+
+        if (argCount % 2 != 0)
+        {
+            return false;
+        }
+
+        for (UInt32 i = 0; i != argCount; i += 2)
+        {
+            if (argTypes[i] != LogArgType_String || argTypes[i + 1] == LogArgType_None)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+#endif // __CORESYSTEM_LOGFIELDS_INL__
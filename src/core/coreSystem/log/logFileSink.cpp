@@ -1,6 +1,6 @@
 #include "build.h"
 
-#include "logQueue.h"
+#include "logLine.h"
 #include "logFileSink.h"
 #include "file/file.h"
 
@@ -24,6 +24,14 @@ namespace uge::log
         }
     }
 
+    void LogFileSink::SinkLogBatch(const LogBatch &batch)
+    {
+        if (m_file != nullptr)
+        {
+            file::FileWrite(m_file, batch.m_text, batch.m_textLength);
+        }
+    }
+
     void LogFileSink::Flush()
     {
         if (m_file != nullptr)
@@ -13,6 +13,7 @@ namespace uge::log
         virtual ~LogFileSink();
 
         virtual void SinkLog(const char *formattedMsg, const LogLine &logLine);
+        virtual void SinkLogBatch(const LogBatch &batch);
         virtual void Flush();
 
         Bool OpenFile(const char *filename, const char *mode = "w");
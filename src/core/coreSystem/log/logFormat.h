@@ -0,0 +1,77 @@
+#ifndef __CORESYSTEM_LOGFORMAT_H__
+#define __CORESYSTEM_LOGFORMAT_H__
+
+#include <type_traits>
+
+namespace uge::log
+{
+    /**
+     * @brief Result of checking a log format string against the types of its arguments.
+     */
+    enum LogFormatError : UByte
+    {
+        LogFormatError_None,
+        LogFormatError_UnsupportedConversion,
+        LogFormatError_TooFewArguments,
+        LogFormatError_TooManyArguments,
+        LogFormatError_ArgumentTypeMismatch,
+        LogFormatError_WidthOrPrecisionNotInt
+    };
+
+    template <typename T>
+    constexpr LogArgType GetLogArgType();
+
+    template <typename T>
+    constexpr UInt32 GetLogArgFixedSize();
+
+    template <typename... TArgs>
+    constexpr LogFormatError ValidateLogFormat(const char *format);
+
+    /**
+     * @brief A log format string checked at compile time against the types of the arguments it's
+     * used with. Only constructible from constant expressions, a bad format is a compile error.
+     */
+    template <typename... TArgs>
+    class LogFormatString
+    {
+    public:
+        consteval LogFormatString(const char *format);
+
+        const char *Get() const;
+
+    private:
+        const char *m_format;
+    };
+
+    /**
+     * @brief Packs arguments in the LogArgWriter encoding. The size of everything but the characters
+     * of string arguments is known at compile time, strings are measured once and trimmed if the
+     * message doesn't fit.
+     */
+    template <typename... TArgs>
+    class LogArgPacker
+    {
+    public:
+        static constexpr UInt32 c_fixedSize = (0 + ... + GetLogArgFixedSize<std::decay_t<TArgs>>());
+        static constexpr UInt32 c_stringCount = (0 + ... + (GetLogArgType<std::decay_t<TArgs>>() >= LogArgType_String ? 1 : 0));
+
+        UInt32 Measure(UInt32 maxSize, const TArgs &...args);
+        void Write(UByte *buffer, UInt32 bufferSize, const TArgs &...args) const;
+
+    private:
+        template <typename T>
+        void MeasureArg(const T &value, UInt32 &stringIndex, UInt32 &size);
+
+        template <typename T>
+        void TrimArg(const T &value, UInt32 &stringIndex, UInt32 &budget);
+
+        template <typename T>
+        void WriteArg(LogArgWriter &writer, const T &value, UInt32 &stringIndex) const;
+
+        UInt32 m_stringLengths[c_stringCount != 0 ? c_stringCount : 1];
+    };
+}
+
+#include "logFormat.inl"
+
+#endif // __CORESYSTEM_LOGFORMAT_H__
@@ -0,0 +1,290 @@
+#ifndef __CORESYSTEM_LOGFORMAT_INL__
+#define __CORESYSTEM_LOGFORMAT_INL__
+
+namespace uge::log
+{
+    namespace priv
+    {
+        // Never defined: the consteval format check calls one of these to turn a bad format string
+        // into a compile error naming the problem.
+        void LogFormatError_UnsupportedConversion();
+        void LogFormatError_TooFewArguments();
+        void LogFormatError_TooManyArguments();
+        void LogFormatError_ArgumentTypeMismatch();
+        void LogFormatError_WidthOrPrecisionNotInt();
+    }
+
+    /**
+     * @brief Returns how an argument of type T is encoded, LogArgType_None if it can't be logged.
+     * T is expected to be decayed, so string literals are seen as character pointers.
+     */
+    template <typename T>
+    constexpr LogArgType GetLogArgType()
+    {
+        if constexpr (std::is_enum_v<T>)
+        {
+            return GetLogArgType<std::underlying_type_t<T>>();
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T>)
+        {
+            return sizeof(T) <= sizeof(UInt32) ? LogArgType_UInt32 : LogArgType_UInt64;
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            return sizeof(T) <= sizeof(Int32) ? LogArgType_Int32 : LogArgType_Int64;
+        }
+        else if constexpr (std::is_same_v<T, Float> || std::is_same_v<T, Double>)
+        {
+            return LogArgType_Double;
+        }
+        else if constexpr (std::is_null_pointer_v<T>)
+        {
+            return LogArgType_Pointer;
+        }
+        else if constexpr (std::is_pointer_v<T>)
+        {
+            using TPointee = std::remove_cv_t<std::remove_pointer_t<T>>;
+            if constexpr (std::is_same_v<TPointee, AnsiChar>)
+            {
+                return LogArgType_String;
+            }
+            else if constexpr (std::is_same_v<TPointee, UniChar>)
+            {
+                return LogArgType_WideString;
+            }
+            else
+            {
+                return std::is_function_v<TPointee> ? LogArgType_None : LogArgType_Pointer;
+            }
+        }
+        else
+        {
+            return LogArgType_None;
+        }
+    }
+
+    /**
+     * @brief Returns the encoded size of an argument of type T, excluding the characters of strings.
+     */
+    template <typename T>
+    constexpr UInt32 GetLogArgFixedSize()
+    {
+        switch (GetLogArgType<T>())
+        {
+        case LogArgType_Int32:
+        case LogArgType_UInt32:
+            return 1 + sizeof(Int32);
+        case LogArgType_Int64:
+        case LogArgType_UInt64:
+        case LogArgType_Double:
+        case LogArgType_Pointer:
+            return 1 + sizeof(UInt64);
+        case LogArgType_String:
+            return 1 + sizeof(UInt16) + sizeof(AnsiChar);
+        case LogArgType_WideString:
+            return 1 + sizeof(UInt16) + sizeof(UniChar);
+        default:
+            return 0;
+        }
+    }
+
+    /**
+     * @brief Checks a format string against the types of the arguments it's used with, following
+     * printf's rules: '*' takes an int and every conversion needs an argument of matching size.
+     *
+     * @param format The format string to check.
+     * @return LogFormatError_None if the format and the arguments match.
+     */
+    template <typename... TArgs>
+    constexpr LogFormatError ValidateLogFormat(const char *format)
+    {
+        constexpr UInt32 argCount = sizeof...(TArgs);
+        constexpr LogArgType argTypes[] = {GetLogArgType<std::decay_t<TArgs>>()..., LogArgType_None};
+
+        UInt32 argIndex = 0;
+        for (const char *cursor = format; *cursor != '\0';)
+        {
+            if (*cursor != '%')
+            {
+                ++cursor;
+                continue;
+            }
+
+            LogFormatSpec spec;
+            if (!ParseLogFormatSpec(cursor, spec))
+            {
+                return LogFormatError_UnsupportedConversion;
+            }
+
+            cursor = spec.m_end;
+            if (spec.m_argType == LogArgType_None)
+            {
+                continue;
+            }
+
+            const UInt32 specArgCount = 1 + (spec.m_widthArg ? 1 : 0) + (spec.m_precisionArg ? 1 : 0);
+            if (argIndex + specArgCount > argCount)
+            {
+                return LogFormatError_TooFewArguments;
+            }
+
+            if ((spec.m_widthArg && GetLogArgStorageType(argTypes[argIndex++]) != LogArgType_Int32) || (spec.m_precisionArg && GetLogArgStorageType(argTypes[argIndex++]) != LogArgType_Int32))
+            {
+                return LogFormatError_WidthOrPrecisionNotInt;
+            }
+
+            if (GetLogArgStorageType(argTypes[argIndex++]) != spec.m_argType)
+            {
+                return LogFormatError_ArgumentTypeMismatch;
+            }
+        }
+
+        return argIndex == argCount ? LogFormatError_None : LogFormatError_TooManyArguments;
+    }
+
+    template <typename... TArgs>
+    consteval LogFormatString<TArgs...>::LogFormatString(const char *format)
+        : m_format(format)
+    {
+        switch (ValidateLogFormat<TArgs...>(format))
+        {
+        case LogFormatError_UnsupportedConversion:
+            priv::LogFormatError_UnsupportedConversion();
+            break;
+        case LogFormatError_TooFewArguments:
+            priv::LogFormatError_TooFewArguments();
+            break;
+        case LogFormatError_TooManyArguments:
+            priv::LogFormatError_TooManyArguments();
+            break;
+        case LogFormatError_ArgumentTypeMismatch:
+            priv::LogFormatError_ArgumentTypeMismatch();
+            break;
+        case LogFormatError_WidthOrPrecisionNotInt:
+            priv::LogFormatError_WidthOrPrecisionNotInt();
+            break;
+        default:
+            break;
+        }
+    }
+
+    template <typename... TArgs>
+    UGE_FORCE_INLINE const char *LogFormatString<TArgs...>::Get() const
+    {
+        return m_format;
+    }
+
+    /**
+     * @brief Measures the encoded size of the arguments, trimming string arguments so the result
+     * doesn't exceed maxSize.
+     *
+     * @param maxSize The largest size the encoded arguments may take, at least c_fixedSize.
+     * @param args The arguments to measure.
+     * @return The size Write needs.
+     */
+    template <typename... TArgs>
+    UGE_FORCE_INLINE UInt32 LogArgPacker<TArgs...>::Measure(UInt32 maxSize, const TArgs &...args)
+    {
+        UInt32 size = c_fixedSize;
+        if constexpr (c_stringCount != 0)
+        {
+            UInt32 stringIndex = 0;
+            (MeasureArg(args, stringIndex, size), ...);
+
+            if (size > maxSize)
+            {
+                UInt32 budget = maxSize - c_fixedSize;
+                stringIndex = 0;
+                (TrimArg(args, stringIndex, budget), ...);
+                size = maxSize - budget;
+            }
+        }
+
+        return size;
+    }
+
+    /**
+     * @brief Encodes the arguments, bufferSize must be the size returned by Measure.
+     */
+    template <typename... TArgs>
+    UGE_FORCE_INLINE void LogArgPacker<TArgs...>::Write(UByte *buffer, UInt32 bufferSize, const TArgs &...args) const
+    {
+        if constexpr (sizeof...(TArgs) != 0)
+        {
+            LogArgWriter writer(buffer, bufferSize);
+            UInt32 stringIndex = 0;
+            (WriteArg(writer, args, stringIndex), ...);
+        }
+    }
+
+    template <typename... TArgs>
+    template <typename T>
+    UGE_FORCE_INLINE void LogArgPacker<TArgs...>::MeasureArg(const T &value, UInt32 &stringIndex, UInt32 &size)
+    {
+        constexpr LogArgType type = GetLogArgType<std::decay_t<T>>();
+        if constexpr (type == LogArgType_String || type == LogArgType_WideString)
+        {
+            using TChar = std::conditional_t<type == LogArgType_String, AnsiChar, UniChar>;
+            const TChar *string = value;
+
+            // LogArgWriter writes "(null)" for null strings.
+            const UInt32 length = string != nullptr ? static_cast<UInt32>(Strlen(string)) : 6;
+            m_stringLengths[stringIndex++] = length;
+            size += length * sizeof(TChar);
+        }
+    }
+
+    template <typename... TArgs>
+    template <typename T>
+    UGE_FORCE_INLINE void LogArgPacker<TArgs...>::TrimArg(const T &value, UInt32 &stringIndex, UInt32 &budget)
+    {
+        constexpr LogArgType type = GetLogArgType<std::decay_t<T>>();
+        if constexpr (type == LogArgType_String || type == LogArgType_WideString)
+        {
+            using TChar = std::conditional_t<type == LogArgType_String, AnsiChar, UniChar>;
+
+            UInt32 &length = m_stringLengths[stringIndex++];
+            length = std::min<UInt32>(length, budget / sizeof(TChar));
+            budget -= length * sizeof(TChar);
+        }
+    }
+
+    template <typename... TArgs>
+    template <typename T>
+    UGE_FORCE_INLINE void LogArgPacker<TArgs...>::WriteArg(LogArgWriter &writer, const T &value, UInt32 &stringIndex) const
+    {
+        constexpr LogArgType type = GetLogArgType<std::decay_t<T>>();
+        static_assert(type != LogArgType_None, "Type can't be logged");
+
+        if constexpr (type == LogArgType_Int32)
+        {
+            writer.WriteInt32(static_cast<Int32>(value));
+        }
+        else if constexpr (type == LogArgType_Int64)
+        {
+            writer.WriteInt64(static_cast<Int64>(value));
+        }
+        else if constexpr (type == LogArgType_UInt32)
+        {
+            writer.WriteUInt32(static_cast<UInt32>(value));
+        }
+        else if constexpr (type == LogArgType_UInt64)
+        {
+            writer.WriteUInt64(static_cast<UInt64>(value));
+        }
+        else if constexpr (type == LogArgType_Double)
+        {
+            writer.WriteDouble(static_cast<Double>(value));
+        }
+        else if constexpr (type == LogArgType_Pointer)
+        {
+            writer.WritePointer(static_cast<const void *>(value));
+        }
+        else
+        {
+            writer.WriteString(value, static_cast<Int32>(m_stringLengths[stringIndex++]));
+        }
+    }
+}
+
+#endif // __CORESYSTEM_LOGFORMAT_INL__
@@ -0,0 +1,82 @@
+#include "build.h"
+
+#include <bit>
+
+#include "logHistogram.h"
+
+namespace uge::log
+{
+    void LogLatencyHistogram::Record(UInt64 latencyUs)
+    {
+        ++m_counts[GetBucket(latencyUs)];
+        m_maxUs = std::max(m_maxUs, latencyUs);
+    }
+
+    UInt64 LogLatencyHistogram::GetCount() const
+    {
+        UInt64 count = 0;
+        for (UInt32 i = 0; i != c_logLatencyBucketCount; ++i)
+        {
+            count += m_counts[i];
+        }
+        return count;
+    }
+
+    /**
+     * @brief Returns the lower bound of the bucket holding the given percentile of the recorded
+     * latencies, in microseconds.
+     *
+     * @param percentile The percentile, between 0 and 100.
+     */
+    UInt64 LogLatencyHistogram::GetPercentile(double percentile) const
+    {
+        const UInt64 count = GetCount();
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        const UInt64 rank = std::max<UInt64>(1, static_cast<UInt64>(percentile / 100.0 * static_cast<double>(count) + 0.5));
+        UInt64 seen = 0;
+        for (UInt32 i = 0; i != c_logLatencyBucketCount; ++i)
+        {
+            seen += m_counts[i];
+            if (seen >= rank)
+            {
+                return std::min(GetBucketLowerBound(i), m_maxUs);
+            }
+        }
+
+        return m_maxUs;
+    }
+
+    /**
+     * @brief Returns the bucket of a latency: the value itself below 8, then the position of its
+     * highest bit and the two bits below it.
+     */
+    UInt32 LogLatencyHistogram::GetBucket(UInt64 latencyUs)
+    {
+        const UInt32 subBucketCount = 1u << c_logLatencySubBucketBits;
+        if (latencyUs < 2 * subBucketCount)
+        {
+            return static_cast<UInt32>(latencyUs);
+        }
+
+        const UInt32 highBit = static_cast<UInt32>(std::bit_width(latencyUs)) - 1;
+        const UInt32 shift = highBit - c_logLatencySubBucketBits;
+        const UInt32 bucket = (shift + 1) * subBucketCount + (static_cast<UInt32>(latencyUs >> shift) & (subBucketCount - 1));
+        return std::min(bucket, c_logLatencyBucketCount - 1);
+    }
+
+    UInt64 LogLatencyHistogram::GetBucketLowerBound(UInt32 bucket)
+    {
+        const UInt32 subBucketCount = 1u << c_logLatencySubBucketBits;
+        if (bucket < 2 * subBucketCount)
+        {
+            return bucket;
+        }
+
+        const UInt32 shift = bucket / subBucketCount - 1;
+        return static_cast<UInt64>(subBucketCount + bucket % subBucketCount) << shift;
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef __CORESYSTEM_LOGHISTOGRAM_H__
+#define __CORESYSTEM_LOGHISTOGRAM_H__
+
+namespace uge::log
+{
+    // Four buckets per power of two of microseconds, up to about two hours.
+    const UInt32 c_logLatencySubBucketBits = 2;
+    const UInt32 c_logLatencyBucketCount = 128;
+
+    /**
+     * @brief Log-linear histogram of the time messages wait between their push and the sinks, in
+     * microseconds. Bucket bounds are exact below 8us and within 25% of each other above, which is
+     * all sizing the rings needs while keeping a recording to a couple of shifts.
+     */
+    struct CORESYSTEM_API LogLatencyHistogram
+    {
+        UInt64 m_counts[c_logLatencyBucketCount];
+        UInt64 m_maxUs;
+
+        void Record(UInt64 latencyUs);
+        UInt64 GetCount() const;
+        UInt64 GetPercentile(double percentile) const;
+
+        static UInt32 GetBucket(UInt64 latencyUs);
+        static UInt64 GetBucketLowerBound(UInt32 bucket);
+    };
+}
+
+#endif // __CORESYSTEM_LOGHISTOGRAM_H__
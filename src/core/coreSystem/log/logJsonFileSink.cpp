@@ -0,0 +1,87 @@
+#include "build.h"
+
+#include "logLine.h"
+#include "logJsonFileSink.h"
+#include "file/file.h"
+
+namespace uge::log
+{
+    LogJsonFileSink::LogJsonFileSink()
+        : m_file(nullptr), m_bufferSize(0)
+    {
+    }
+
+    LogJsonFileSink::~LogJsonFileSink()
+    {
+        CloseFile();
+    }
+
+    void LogJsonFileSink::SinkLog(const char *formattedMsg, const LogLine &logLine)
+    {
+        if (m_file != nullptr)
+        {
+            Format(logLine);
+            WriteBuffer();
+        }
+    }
+
+    void LogJsonFileSink::SinkLogBatch(const LogBatch &batch)
+    {
+        if (m_file != nullptr)
+        {
+            for (UInt32 i = 0; i != batch.m_count; ++i)
+            {
+                Format(*batch.m_entries[i].m_logLine);
+            }
+            WriteBuffer();
+        }
+    }
+
+    void LogJsonFileSink::Flush()
+    {
+        if (m_file != nullptr)
+        {
+            file::FileFlush(m_file);
+        }
+    }
+
+    Bool LogJsonFileSink::OpenFile(const char *filename, const char *mode)
+    {
+        CloseFile();
+        return file::FileOpen(&m_file, filename, mode);
+    }
+
+    Bool LogJsonFileSink::CloseFile()
+    {
+        if (m_file != nullptr)
+        {
+            file::FileFlush(m_file);
+            file::FileClose(m_file);
+            m_file = nullptr;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Appends a log line to the staging buffer, writing the buffer out first if a full line
+     * might not fit.
+     */
+    void LogJsonFileSink::Format(const LogLine &logLine)
+    {
+        if (m_bufferSize + c_logFormattedLineSize > sizeof(m_buffer))
+        {
+            WriteBuffer();
+        }
+
+        m_bufferSize += FormatLogJson(m_buffer + m_bufferSize, c_logFormattedLineSize, logLine);
+    }
+
+    void LogJsonFileSink::WriteBuffer()
+    {
+        if (m_bufferSize != 0)
+        {
+            file::FileWrite(m_file, m_buffer, m_bufferSize);
+            m_bufferSize = 0;
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef __CORESYSTEM_LOGJSONFILESINK_H__
+#define __CORESYSTEM_LOGJSONFILESINK_H__
+
+#include "logSink.h"
+#include <stdio.h>
+
+namespace uge::log
+{
+    const UInt32 c_logJsonBufferSize = 64 * 1024;
+
+    /**
+     * @brief File sink writing one JSON object per line, see FormatLogJson. The fields of structured
+     * messages become members of the object, so the file can be ingested without parsing the text.
+     */
+    class CORESYSTEM_API LogJsonFileSink : public LogSink
+    {
+    public:
+        LogJsonFileSink();
+        virtual ~LogJsonFileSink();
+
+        virtual void SinkLog(const char *formattedMsg, const LogLine &logLine);
+        virtual void SinkLogBatch(const LogBatch &batch);
+        virtual void Flush();
+
+        Bool OpenFile(const char *filename, const char *mode = "w");
+        Bool CloseFile();
+
+    private:
+        void Format(const LogLine &logLine);
+        void WriteBuffer();
+
+        FILE *m_file;
+
+        UInt32 m_bufferSize;
+        char m_buffer[c_logJsonBufferSize];
+    };
+}
+
+#endif // __CORESYSTEM_LOGJSONFILESINK_H__
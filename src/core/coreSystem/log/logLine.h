@@ -0,0 +1,69 @@
+#ifndef __CORESYSTEM_LOGLINE_H__
+#define __CORESYSTEM_LOGLINE_H__
+
+#include <chrono>
+
+namespace uge::log
+{
+    enum LogLevel : UByte
+    {
+        LogLevel_Fatal,
+        LogLevel_Error,
+        LogLevel_Warning,
+        LogLevel_Info,
+        LogLevel_Debug,
+        LogLevel_Trace
+    };
+
+    enum LogCategory
+    {
+        LogCategory_Core,
+        LogCategory_Game,
+
+        LogCategory_MAX
+    };
+
+    enum LogLineType : UByte
+    {
+        LogLineType_Log,
+        LogLineType_Fields,
+        LogLineType_Flush
+    };
+
+    // Largest payload a single log line may carry.
+    const UInt32 c_logLineBufferSize = 1024;
+
+    // Largest formatted line handed to the sinks, terminator included.
+    const UInt32 c_logFormattedLineSize = 4096;
+
+    /**
+     * @brief Header of a log record. The payload follows the header directly in the log ring: the
+     * formatted text, the encoded arguments when m_format is set, or the encoded fields of a
+     * LogLineType_Fields message, see IsLogFieldList.
+     */
+    struct LogLine
+    {
+        UInt32 m_size;
+        std::chrono::system_clock::time_point m_time;
+        UInt32 m_threadId;
+        LogLineType m_type;
+        LogLevel m_level;
+        LogCategory m_category;
+
+        // Format string of a deferred message, or the message of a structured one. nullptr when the
+        // payload already holds the formatted text.
+        const char *m_format;
+
+        char *GetPayload()
+        {
+            return reinterpret_cast<char *>(this + 1);
+        }
+
+        const char *GetPayload() const
+        {
+            return reinterpret_cast<const char *>(this + 1);
+        }
+    };
+}
+
+#endif // __CORESYSTEM_LOGLINE_H__
@@ -0,0 +1,334 @@
+#include "build.h"
+
+#include "logLine.h"
+#include "logMappedFileSink.h"
+
+#if defined(UGE_PLATFORM_LINUX)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace uge::log
+{
+    namespace
+    {
+        /**
+         * @brief Returns whether fileName is "<baseName>.<index>".
+         */
+        Bool IsSegmentName(const char *fileName, const char *baseName)
+        {
+            const size_t baseNameLength = Strlen(baseName);
+            if (Strlen(fileName) < baseNameLength + 2 || Memcmp(fileName, baseName, baseNameLength) != 0 || fileName[baseNameLength] != '.')
+            {
+                return false;
+            }
+
+            for (const char *cursor = fileName + baseNameLength + 1; *cursor != '\0'; ++cursor)
+            {
+                if (*cursor < '0' || *cursor > '9')
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    }
+
+#if defined(UGE_PLATFORM_WINDOWS)
+    LogMappedFileSink::LogMappedFileSink()
+        : m_segmentSize(0), m_segmentCount(0), m_nextSegmentIndex(0), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr), m_view(nullptr), m_offset(0)
+    {
+        m_basePath[0] = '\0';
+    }
+#elif defined(UGE_PLATFORM_LINUX)
+    LogMappedFileSink::LogMappedFileSink()
+        : m_segmentSize(0), m_segmentCount(0), m_nextSegmentIndex(0), m_file(-1), m_view(nullptr), m_offset(0)
+    {
+        m_basePath[0] = '\0';
+    }
+#endif
+
+    LogMappedFileSink::~LogMappedFileSink()
+    {
+        Close();
+    }
+
+    void LogMappedFileSink::SinkLog(const char *formattedMsg, const LogLine &logLine)
+    {
+        Write(formattedMsg, static_cast<UInt32>(Strlen(formattedMsg)));
+    }
+
+    void LogMappedFileSink::SinkLogBatch(const LogBatch &batch)
+    {
+        if (m_view != nullptr && m_offset + batch.m_textLength <= m_segmentSize)
+        {
+            Memcpy(m_view + m_offset, batch.m_text, batch.m_textLength);
+            m_offset += batch.m_textLength;
+            return;
+        }
+
+        // The batch straddles segments, write it line by line so lines aren't split across segments.
+        for (UInt32 i = 0; i != batch.m_count; ++i)
+        {
+            Write(batch.m_entries[i].m_text, batch.m_entries[i].m_length);
+        }
+    }
+
+    void LogMappedFileSink::Flush()
+    {
+        if (m_view != nullptr)
+        {
+#if defined(UGE_PLATFORM_WINDOWS)
+            ::FlushViewOfFile(m_view, m_offset);
+#elif defined(UGE_PLATFORM_LINUX)
+            ::msync(m_view, m_offset, MS_SYNC);
+#endif
+        }
+    }
+
+    /**
+     * @brief Starts writing to the first segment, "<basePath>.0".
+     *
+     * @param basePath The path the segment index is appended to.
+     * @param segmentSize The size of a segment, preallocated when the segment is created.
+     * @param segmentCount The number of segments kept on disk, the current one included.
+     * @return true if the first segment could be created and mapped.
+     */
+    Bool LogMappedFileSink::Open(const char *basePath, UInt32 segmentSize, UInt32 segmentCount)
+    {
+        UGE_ASSERT(segmentSize != 0 && segmentCount != 0, "Invalid segment settings");
+
+        Close();
+
+        Strcpy(m_basePath, basePath, sizeof(m_basePath));
+        m_segmentSize = segmentSize;
+        m_segmentCount = segmentCount;
+        m_nextSegmentIndex = 0;
+
+        DeleteStaleSegments();
+        return OpenSegment();
+    }
+
+    Bool LogMappedFileSink::Close()
+    {
+        CloseSegment();
+        m_basePath[0] = '\0';
+        return true;
+    }
+
+    /**
+     * @brief Copies text to the current segment, moving to the next segment before a line that
+     * doesn't fit. Only lines longer than a whole segment are split.
+     */
+    void LogMappedFileSink::Write(const char *text, UInt32 length)
+    {
+        while (length != 0)
+        {
+            if (m_view == nullptr || (m_offset + length > m_segmentSize && m_offset != 0))
+            {
+                if (m_basePath[0] == '\0')
+                {
+                    return;
+                }
+
+                CloseSegment();
+                if (!OpenSegment())
+                {
+                    return;
+                }
+            }
+
+            const UInt32 copyLength = std::min(length, m_segmentSize - m_offset);
+            Memcpy(m_view + m_offset, text, copyLength);
+            m_offset += copyLength;
+            text += copyLength;
+            length -= copyLength;
+        }
+    }
+
+    /**
+     * @brief Creates and maps the next segment. The index only moves on once it succeeds, a failed
+     * segment is retried with the next line rather than leaving a gap in the indices.
+     */
+    Bool LogMappedFileSink::OpenSegment()
+    {
+        char path[c_logSegmentPathMaxLength];
+        GetSegmentPath(path, sizeof(path), m_nextSegmentIndex);
+
+#if defined(UGE_PLATFORM_WINDOWS)
+        m_file = ::CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        // Mapping more than the file holds grows it, which preallocates the whole segment.
+        m_mapping = ::CreateFileMappingA(m_file, nullptr, PAGE_READWRITE, 0, m_segmentSize, nullptr);
+        if (m_mapping != nullptr)
+        {
+            m_view = static_cast<char *>(::MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, m_segmentSize));
+        }
+#elif defined(UGE_PLATFORM_LINUX)
+        m_file = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (m_file < 0)
+        {
+            return false;
+        }
+
+        // Preallocate the whole segment, a write to a page past the end of the file would fault.
+        if (::posix_fallocate(m_file, 0, m_segmentSize) == 0)
+        {
+            void *view = ::mmap(nullptr, m_segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+            m_view = view != MAP_FAILED ? static_cast<char *>(view) : nullptr;
+        }
+#endif
+
+        if (m_view == nullptr)
+        {
+            CloseSegment();
+            return false;
+        }
+
+        m_offset = 0;
+
+        if (m_nextSegmentIndex >= m_segmentCount)
+        {
+            GetSegmentPath(path, sizeof(path), m_nextSegmentIndex - m_segmentCount);
+            DeleteSegment(path);
+        }
+
+        ++m_nextSegmentIndex;
+        return true;
+    }
+
+    void LogMappedFileSink::CloseSegment()
+    {
+#if defined(UGE_PLATFORM_WINDOWS)
+        if (m_view != nullptr)
+        {
+            ::UnmapViewOfFile(m_view);
+            m_view = nullptr;
+        }
+
+        if (m_mapping != nullptr)
+        {
+            ::CloseHandle(m_mapping);
+            m_mapping = nullptr;
+        }
+
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            // Give back the preallocated space past the last line.
+            LARGE_INTEGER size;
+            size.QuadPart = m_offset;
+            ::SetFilePointerEx(m_file, size, nullptr, FILE_BEGIN);
+            ::SetEndOfFile(m_file);
+
+            ::CloseHandle(m_file);
+            m_file = INVALID_HANDLE_VALUE;
+        }
+#elif defined(UGE_PLATFORM_LINUX)
+        if (m_view != nullptr)
+        {
+            ::munmap(m_view, m_segmentSize);
+            m_view = nullptr;
+        }
+
+        if (m_file >= 0)
+        {
+            // Give back the preallocated space past the last line.
+            (void)::ftruncate(m_file, m_offset);
+
+            ::close(m_file);
+            m_file = -1;
+        }
+#endif
+
+        m_offset = 0;
+    }
+
+    /**
+     * @brief Deletes every "<basePath>.<index>" file, an earlier run may have left any range of indices.
+     */
+    void LogMappedFileSink::DeleteStaleSegments() const
+    {
+        // The segments are looked for in the directory of the base path, by the name that follows it.
+        Int32 nameStart = 0;
+        for (Int32 i = 0; m_basePath[i] != '\0'; ++i)
+        {
+            if (m_basePath[i] == '/' || m_basePath[i] == '\\')
+            {
+                nameStart = i + 1;
+            }
+        }
+
+        const char *baseName = m_basePath + nameStart;
+        char path[c_logSegmentPathMaxLength];
+
+#if defined(UGE_PLATFORM_WINDOWS)
+        Snprintf(path, sizeof(path), "%s.*", m_basePath);
+
+        WIN32_FIND_DATAA findData;
+        HANDLE find = ::FindFirstFileA(path, &findData);
+        if (find == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        do
+        {
+            if (IsSegmentName(findData.cFileName, baseName))
+            {
+                Snprintf(path, sizeof(path), "%.*s%s", nameStart, m_basePath, findData.cFileName);
+                DeleteSegment(path);
+            }
+        } while (::FindNextFileA(find, &findData));
+
+        ::FindClose(find);
+#elif defined(UGE_PLATFORM_LINUX)
+        char directoryPath[c_logSegmentPathMaxLength];
+        if (nameStart != 0)
+        {
+            Snprintf(directoryPath, sizeof(directoryPath), "%.*s", nameStart, m_basePath);
+        }
+        else
+        {
+            Strcpy(directoryPath, ".", sizeof(directoryPath));
+        }
+
+        DIR *directory = ::opendir(directoryPath);
+        if (directory == nullptr)
+        {
+            return;
+        }
+
+        while (const dirent *entry = ::readdir(directory))
+        {
+            if (IsSegmentName(entry->d_name, baseName))
+            {
+                Snprintf(path, sizeof(path), "%.*s%s", nameStart, m_basePath, entry->d_name);
+                DeleteSegment(path);
+            }
+        }
+
+        ::closedir(directory);
+#endif
+    }
+
+    void LogMappedFileSink::DeleteSegment(const char *path)
+    {
+#if defined(UGE_PLATFORM_WINDOWS)
+        ::DeleteFileA(path);
+#elif defined(UGE_PLATFORM_LINUX)
+        ::unlink(path);
+#endif
+    }
+
+    void LogMappedFileSink::GetSegmentPath(char *path, UInt32 pathSize, UInt32 segmentIndex) const
+    {
+        Snprintf(path, pathSize, "%s.%u", m_basePath, segmentIndex);
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef __CORESYSTEM_LOGMAPPEDFILESINK_H__
+#define __CORESYSTEM_LOGMAPPEDFILESINK_H__
+
+#include "logSink.h"
+
+namespace uge::log
+{
+    const UInt32 c_logSegmentDefaultSize = 16 * 1024 * 1024;
+    const UInt32 c_logSegmentDefaultCount = 8;
+    const UInt32 c_logSegmentPathMaxLength = 260;
+
+    /**
+     * @brief File sink writing into preallocated, memory-mapped segments "<basePath>.<index>".
+     *
+     * Writing a line is a copy into the mapped view, the OS writes the pages back on its own and
+     * Flush forces it. A full segment is trimmed to its written size and closed, and the next one is
+     * created; only the last segmentCount segments are kept on disk. A segment left behind by a crash
+     * keeps its preallocated size, zero filled after the last line. Open deletes the segments an
+     * earlier run left with the same base path.
+     */
+    class CORESYSTEM_API LogMappedFileSink : public LogSink
+    {
+    public:
+        LogMappedFileSink();
+        virtual ~LogMappedFileSink();
+
+        virtual void SinkLog(const char *formattedMsg, const LogLine &logLine);
+        virtual void SinkLogBatch(const LogBatch &batch);
+        virtual void Flush();
+
+        Bool Open(const char *basePath, UInt32 segmentSize = c_logSegmentDefaultSize, UInt32 segmentCount = c_logSegmentDefaultCount);
+        Bool Close();
+
+    private:
+        void Write(const char *text, UInt32 length);
+        Bool OpenSegment();
+        void CloseSegment();
+        void DeleteStaleSegments() const;
+        static void DeleteSegment(const char *path);
+        void GetSegmentPath(char *path, UInt32 pathSize, UInt32 segmentIndex) const;
+
+        char m_basePath[c_logSegmentPathMaxLength];
+        UInt32 m_segmentSize;
+        UInt32 m_segmentCount;
+        UInt32 m_nextSegmentIndex;
+
+#if defined(UGE_PLATFORM_WINDOWS)
+        HANDLE m_file;
+        HANDLE m_mapping;
+#elif defined(UGE_PLATFORM_LINUX)
+        Int32 m_file;
+#endif
+        char *m_view;
+        UInt32 m_offset;
+    };
+}
+
+#endif // __CORESYSTEM_LOGMAPPEDFILESINK_H__
@@ -0,0 +1,18 @@
+#include "build.h"
+
+#include "logRateLimiter.h"
+
+namespace uge::log
+{
+    void LogRateLimiter::ReportSuppressedCount(LogLevel level, LogCategory category, UInt32 count)
+    {
+        if (count == 1)
+        {
+            GetLog().PushMessageArgs(level, category, "1 message like the next one was suppressed by rate limiting");
+        }
+        else
+        {
+            GetLog().PushMessageArgs(level, category, "%u messages like the next one were suppressed by rate limiting", count);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef __CORESYSTEM_LOGRATELIMITER_H__
+#define __CORESYSTEM_LOGRATELIMITER_H__
+
+namespace uge::log
+{
+    constexpr UInt32 c_logRateLimitPerSecond = UGE_LOG_RATE_LIMIT_PER_SECOND;
+    constexpr UInt32 c_logRateLimitBurst = UGE_LOG_RATE_LIMIT_BURST;
+
+    /**
+     * @brief Whether UGE_LOG_* calls at level go through their call site's rate limiter. Errors and
+     * fatal errors never do: distinct failures from one call site must all reach the sinks.
+     */
+    constexpr Bool IsLogRateLimited(LogLevel level)
+    {
+        return c_logRateLimitPerSecond != 0 && level > LogLevel_Error;
+    }
+
+    /**
+     * @brief Token bucket limiting how often a call site logs, every UGE_LOG_* expansion holds one
+     * as a constant initialized static. Bursts of burst messages are let through, then rate messages
+     * per second; the others are only counted, and the count is logged before the next message the
+     * call site gets through.
+     *
+     * The bucket is kept as the time it's full again (GCRA), so a check is a read of the steady clock
+     * and a compare, plus a compare exchange when the message goes through.
+     */
+    class LogRateLimiter
+    {
+    public:
+        constexpr LogRateLimiter();
+
+        template <UInt32 TRate = c_logRateLimitPerSecond, UInt32 TBurst = c_logRateLimitBurst>
+        Bool TryAcquire();
+
+        UInt32 TakeSuppressedCount();
+        void ReportSuppressed(LogLevel level, LogCategory category);
+
+    private:
+        CORESYSTEM_API void ReportSuppressedCount(LogLevel level, LogCategory category, UInt32 count);
+
+        // Time the bucket is full again, in microseconds of the steady clock.
+        AtomicLong m_fullTime;
+        AtomicInt m_suppressedCount;
+    };
+}
+
+#include "logRateLimiter.inl"
+
+#endif // __CORESYSTEM_LOGRATELIMITER_H__
@@ -0,0 +1,73 @@
+#ifndef __CORESYSTEM_LOGRATELIMITER_INL__
+#define __CORESYSTEM_LOGRATELIMITER_INL__
+
+namespace uge::log
+{
+    constexpr LogRateLimiter::LogRateLimiter()
+        : m_fullTime(0), m_suppressedCount(0)
+    {
+    }
+
+    /**
+     * @brief Takes a token for a message, or counts the message as suppressed if the bucket is empty.
+     *
+     * @return true if the message may be logged.
+     */
+    template <UInt32 TRate, UInt32 TBurst>
+    UGE_FORCE_INLINE Bool LogRateLimiter::TryAcquire()
+    {
+        if constexpr (TRate == 0)
+        {
+            return true;
+        }
+        else
+        {
+            constexpr Int64 interval = 1000000 / TRate;
+            constexpr Int64 tolerance = interval * (TBurst != 0 ? TBurst - 1 : 0);
+
+            const Int64 now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            for (;;)
+            {
+                const Int64 fullTime = atomic::Atomic64::Fetch(&m_fullTime);
+                const Int64 start = std::max(fullTime, now);
+                if (start - now > tolerance)
+                {
+                    atomic::Atomic32::Increment(&m_suppressedCount);
+                    return false;
+                }
+
+                if (atomic::Atomic64::CompareExchange(&m_fullTime, start + interval, fullTime) == fullTime)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of messages suppressed since the last call and resets it.
+     */
+    UGE_FORCE_INLINE UInt32 LogRateLimiter::TakeSuppressedCount()
+    {
+        if (atomic::Atomic32::Fetch(&m_suppressedCount) == 0)
+        {
+            return 0;
+        }
+
+        return static_cast<UInt32>(atomic::Atomic32::Exchange(&m_suppressedCount, 0));
+    }
+
+    /**
+     * @brief Logs how many messages were suppressed, if any, ahead of a message that got through.
+     */
+    UGE_FORCE_INLINE void LogRateLimiter::ReportSuppressed(LogLevel level, LogCategory category)
+    {
+        const UInt32 count = TakeSuppressedCount();
+        if (count != 0)
+        {
+            ReportSuppressedCount(level, category, count);
+        }
+    }
+}
+
+#endif // __CORESYSTEM_LOGRATELIMITER_INL__
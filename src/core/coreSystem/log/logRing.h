@@ -0,0 +1,89 @@
+#ifndef __CORESYSTEM_LOGRING_H__
+#define __CORESYSTEM_LOGRING_H__
+
+#include "threads/atomic.h"
+
+namespace uge::log
+{
+    /**
+     * @brief The two owners of a producer ring, see LogRing::Release.
+     */
+    enum LogRingOwner : UInt32
+    {
+        LogRingOwner_Producer = 1,
+        LogRingOwner_Log = 2
+    };
+
+    /**
+     * @brief Lock-free single-producer/single-consumer byte ring owned by one logging thread.
+     *
+     * Records are variable-length and length-prefixed: the producer reserves room for the largest
+     * record it may write, fills it in place and commits only the bytes it used; the consumer reads
+     * each record in place and releases it once done. Only the thread identified by GetThreadId()
+     * may Reserve/Commit/DropOldest, and only the log thread may Peek/Acquire/Pop.
+     *
+     * The tail lives in a 64-bit word whose upper half flags the record the consumer is reading, so
+     * the producer can evict the oldest records under back-pressure without pulling them out from
+     * under the log thread.
+     */
+    class CORESYSTEM_API LogRing
+    {
+    public:
+        LogRing(UInt32 threadId);
+        ~LogRing();
+
+        void *Reserve(UInt32 size);
+        void Commit(UInt32 size);
+        Bool DropOldest();
+
+        const void *Peek();
+        const void *Acquire();
+        void Pop();
+        UInt32 GetQueuedSize() const;
+
+        UInt32 GetThreadId() const;
+
+        UInt64 NextFlushSequence();
+        void CompleteFlush(UInt64 sequence);
+        UInt64 GetCompletedFlush() const;
+
+        void Release(LogRingOwner owner);
+        Bool IsReleasedBy(LogRingOwner owner) const;
+
+    private:
+        constexpr static UInt32 c_logRingSize = 64 * 1024;
+        constexpr static UInt32 c_logRingMask = c_logRingSize - 1;
+        constexpr static UInt32 c_logRecordAlignment = 8;
+        constexpr static UInt32 c_logRecordHeaderSize = 8;
+        constexpr static UInt32 c_logRecordWrap = UINT32_MAX;
+        constexpr static UInt64 c_logTailPinned = 1ull << 32;
+        constexpr static UInt32 c_cacheLineSize = 64;
+
+        static UInt32 GetRecordSize(UInt32 size);
+
+        // Written by the producer, read by the consumer.
+        UGE_ALIGNED_VAR(AtomicInt, c_cacheLineSize) m_head;
+        UInt32 m_cachedTail;
+        UInt32 m_reservedOffset;
+        UInt32 m_threadId;
+        UInt64 m_flushSequence;
+
+        // Written by the consumer, read by the producer. Low half is the tail, upper half the pinned flag.
+        UGE_ALIGNED_VAR(AtomicLong, c_cacheLineSize) m_tailState;
+        UInt64 m_peekedState;
+        UInt32 m_cachedHead;
+        UInt32 m_peekedSize;
+
+        // Sequence of the last flush marker sunk, read by the threads waiting on it.
+        AtomicLong m_completedFlush;
+
+        // LogRingOwner flags of the owners done with the ring.
+        AtomicInt m_released;
+
+        UGE_ALIGNED_VAR(UByte, c_cacheLineSize) m_buffer[c_logRingSize];
+    };
+}
+
+#include "logRing.inl"
+
+#endif // __CORESYSTEM_LOGRING_H__
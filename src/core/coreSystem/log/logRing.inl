@@ -0,0 +1,229 @@
+#ifndef __CORESYSTEM_LOGRING_INL__
+#define __CORESYSTEM_LOGRING_INL__
+
+namespace uge::log
+{
+    UGE_INLINE LogRing::LogRing(UInt32 threadId)
+        : m_head(0),
+          m_cachedTail(0),
+          m_reservedOffset(0),
+          m_threadId(threadId),
+          m_flushSequence(0),
+          m_tailState(0),
+          m_peekedState(0),
+          m_cachedHead(0),
+          m_peekedSize(0),
+          m_completedFlush(0),
+          m_released(0)
+    {
+    }
+
+    UGE_INLINE LogRing::~LogRing()
+    {
+    }
+
+    /**
+     * @brief Reserves contiguous room for a record of up to size bytes. Only the owning thread may call this.
+     *
+     * @param size The maximum number of bytes the record may use.
+     * @return Pointer to the record's storage, or nullptr if the ring doesn't have enough room.
+     */
+    UGE_FORCE_INLINE void *LogRing::Reserve(UInt32 size)
+    {
+        const UInt32 head = static_cast<UInt32>(m_head);
+        const UInt32 offset = head & c_logRingMask;
+        const UInt32 recordSize = GetRecordSize(size);
+
+        // Records never straddle the end of the buffer, skip the remainder when it's too small.
+        const UInt32 skipSize = c_logRingSize - offset < recordSize ? c_logRingSize - offset : 0;
+        const UInt32 requiredSize = skipSize + recordSize;
+
+        if (c_logRingSize - (head - m_cachedTail) < requiredSize)
+        {
+            m_cachedTail = static_cast<UInt32>(atomic::Atomic64::Fetch(&m_tailState));
+            if (c_logRingSize - (head - m_cachedTail) < requiredSize)
+            {
+                return nullptr;
+            }
+        }
+
+        if (skipSize != 0)
+        {
+            *reinterpret_cast<UInt32 *>(m_buffer + offset) = c_logRecordWrap;
+        }
+
+        m_reservedOffset = skipSize != 0 ? 0 : offset;
+        return m_buffer + m_reservedOffset + c_logRecordHeaderSize;
+    }
+
+    /**
+     * @brief Publishes the record returned by the last Reserve.
+     *
+     * @param size The number of bytes actually written, at most the size passed to Reserve.
+     */
+    UGE_FORCE_INLINE void LogRing::Commit(UInt32 size)
+    {
+        const UInt32 head = static_cast<UInt32>(m_head);
+        const UInt32 recordSize = GetRecordSize(size);
+        const UInt32 skipSize = m_reservedOffset != (head & c_logRingMask) ? c_logRingSize - (head & c_logRingMask) : 0;
+
+        *reinterpret_cast<UInt32 *>(m_buffer + m_reservedOffset) = recordSize;
+        atomic::Atomic32::Store(&m_head, head + skipSize + recordSize);
+    }
+
+    /**
+     * @brief Evicts the oldest record to make room. Only the owning thread may call this.
+     *
+     * @return true if a record was evicted, false if the ring is empty or the log thread is reading the oldest record.
+     */
+    UGE_INLINE Bool LogRing::DropOldest()
+    {
+        for (;;)
+        {
+            const UInt64 state = static_cast<UInt64>(atomic::Atomic64::Fetch(&m_tailState));
+            const UInt32 tail = static_cast<UInt32>(state);
+            if ((state & c_logTailPinned) != 0 || tail == static_cast<UInt32>(m_head))
+            {
+                return false;
+            }
+
+            const UInt32 offset = tail & c_logRingMask;
+            const UInt32 recordSize = *reinterpret_cast<const UInt32 *>(m_buffer + offset);
+            const UInt32 advance = recordSize == c_logRecordWrap ? c_logRingSize - offset : recordSize;
+            const UInt64 newState = static_cast<UInt32>(tail + advance);
+
+            if (atomic::Atomic64::CompareExchange(&m_tailState, newState, state) == static_cast<AtomicLong>(state) && recordSize != c_logRecordWrap)
+            {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the oldest record of the ring without removing or pinning it, or nullptr if the
+     * ring is empty. The record may be evicted by the producer at any time, so it's only good for
+     * peeking at its header. Only the log thread may call this.
+     */
+    UGE_FORCE_INLINE const void *LogRing::Peek()
+    {
+        for (;;)
+        {
+            const UInt64 state = static_cast<UInt64>(atomic::Atomic64::Fetch(&m_tailState));
+            const UInt32 tail = static_cast<UInt32>(state);
+
+            // DropOldest may have moved the tail past the cached head, which is then stale too.
+            if (static_cast<Int32>(m_cachedHead - tail) <= 0)
+            {
+                m_cachedHead = static_cast<UInt32>(atomic::Atomic32::Fetch(&m_head));
+                if (tail == m_cachedHead)
+                {
+                    return nullptr;
+                }
+            }
+
+            const UInt32 offset = tail & c_logRingMask;
+            const UInt32 recordSize = *reinterpret_cast<const UInt32 *>(m_buffer + offset);
+            if (recordSize != c_logRecordWrap)
+            {
+                m_peekedState = state;
+                m_peekedSize = recordSize;
+                return m_buffer + offset + c_logRecordHeaderSize;
+            }
+
+            const UInt64 newState = static_cast<UInt32>(tail + c_logRingSize - offset);
+            atomic::Atomic64::CompareExchange(&m_tailState, newState, state);
+        }
+    }
+
+    /**
+     * @brief Returns the oldest record of the ring and pins it so the producer can't evict it until
+     * Pop, or nullptr if the ring is empty. Only the log thread may call this.
+     */
+    UGE_FORCE_INLINE const void *LogRing::Acquire()
+    {
+        for (;;)
+        {
+            const void *record = Peek();
+            if (record == nullptr)
+            {
+                return nullptr;
+            }
+
+            const UInt64 pinnedState = m_peekedState | c_logTailPinned;
+            if (atomic::Atomic64::CompareExchange(&m_tailState, pinnedState, m_peekedState) == static_cast<AtomicLong>(m_peekedState))
+            {
+                return record;
+            }
+        }
+    }
+
+    /**
+     * @brief Releases the record returned by the last Acquire back to the producer.
+     */
+    UGE_FORCE_INLINE void LogRing::Pop()
+    {
+        const UInt64 newState = static_cast<UInt32>(static_cast<UInt32>(m_peekedState) + m_peekedSize);
+        atomic::Atomic64::Store(&m_tailState, newState);
+    }
+
+    /**
+     * @brief Returns the bytes queued from the record returned by the last Acquire on. Only the log
+     * thread may call this.
+     */
+    UGE_FORCE_INLINE UInt32 LogRing::GetQueuedSize() const
+    {
+        return static_cast<UInt32>(atomic::Atomic32::Fetch(const_cast<AtomicInt *>(&m_head))) - static_cast<UInt32>(m_peekedState);
+    }
+
+    UGE_INLINE UInt32 LogRing::GetThreadId() const
+    {
+        return m_threadId;
+    }
+
+    /**
+     * @brief Returns the sequence of the next flush marker queued by the producer. Markers are sunk
+     * in ring order, so waiting for one is waiting for GetCompletedFlush to reach its sequence.
+     */
+    UGE_INLINE UInt64 LogRing::NextFlushSequence()
+    {
+        return ++m_flushSequence;
+    }
+
+    /**
+     * @brief Called by the consumer once the sinks have been flushed for a marker of this ring.
+     */
+    UGE_INLINE void LogRing::CompleteFlush(UInt64 sequence)
+    {
+        atomic::Atomic64::Store(&m_completedFlush, static_cast<AtomicLong>(sequence));
+    }
+
+    UGE_INLINE UInt64 LogRing::GetCompletedFlush() const
+    {
+        return static_cast<UInt64>(atomic::Atomic64::Fetch(const_cast<AtomicLong *>(&m_completedFlush)));
+    }
+
+    /**
+     * @brief Gives up an owner's hold on a heap allocated ring, the last owner to let go deletes it.
+     * The producer lets go when its thread exits, the CLog once the ring is drained or when destroyed.
+     */
+    UGE_INLINE void LogRing::Release(LogRingOwner owner)
+    {
+        const UInt32 released = static_cast<UInt32>(atomic::Atomic32::Or(&m_released, static_cast<AtomicInt>(owner))) | owner;
+        if (released == (LogRingOwner_Producer | LogRingOwner_Log))
+        {
+            delete this;
+        }
+    }
+
+    UGE_INLINE Bool LogRing::IsReleasedBy(LogRingOwner owner) const
+    {
+        return (static_cast<UInt32>(atomic::Atomic32::Fetch(const_cast<AtomicInt *>(&m_released))) & owner) != 0;
+    }
+
+    UGE_FORCE_INLINE UInt32 LogRing::GetRecordSize(UInt32 size)
+    {
+        return (c_logRecordHeaderSize + size + c_logRecordAlignment - 1) & ~(c_logRecordAlignment - 1);
+    }
+}
+
+#endif // __CORESYSTEM_LOGRING_INL__
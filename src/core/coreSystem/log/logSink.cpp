@@ -1,9 +1,59 @@
 #include "build.h"
+#include "logLine.h"
 #include "logSink.h"
 
 namespace uge::log
 {
+    LogSink::LogSink()
+        : m_level(LogLevel_Trace), m_categoryMask(UINT64_MAX), m_bytesWritten(0), m_sinkTimeUs(0)
+    {
+    }
+
     LogSink::~LogSink()
     {
     }
-}
\ No newline at end of file
+
+    /**
+     * @brief Sinks a batch of messages. The default implementation forwards each message to SinkLog,
+     * sinks that can consume the batch at once should override it.
+     *
+     * @param batch The messages to sink.
+     */
+    void LogSink::SinkLogBatch(const LogBatch &batch)
+    {
+        char formattedMsg[c_logFormattedLineSize];
+
+        for (UInt32 i = 0; i != batch.m_count; ++i)
+        {
+            const LogBatchEntry &entry = batch.m_entries[i];
+            Memcpy(formattedMsg, entry.m_text, entry.m_length);
+            formattedMsg[entry.m_length] = '\0';
+
+            SinkLog(formattedMsg, *entry.m_logLine);
+        }
+    }
+
+    /**
+     * @brief Sets the least severe level and the categories, one bit per LogCategory, the sink accepts.
+     */
+    void LogSink::SetFilter(LogLevel level, UInt64 categoryMask)
+    {
+        m_level = level;
+        m_categoryMask = categoryMask;
+    }
+
+    LogLevel LogSink::GetLevel() const
+    {
+        return m_level;
+    }
+
+    UInt64 LogSink::GetCategoryMask() const
+    {
+        return m_categoryMask;
+    }
+
+    Bool LogSink::Accepts(LogLevel level, LogCategory category) const
+    {
+        return level <= m_level && (m_categoryMask & (1ull << category)) != 0;
+    }
+}
@@ -1,18 +1,62 @@
 #ifndef __CORESYSTEM_LOGSINK_H__
 #define __CORESYSTEM_LOGSINK_H__
 
+#include "logLine.h"
+
 namespace uge::log
 {
-    struct LogLine;
+    /**
+     * @brief A message of a LogBatch. m_text points into LogBatch::m_text and isn't null terminated.
+     */
+    struct LogBatchEntry
+    {
+        const LogLine *m_logLine;
+        const char *m_text;
+        UInt32 m_length;
+    };
+
+    /**
+     * @brief Messages handed to the sinks in one call. The formatted lines are stored back to back
+     * in m_text, so a sink can write the whole batch at once.
+     */
+    struct LogBatch
+    {
+        const LogBatchEntry *m_entries;
+        UInt32 m_count;
+        const char *m_text;
+        UInt32 m_textLength;
+    };
 
+    /**
+     * @brief Receives the formatted messages its filter accepts. The filter is read when the sink is
+     * registered, call CLog::UpdateSinkFilters after changing the filter of a registered sink.
+     */
     class CORESYSTEM_API LogSink
     {
     public:
+        LogSink();
+
         virtual void SinkLog(const char *formattedMsg, const LogLine &logLine) = 0;
+        virtual void SinkLogBatch(const LogBatch &batch);
         virtual void Flush() = 0;
 
+        void SetFilter(LogLevel level, UInt64 categoryMask = UINT64_MAX);
+        LogLevel GetLevel() const;
+        UInt64 GetCategoryMask() const;
+        Bool Accepts(LogLevel level, LogCategory category) const;
+
     protected:
         virtual ~LogSink();
+
+    private:
+        friend class CLog;
+
+        LogLevel m_level;
+        UInt64 m_categoryMask;
+
+        // Text handed to the sink and time spent in it, updated by the log thread, see CLog::GetStats.
+        UInt64 m_bytesWritten;
+        UInt64 m_sinkTimeUs;
     };
 }
 
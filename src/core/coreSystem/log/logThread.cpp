@@ -28,6 +28,7 @@ namespace uge::log
     void LogThread::Stop()
     {
         m_running = false;
+        m_log->WakeLogThread();
         Thread::Join();
     }
 
@@ -39,6 +40,14 @@ namespace uge::log
             {
                 continue;
             }
+
+            m_log->WaitForLogs();
+        }
+
+        // Drain what was queued before Stop, the flush pushed by CLog::Deinit included.
+        while (m_log->ConsumeNextLog())
+        {
+            continue;
         }
     }
 }
\ No newline at end of file
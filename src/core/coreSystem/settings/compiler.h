@@ -1,15 +1,28 @@
 #ifndef __CORESYSTEM_COMPILER_H__
 #define __CORESYSTEM_COMPILER_H__
 
+#if defined( _MSC_VER )
+    #define UGE_COMPILER_MSVC 1
+#elif defined( __GNUC__ ) || defined( __clang__ )
+    #define UGE_COMPILER_GCC 1
+#else
+    #error "Unsupported compiler"
+#endif
+
 #define UGE_FUNCTION __FUNCTION__
 
+#if defined( UGE_COMPILER_MSVC )
 #define UGE_ALIGN(alignment)                        __declspec(align(alignment))
+#elif defined( UGE_COMPILER_GCC )
+#define UGE_ALIGN(alignment)                        __attribute__((aligned(alignment)))
+#endif
 
 #define UGE_ALIGNED_CLASS(type, alignment)          class UGE_ALIGN(alignment) type
 #define UGE_ALIGNED_STRUCT(type, alignment)         struct UGE_ALIGN(alignment) type
 #define UGE_ALIGNED_VAR(type, alignment)            UGE_ALIGN(alignment) type
 #define UGE_ALIGNED_TYPEDEF(type, alignment, name)  typedef UGE_ALIGN(alignment) type name
 
+#if defined( UGE_COMPILER_MSVC )
 #define UGE_NOINLINE                __declspec( noinline )
 #define UGE_INLINE                  inline
 #define UGE_FORCE_INLINE            __forceinline
@@ -23,4 +36,30 @@
 #define UGE_FASTCALL                __fastcall
 #define UGE_VECTORCALL              __vectorcall
 
-#endif
\ No newline at end of file
+#define UGE_DLLEXPORT               __declspec( dllexport )
+#define UGE_DLLIMPORT               __declspec( dllimport )
+
+#define UGE_DEBUG_BREAK()           __debugbreak()
+#elif defined( UGE_COMPILER_GCC )
+#define UGE_NOINLINE                __attribute__(( noinline ))
+#define UGE_INLINE                  inline
+#define UGE_FORCE_INLINE            inline __attribute__(( always_inline ))
+
+#define UGE_RESTRICT_RETURN         __attribute__(( malloc ))
+#define UGE_RESTRICT_PARAMS
+#define UGE_RESTRICT_LOCAL          __restrict
+
+// The calling conventions only mean something on 32-bit x86.
+#define UGE_CDECL
+#define UGE_STDCALL
+#define UGE_FASTCALL
+#define UGE_VECTORCALL
+
+#define UGE_DLLEXPORT               __attribute__(( visibility( "default" ) ))
+#define UGE_DLLIMPORT
+
+// Like __debugbreak without a debugger attached, ends the process through the crash handler.
+#define UGE_DEBUG_BREAK()           __builtin_trap()
+#endif
+
+#endif
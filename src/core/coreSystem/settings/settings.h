@@ -1,6 +1,15 @@
 #ifndef __CORESYSTEM_SETTINGS_H__
 #define __CORESYSTEM_SETTINGS_H__
 
+// Platform backend of the threads module: Win32 on Windows, pthreads and futexes on Linux.
+#if defined( _WIN32 )
+    #define UGE_PLATFORM_WINDOWS 1
+#elif defined( __linux__ )
+    #define UGE_PLATFORM_LINUX 1
+#else
+    #error "Unsupported platform"
+#endif
+
 #if defined( UGE_DEBUG )
     #define UGE_LOG_ENABLED 1
     #define UGE_ASSERTS_ENABLED 1
@@ -9,4 +18,24 @@
     #define UGE_ASSERTS_ENABLED 0
 #endif
 
+// Least severe log level compiled in, UGE_LOG_* calls below it vanish from the binary.
+#ifndef UGE_LOG_MIN_LEVEL
+    #define UGE_LOG_MIN_LEVEL uge::log::LogLevel_Trace
+#endif
+
+// Log categories compiled in, one bit per uge::log::LogCategory.
+#ifndef UGE_LOG_CATEGORY_MASK
+    #define UGE_LOG_CATEGORY_MASK 0xFFFFFFFFFFFFFFFFull
+#endif
+
+// Per call site budget of UGE_LOG_* calls below Error: bursts of UGE_LOG_RATE_LIMIT_BURST messages,
+// refilled at UGE_LOG_RATE_LIMIT_PER_SECOND messages per second. A rate of 0 (default) disables the limit.
+#ifndef UGE_LOG_RATE_LIMIT_PER_SECOND
+    #define UGE_LOG_RATE_LIMIT_PER_SECOND 0
+#endif
+
+#ifndef UGE_LOG_RATE_LIMIT_BURST
+    #define UGE_LOG_RATE_LIMIT_BURST 100
+#endif
+
 #endif  // __CORESYSTEM_SETTINGS_H__
\ No newline at end of file
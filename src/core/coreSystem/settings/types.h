@@ -1,7 +1,12 @@
 #ifndef __CORESYSTEM_TYPES_H__
 #define __CORESYSTEM_TYPES_H__
 
+#if defined( UGE_PLATFORM_WINDOWS )
 #include <Windows.h>
+#endif
+#include <algorithm>
+#include <cstdarg>
+#include <cstddef>
 #include <cstdint>
 #include <cinttypes>
 
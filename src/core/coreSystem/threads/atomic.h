@@ -1,12 +1,17 @@
 #ifndef __CORESYSTEM_ATOMIC_H__
 #define __CORESYSTEM_ATOMIC_H__
 
+#if defined( UGE_COMPILER_MSVC )
 #include <intrin.h>
+#elif defined( __x86_64__ ) || defined( __i386__ )
+#include <immintrin.h>
+#endif
 
 namespace uge
 {
     namespace atomic
     {
+#if defined( UGE_COMPILER_MSVC )
         struct Atomic8
         {
             UGE_ALIGNED_TYPEDEF( Byte, 1, TAtomic8 );
@@ -50,6 +55,11 @@ namespace uge
             {
                 return *(volatile TAtomic8*)(destination);
             }
+
+            UGE_FORCE_INLINE static void Store( TAtomic8 volatile* destination, TAtomic8 value )
+            {
+                *(volatile TAtomic8*)(destination) = value;
+            }
         };
         struct Atomic16
         {
@@ -94,6 +104,11 @@ namespace uge
             {
                 return *(volatile TAtomic16*)(destination);
             }
+
+            UGE_FORCE_INLINE static void Store( TAtomic16 volatile* destination, TAtomic16 value )
+            {
+                *(volatile TAtomic16*)(destination) = value;
+            }
         };
         struct Atomic32
         {
@@ -138,6 +153,11 @@ namespace uge
             {
                 return *(volatile TAtomic32*)(destination);
             }
+
+            UGE_FORCE_INLINE static void Store( TAtomic32 volatile* destination, TAtomic32 value )
+            {
+                *(volatile TAtomic32*)(destination) = value;
+            }
         };
         struct Atomic64
         {
@@ -182,6 +202,11 @@ namespace uge
             {
                 return *(volatile TAtomic64*)(destination);
             }
+
+            UGE_FORCE_INLINE static void Store( TAtomic64 volatile* destination, TAtomic64 value )
+            {
+                *(volatile TAtomic64*)(destination) = value;
+            }
         };
         struct AtomicPtr
         {
@@ -201,7 +226,135 @@ namespace uge
             {
                 return *(volatile TAtomicPtr*)(destination);
             }
+
+            UGE_FORCE_INLINE static void Store( TAtomicPtr volatile* destination, TAtomicPtr value )
+            {
+                *(volatile TAtomicPtr*)(destination) = value;
+            }
         };
+
+        // Full fence: unlike the Interlocked calls it doesn't touch any shared cache line.
+        UGE_FORCE_INLINE void MemoryFence()
+        {
+            ::MemoryBarrier();
+        }
+
+        // Spin-wait hint: lets the sibling hyperthread run and avoids the memory order flush on loop exit.
+        UGE_FORCE_INLINE void Pause()
+        {
+            ::_mm_pause();
+        }
+#elif defined( UGE_COMPILER_GCC )
+        namespace priv
+        {
+            // The Interlocked contract: read-modify-writes are full barriers, Fetch acquires and Store
+            // releases like volatile accesses do under MSVC.
+            template<typename TAtomic>
+            struct AtomicOps
+            {
+                UGE_FORCE_INLINE static TAtomic Increment( TAtomic volatile* addend )
+                {
+                    return __atomic_add_fetch( addend, 1, __ATOMIC_SEQ_CST );
+                }
+
+                UGE_FORCE_INLINE static TAtomic Decrement( TAtomic volatile* addend )
+                {
+                    return __atomic_sub_fetch( addend, 1, __ATOMIC_SEQ_CST );
+                }
+
+                UGE_FORCE_INLINE static TAtomic Exchange( TAtomic volatile* target, TAtomic value )
+                {
+                    return __atomic_exchange_n( target, value, __ATOMIC_SEQ_CST );
+                }
+
+                UGE_FORCE_INLINE static TAtomic CompareExchange( TAtomic volatile* destination, TAtomic exchange, TAtomic comparand )
+                {
+                    (void)__atomic_compare_exchange_n( destination, &comparand, exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST );
+                    return comparand;
+                }
+
+                UGE_FORCE_INLINE static TAtomic ExchangeAdd( TAtomic volatile* addend, TAtomic value )
+                {
+                    return __atomic_fetch_add( addend, value, __ATOMIC_SEQ_CST );
+                }
+
+                UGE_FORCE_INLINE static TAtomic Or( TAtomic volatile* destination, TAtomic value )
+                {
+                    return __atomic_fetch_or( destination, value, __ATOMIC_SEQ_CST );
+                }
+
+                UGE_FORCE_INLINE static TAtomic And( TAtomic volatile* destination, TAtomic value )
+                {
+                    return __atomic_fetch_and( destination, value, __ATOMIC_SEQ_CST );
+                }
+
+                UGE_FORCE_INLINE static TAtomic Fetch( TAtomic volatile* destination )
+                {
+                    return __atomic_load_n( destination, __ATOMIC_ACQUIRE );
+                }
+
+                UGE_FORCE_INLINE static void Store( TAtomic volatile* destination, TAtomic value )
+                {
+                    __atomic_store_n( destination, value, __ATOMIC_RELEASE );
+                }
+            };
+        }
+
+        struct Atomic8 : priv::AtomicOps<Byte>
+        {
+            UGE_ALIGNED_TYPEDEF( Byte, 1, TAtomic8 );
+        };
+        struct Atomic16 : priv::AtomicOps<Int16>
+        {
+            UGE_ALIGNED_TYPEDEF( Int16, 2, TAtomic16 );
+        };
+        struct Atomic32 : priv::AtomicOps<Int32>
+        {
+            UGE_ALIGNED_TYPEDEF( Int32, 4, TAtomic32 );
+        };
+        struct Atomic64 : priv::AtomicOps<Int64>
+        {
+            UGE_ALIGNED_TYPEDEF( Int64, 8, TAtomic64 );
+        };
+        struct AtomicPtr
+        {
+            UGE_ALIGNED_TYPEDEF( void*, 8, TAtomicPtr );
+
+            UGE_FORCE_INLINE static TAtomicPtr Exchange( TAtomicPtr volatile* target, TAtomicPtr value )
+            {
+                return priv::AtomicOps<void*>::Exchange( target, value );
+            }
+
+            UGE_FORCE_INLINE static TAtomicPtr CompareExchange( TAtomicPtr volatile* destination, TAtomicPtr exchange, TAtomicPtr comparand )
+            {
+                return priv::AtomicOps<void*>::CompareExchange( destination, exchange, comparand );
+            }
+
+            UGE_FORCE_INLINE static TAtomicPtr Fetch( TAtomicPtr volatile* destination )
+            {
+                return priv::AtomicOps<void*>::Fetch( destination );
+            }
+
+            UGE_FORCE_INLINE static void Store( TAtomicPtr volatile* destination, TAtomicPtr value )
+            {
+                priv::AtomicOps<void*>::Store( destination, value );
+            }
+        };
+
+        UGE_FORCE_INLINE void MemoryFence()
+        {
+            __atomic_thread_fence( __ATOMIC_SEQ_CST );
+        }
+
+        UGE_FORCE_INLINE void Pause()
+        {
+#if defined( __x86_64__ ) || defined( __i386__ )
+            ::_mm_pause();
+#elif defined( __aarch64__ )
+            __asm__ __volatile__( "yield" );
+#endif
+        }
+#endif
     }
 
     typedef atomic::Atomic8::TAtomic8 AtomicByte;
@@ -0,0 +1,60 @@
+#include "build.h"
+
+#include "bigReaderLock.h"
+
+namespace uge
+{
+    /**
+     * @brief Acquires the write lock: takes the writer flag, which holds off new readers, then waits
+     * for the readers in every slot to leave.
+     */
+    void BigReaderLock::Lock()
+    {
+        SpinBackoff backoff;
+        while (atomic::Atomic32::CompareExchange(&m_writer, 1, 0) != 0)
+        {
+            backoff.Spin();
+        }
+
+        // The exchange orders the flag before the slot reads: a reader either sees the flag or is counted.
+        backoff.Reset();
+        while (HasReaders())
+        {
+            backoff.Spin();
+        }
+    }
+
+    /**
+     * @brief Attempts to acquire the write lock, fails if a writer or any reader holds it.
+     *
+     * @return true if the lock was acquired, false otherwise.
+     */
+    Bool BigReaderLock::TryLock()
+    {
+        if (atomic::Atomic32::CompareExchange(&m_writer, 1, 0) != 0)
+        {
+            return false;
+        }
+
+        if (HasReaders())
+        {
+            atomic::Atomic32::Exchange(&m_writer, 0);
+            return false;
+        }
+
+        return true;
+    }
+
+    Bool BigReaderLock::HasReaders() const
+    {
+        for (const ReaderSlot &slot : m_slots)
+        {
+            if (atomic::Atomic32::Fetch(const_cast<AtomicInt *>(&slot.m_readers)) != 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef __CORESYSTEM_BIGREADERLOCK_H__
+#define __CORESYSTEM_BIGREADERLOCK_H__
+
+#include "atomic.h"
+#include "spinBackoff.h"
+
+namespace uge
+{
+    /**
+     * @brief Reader-writer lock for read-mostly data: readers count themselves in one of several slots,
+     * each on its own cache line, so readers on different cores don't bounce a shared counter.
+     *
+     * A thread always uses the same slot, picked from its id. A writer flags itself, which holds off
+     * new readers, then waits for every slot to drain, so writes cost more the more slots there are.
+     */
+    class CORESYSTEM_API BigReaderLock
+    {
+    public:
+        BigReaderLock();
+        ~BigReaderLock();
+
+        void Lock();
+        void LockShared();
+        Bool TryLock();
+        Bool TryLockShared();
+
+        void Unlock();
+        void UnlockShared();
+
+    private:
+        constexpr static UInt32 c_SlotCount = 32;
+        constexpr static UInt32 c_CacheLineSize = 64;
+
+        struct ReaderSlot
+        {
+            UGE_ALIGNED_VAR(AtomicInt, c_CacheLineSize) m_readers;
+        };
+
+        static UInt32 GetSlotIndex();
+        Bool HasReaders() const;
+
+        UGE_ALIGNED_VAR(AtomicInt, c_CacheLineSize) m_writer;
+        ReaderSlot m_slots[c_SlotCount];
+    };
+}
+
+#include "bigReaderLock.inl"
+
+#endif // __CORESYSTEM_BIGREADERLOCK_H__
@@ -0,0 +1,74 @@
+#ifndef __CORESYSTEM_BIGREADERLOCK_INL__
+#define __CORESYSTEM_BIGREADERLOCK_INL__
+
+namespace uge
+{
+    UGE_INLINE BigReaderLock::BigReaderLock()
+        : m_writer(0)
+    {
+        for (ReaderSlot &slot : m_slots)
+        {
+            slot.m_readers = 0;
+        }
+    }
+
+    UGE_INLINE BigReaderLock::~BigReaderLock()
+    {
+    }
+
+    UGE_FORCE_INLINE UInt32 BigReaderLock::GetSlotIndex()
+    {
+        // Fibonacci hashing spreads the sequential thread ids over the slots.
+        return (ThreadId::GetCurrentThread().Get() * 2654435769u) >> 27;
+    }
+
+    UGE_FORCE_INLINE void BigReaderLock::LockShared()
+    {
+        AtomicInt *readers = &m_slots[GetSlotIndex()].m_readers;
+
+        SpinBackoff backoff;
+        for (;;)
+        {
+            // The interlocked increment orders the slot before the writer flag, see Lock.
+            atomic::Atomic32::Increment(readers);
+            if (atomic::Atomic32::Fetch(&m_writer) == 0)
+            {
+                return;
+            }
+
+            atomic::Atomic32::Decrement(readers);
+            while (atomic::Atomic32::Fetch(&m_writer) != 0)
+            {
+                backoff.Spin();
+            }
+        }
+    }
+
+    UGE_FORCE_INLINE Bool BigReaderLock::TryLockShared()
+    {
+        AtomicInt *readers = &m_slots[GetSlotIndex()].m_readers;
+
+        atomic::Atomic32::Increment(readers);
+        if (atomic::Atomic32::Fetch(&m_writer) == 0)
+        {
+            return true;
+        }
+
+        atomic::Atomic32::Decrement(readers);
+        return false;
+    }
+
+    UGE_FORCE_INLINE void BigReaderLock::UnlockShared()
+    {
+        const AtomicInt readers = atomic::Atomic32::Decrement(&m_slots[GetSlotIndex()].m_readers);
+        UGE_ASSERT(readers >= 0, "Invalid usage!");
+    }
+
+    UGE_INLINE void BigReaderLock::Unlock()
+    {
+        const AtomicInt oldValue = atomic::Atomic32::Exchange(&m_writer, 0);
+        UGE_ASSERT(oldValue == 1, "Invalid usage!");
+    }
+}
+
+#endif // __CORESYSTEM_BIGREADERLOCK_INL__
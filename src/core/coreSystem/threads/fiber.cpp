@@ -0,0 +1,89 @@
+#include "fiber.h"
+
+#if defined( UGE_PLATFORM_WINDOWS )
+namespace uge
+{
+    void WINAPI Fiber::FiberEntry( void* userData )
+    {
+        Fiber* fiber = reinterpret_cast<Fiber*>(userData);
+        fiber->m_function( fiber->m_userData );
+
+        UGE_ASSERT( false, "Fiber function returned!" );
+    }
+
+    Fiber::Fiber()
+        : m_fiber( nullptr )
+        , m_function( nullptr )
+        , m_userData( nullptr )
+        , m_isThread( false )
+    {
+    }
+
+    Fiber::~Fiber()
+    {
+        Deinit();
+    }
+
+    /**
+     * @brief Creates the fiber, it starts running function the first time it's switched to.
+     * 
+     * @param function The fiber's body, it must never return.
+     * @param userData Passed to function.
+     * @param stackSize Size of the fiber's stack, committed up front.
+     * @return true if the fiber was created.
+     */
+    Bool Fiber::Init( FiberFunction function, void* userData, UInt32 stackSize )
+    {
+        UGE_ASSERT( !IsValid(), "Fiber already initialized!" );
+
+        m_function = function;
+        m_userData = userData;
+        m_isThread = false;
+        m_fiber = ::CreateFiberEx( stackSize, stackSize, FIBER_FLAG_FLOAT_SWITCH, &Fiber::FiberEntry, this );
+        UGE_ASSERT( m_fiber, "Failed to create fiber!" );
+
+        return m_fiber != nullptr;
+    }
+
+    /**
+     * @brief Turns the calling thread into a fiber so it can switch to other fibers. Deinit turns it back.
+     * 
+     * @return true if the thread is now a fiber.
+     */
+    Bool Fiber::InitFromThread()
+    {
+        UGE_ASSERT( !IsValid(), "Fiber already initialized!" );
+
+        m_isThread = true;
+        m_fiber = ::ConvertThreadToFiberEx( nullptr, FIBER_FLAG_FLOAT_SWITCH );
+        UGE_ASSERT( m_fiber, "Failed to convert thread to fiber!" );
+
+        return m_fiber != nullptr;
+    }
+
+    void Fiber::Deinit()
+    {
+        if ( m_fiber )
+        {
+            if ( m_isThread )
+            {
+                (void)::ConvertFiberToThread();
+            }
+            else
+            {
+                ::DeleteFiber( m_fiber );
+            }
+            m_fiber = nullptr;
+        }
+    }
+
+    /**
+     * @brief Saves the running context in from and resumes to. from must be the fiber currently running.
+     */
+    void Fiber::Switch( Fiber& from, Fiber& to )
+    {
+        (void)from;
+        ::SwitchToFiber( to.m_fiber );
+    }
+}
+#endif
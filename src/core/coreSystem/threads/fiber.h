@@ -0,0 +1,61 @@
+#ifndef __CORESYSTEM_FIBER_H__
+#define __CORESYSTEM_FIBER_H__
+
+#include "threads.h"
+
+#if defined( UGE_PLATFORM_LINUX )
+#include <ucontext.h>
+#endif
+
+namespace uge
+{
+    typedef void (*FiberFunction)( void* userData );
+
+    //////////////////////////////////////////////////////////////////////////
+    // Fiber
+    //////////////////////////////////////////////////////////////////////////
+
+    /**
+     * @brief User-mode execution context with its own stack, switched to explicitly by the thread running it.
+     *
+     * A thread first turns itself into a fiber with InitFromThread, then switches between it and the
+     * fibers created with Init. A fiber function must never return, it switches to another fiber instead.
+     * A fiber may be resumed by another thread than the one it last ran on.
+     */
+    class CORESYSTEM_API Fiber
+    {
+        UGE_NOCLASSCOPY(Fiber)
+    private:
+#if defined( UGE_PLATFORM_WINDOWS )
+        static void WINAPI FiberEntry( void* userData );
+
+        void*           m_fiber;
+#elif defined( UGE_PLATFORM_LINUX )
+        // makecontext only passes ints.
+        static void FiberEntry( UInt32 high, UInt32 low );
+
+        ucontext_t      m_context;
+        UByte*          m_stack;
+        size_t          m_stackSize;
+#endif
+        FiberFunction   m_function;
+        void*           m_userData;
+        Bool            m_isThread;
+
+    public:
+        Fiber();
+        ~Fiber();
+
+        Bool Init( FiberFunction function, void* userData, UInt32 stackSize );
+        Bool InitFromThread();
+        void Deinit();
+
+        static void Switch( Fiber& from, Fiber& to );
+
+        UGE_INLINE Bool IsValid() const;
+    };
+}
+
+#include "fiber.inl"
+
+#endif // __CORESYSTEM_FIBER_H__
@@ -0,0 +1,13 @@
+#include "fiber.h"
+
+namespace uge
+{
+    UGE_INLINE Bool Fiber::IsValid() const
+    {
+#if defined( UGE_PLATFORM_WINDOWS )
+        return m_fiber != nullptr;
+#elif defined( UGE_PLATFORM_LINUX )
+        return m_isThread || m_stack != nullptr;
+#endif
+    }
+}
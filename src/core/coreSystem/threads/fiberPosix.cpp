@@ -0,0 +1,106 @@
+#include "fiber.h"
+
+#if defined( UGE_PLATFORM_LINUX )
+#include <sys/mman.h>
+
+namespace uge
+{
+    void Fiber::FiberEntry( UInt32 high, UInt32 low )
+    {
+        Fiber* fiber = reinterpret_cast<Fiber*>( ( static_cast<UInt64>( high ) << 32 ) | low );
+        fiber->m_function( fiber->m_userData );
+
+        UGE_ASSERT( false, "Fiber function returned!" );
+    }
+
+    Fiber::Fiber()
+        : m_context()
+        , m_stack( nullptr )
+        , m_stackSize( 0 )
+        , m_function( nullptr )
+        , m_userData( nullptr )
+        , m_isThread( false )
+    {
+    }
+
+    Fiber::~Fiber()
+    {
+        Deinit();
+    }
+
+    /**
+     * @brief Creates the fiber, it starts running function the first time it's switched to.
+     * 
+     * @param function The fiber's body, it must never return.
+     * @param userData Passed to function.
+     * @param stackSize Size of the fiber's stack, mapped up front below a guard page.
+     * @return true if the fiber was created.
+     */
+    Bool Fiber::Init( FiberFunction function, void* userData, UInt32 stackSize )
+    {
+        UGE_ASSERT( !IsValid(), "Fiber already initialized!" );
+
+        const size_t pageSize = static_cast<size_t>( ::sysconf( _SC_PAGESIZE ) );
+        const size_t mappedSize = ( ( stackSize + pageSize - 1 ) / pageSize + 1 ) * pageSize;
+
+        void* stack = ::mmap( nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+        UGE_ASSERT( stack != MAP_FAILED, "Failed to allocate fiber stack!" );
+        if ( stack == MAP_FAILED )
+        {
+            return false;
+        }
+
+        // The stack grows down, an overflow faults on the lowest page instead of corrupting memory.
+        (void)::mprotect( stack, pageSize, PROT_NONE );
+
+        m_function = function;
+        m_userData = userData;
+        m_isThread = false;
+        m_stack = static_cast<UByte*>( stack );
+        m_stackSize = mappedSize;
+
+        ::getcontext( &m_context );
+        m_context.uc_stack.ss_sp = m_stack + pageSize;
+        m_context.uc_stack.ss_size = mappedSize - pageSize;
+        m_context.uc_link = nullptr;
+
+        const UInt64 address = reinterpret_cast<UInt64>( this );
+        ::makecontext( &m_context, reinterpret_cast<void (*)()>( &Fiber::FiberEntry ), 2,
+                       static_cast<UInt32>( address >> 32 ), static_cast<UInt32>( address ) );
+        return true;
+    }
+
+    /**
+     * @brief Turns the calling thread into a fiber so it can switch to other fibers. Deinit turns it back.
+     * 
+     * @return true if the thread is now a fiber.
+     */
+    Bool Fiber::InitFromThread()
+    {
+        UGE_ASSERT( !IsValid(), "Fiber already initialized!" );
+
+        // The context is filled in by the first Switch away from the thread.
+        m_isThread = true;
+        return true;
+    }
+
+    void Fiber::Deinit()
+    {
+        if ( m_stack )
+        {
+            ::munmap( m_stack, m_stackSize );
+            m_stack = nullptr;
+            m_stackSize = 0;
+        }
+        m_isThread = false;
+    }
+
+    /**
+     * @brief Saves the running context in from and resumes to. from must be the fiber currently running.
+     */
+    void Fiber::Switch( Fiber& from, Fiber& to )
+    {
+        ::swapcontext( &from.m_context, &to.m_context );
+    }
+}
+#endif
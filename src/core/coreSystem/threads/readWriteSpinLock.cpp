@@ -6,44 +6,54 @@ namespace uge
 {
     /**
      * @brief Acquires a write lock on the RWSpinLock object.
-     * If the lock is already held by another thread, the function will spin until the lock is released.
+     * If the lock is held, the function flags a waiting writer, which holds off new readers, and spins until it's released.
      */
     void RWSpinLock::Lock()
     {
-        UInt32 spinCount = 0;
+        SpinBackoff backoff;
         for (;;)
         {
-            if (atomic::Atomic8::Fetch(&m_lock) == 0)
+            const AtomicInt value = atomic::Atomic32::Fetch(&m_lock);
+            if ((value & ~c_WriterWaiting) == 0)
             {
-                if (atomic::Atomic8::CompareExchange(&m_lock, c_WriteLockValue, c_UnlockValue) == c_UnlockValue)
+                // Clears the waiting bit, the other waiting writers set it again.
+                if (atomic::Atomic32::CompareExchange(&m_lock, c_WriterLocked, value) == value)
                 {
                     break;
                 }
+                continue;
             }
+
+            if ((value & c_WriterWaiting) == 0)
+            {
+                atomic::Atomic32::Or(&m_lock, c_WriterWaiting);
+            }
+
+            backoff.Spin();
         }
     }
 
     /**
      * @brief Acquires a shared lock on the read-write spin lock.
-     * If the lock is currently held by a writer, the calling thread will spin until the lock is released.
+     * If the lock is currently held by a writer, or a writer waits for it, the calling thread will spin until the writer is done.
      * If the lock is currently held by one or more readers, the calling thread will acquire a shared lock and proceed.
      */
     void RWSpinLock::LockShared()
     {
-        UInt32 spinCount = 0;
+        SpinBackoff backoff;
         for (;;)
         {
-            Byte expectedValue = atomic::Atomic8::Fetch(&m_lock);
-            if (expectedValue != c_WriteLockValue)
+            const AtomicInt expectedValue = atomic::Atomic32::Fetch(&m_lock);
+            if ((expectedValue & c_WriterMask) == 0)
             {
-                Byte desiredValue = 1 + expectedValue;
-                if (atomic::Atomic8::CompareExchange(&m_lock, desiredValue, expectedValue) == expectedValue)
+                if (atomic::Atomic32::CompareExchange(&m_lock, expectedValue + c_ReaderIncrement, expectedValue) == expectedValue)
                 {
                     break;
                 }
+                continue;
             }
 
-            YieldThread(spinCount);
+            backoff.Spin();
         }
     }
 
@@ -54,7 +64,8 @@ namespace uge
      */
     Bool RWSpinLock::TryLock()
     {
-        return atomic::Atomic8::CompareExchange(&m_lock, c_WriteLockValue, c_UnlockValue) == c_UnlockValue;
+        const AtomicInt value = atomic::Atomic32::Fetch(&m_lock);
+        return (value & ~c_WriterWaiting) == 0 && atomic::Atomic32::CompareExchange(&m_lock, c_WriterLocked, value) == value;
     }
 
     /**
@@ -64,33 +75,19 @@ namespace uge
      */
     Bool RWSpinLock::TryLockShared()
     {
-        Byte expectedValue = atomic::Atomic8::Fetch(&m_lock);
-        if (expectedValue != c_WriteLockValue)
+        for (;;)
         {
-            Byte desiredValue = 1 + expectedValue;
-            return atomic::Atomic8::CompareExchange(&m_lock, desiredValue, expectedValue) == expectedValue;
-        }
-
-        return false;
-    }
-
-    /**
-     * @brief This function yields the thread if the spin count exceeds the maximum spin count for sleep or yield.
-     * 
-     * @param spinCount The number of times the thread has spun without yielding or sleeping.
-     */
-    void RWSpinLock::YieldThread(UInt32 &spinCount)
-    {
-        ++spinCount;
+            const AtomicInt expectedValue = atomic::Atomic32::Fetch(&m_lock);
+            if ((expectedValue & c_WriterMask) != 0)
+            {
+                return false;
+            }
 
-        if (spinCount >= c_MaxSpinCountForSleep)
-        {
-            Thread_Sleep(1);
-            spinCount = 0;
-        }
-        else if (spinCount % c_MaxSpinCountForYield == 0)
-        {
-            Thread_Yield();
+            // Only fails on other readers coming and going, worth another try.
+            if (atomic::Atomic32::CompareExchange(&m_lock, expectedValue + c_ReaderIncrement, expectedValue) == expectedValue)
+            {
+                return true;
+            }
         }
     }
 }
@@ -2,9 +2,17 @@
 #define __CORESYSTEM_READWRITESPINLOCK_H__
 
 #include "atomic.h"
+#include "spinBackoff.h"
 
 namespace uge
 {
+    /**
+     * @brief Reader-writer spin lock preferring writers.
+     *
+     * One word holds the reader count and two writer bits: a waiting writer sets c_WriterWaiting, which
+     * keeps new readers out until it got the lock, so a steady stream of readers can't starve it.
+     * Waiters back off exponentially, then yield.
+     */
     class CORESYSTEM_API RWSpinLock
     {
     public:
@@ -20,19 +28,16 @@ namespace uge
         void UnlockShared();
 
     private:
-        constexpr static AtomicByte c_UnlockValue = 0;
-        constexpr static AtomicByte c_WriteLockValue = -1;
+        constexpr static AtomicInt c_UnlockValue = 0;
+        constexpr static AtomicInt c_WriterLocked = 1;
+        constexpr static AtomicInt c_WriterWaiting = 2;
+        constexpr static AtomicInt c_WriterMask = c_WriterLocked | c_WriterWaiting;
+        constexpr static AtomicInt c_ReaderIncrement = 4;
 
-        constexpr static UInt32 c_MaxYieldsForSleep = 32;
-        constexpr static UInt32 c_MaxSpinCountForYield = 512;
-        constexpr static UInt32 c_MaxSpinCountForSleep = c_MaxSpinCountForYield * c_MaxYieldsForSleep;
-
-        void YieldThread(UInt32& spinCount);
-
-        volatile AtomicByte m_lock;
+        volatile AtomicInt m_lock;
     };
 }
 
 #include "readWriteSpinLock.inl"
 
-#endif // __CORESYSTEM_READWRITESPINLOCK_H__
\ No newline at end of file
+#endif // __CORESYSTEM_READWRITESPINLOCK_H__
@@ -14,15 +14,16 @@ namespace uge
 
     UGE_INLINE void RWSpinLock::UnlockShared()
     {
-        const AtomicByte oldValue = atomic::Atomic8::ExchangeAdd( &m_lock, -1);
-        UGE_ASSERT( oldValue > 0, "Invalid usage!" );
+        const AtomicInt oldValue = atomic::Atomic32::ExchangeAdd( &m_lock, -c_ReaderIncrement);
+        UGE_ASSERT( oldValue >= c_ReaderIncrement, "Invalid usage!" );
     }
 
     UGE_INLINE void RWSpinLock::Unlock()
     {
-        const AtomicByte oldValue = atomic::Atomic8::Exchange( &m_lock, c_UnlockValue);
-        UGE_ASSERT( oldValue == c_WriteLockValue, "Invalid usage!" );
+        // Keeps the waiting bit another writer may have set meanwhile.
+        const AtomicInt oldValue = atomic::Atomic32::And( &m_lock, ~c_WriterLocked);
+        UGE_ASSERT( ( oldValue & c_WriterLocked ) != 0, "Invalid usage!" );
     }
 }
 
-#endif // __CORESYSTEM_READWRITESPINLOCK_INL__
\ No newline at end of file
+#endif // __CORESYSTEM_READWRITESPINLOCK_INL__
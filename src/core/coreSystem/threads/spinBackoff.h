@@ -0,0 +1,28 @@
+#ifndef __CORESYSTEM_SPINBACKOFF_H__
+#define __CORESYSTEM_SPINBACKOFF_H__
+
+namespace uge
+{
+    /**
+     * @brief Exponential backoff for spin loops: pauses twice as long after each failed attempt, then
+     * yields the time slice, then sleeps, so a waiter never keeps a core from the thread it waits on.
+     */
+    class SpinBackoff
+    {
+    public:
+        SpinBackoff();
+
+        void Spin();
+        void Reset();
+
+    private:
+        constexpr static UInt32 c_MaxPauseShift = 10;
+        constexpr static UInt32 c_MaxYieldsForSleep = 32;
+
+        UInt32 m_attempt;
+    };
+}
+
+#include "spinBackoff.inl"
+
+#endif // __CORESYSTEM_SPINBACKOFF_H__
@@ -0,0 +1,39 @@
+#ifndef __CORESYSTEM_SPINBACKOFF_INL__
+#define __CORESYSTEM_SPINBACKOFF_INL__
+
+namespace uge
+{
+    UGE_INLINE SpinBackoff::SpinBackoff()
+        : m_attempt(0)
+    {
+    }
+
+    UGE_INLINE void SpinBackoff::Spin()
+    {
+        if (m_attempt <= c_MaxPauseShift)
+        {
+            for (UInt32 i = 1u << m_attempt; i != 0; --i)
+            {
+                atomic::Pause();
+            }
+        }
+        else if (m_attempt <= c_MaxPauseShift + c_MaxYieldsForSleep)
+        {
+            Thread_Yield();
+        }
+        else
+        {
+            Thread_Sleep(1);
+            return;
+        }
+
+        ++m_attempt;
+    }
+
+    UGE_INLINE void SpinBackoff::Reset()
+    {
+        m_attempt = 0;
+    }
+}
+
+#endif // __CORESYSTEM_SPINBACKOFF_INL__
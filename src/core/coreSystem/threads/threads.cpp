@@ -1,5 +1,6 @@
 #include "threads.h"
 
+#if defined( UGE_PLATFORM_WINDOWS )
 namespace uge
 {
     /**
@@ -202,4 +203,5 @@ namespace uge
             UGE_CHECK_WINAPI(::SetThreadPriorityBoost( m_thread, disablePriorityBoost ));
         }
     }
-}
\ No newline at end of file
+}
+#endif
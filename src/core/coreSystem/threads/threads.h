@@ -3,6 +3,11 @@
 
 #include "debugging/dbgUtils.h"
 
+#if defined( UGE_PLATFORM_LINUX )
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #define UGE_NOCLASSCOPY(class_)     \
     private:                        \
         class_(const class_&);      \
@@ -12,12 +17,23 @@
     UGE_NOCLASSCOPY(struct_)            \
     public:                             
 
+#if defined( UGE_PLATFORM_WINDOWS )
 typedef DWORD       SpinCount_t;
 typedef DWORD       TimeoutMs_t;
 typedef DWORD       WaitResult_t;
 typedef HANDLE      Semaphore_t;
 typedef HANDLE      Thread_t;
 typedef DWORD_PTR   AffinityMask_t;
+#elif defined( UGE_PLATFORM_LINUX )
+#include <pthread.h>
+
+typedef uge::UInt32             SpinCount_t;
+typedef uge::UInt32             TimeoutMs_t;
+typedef uge::Int32              WaitResult_t;
+typedef const uge::AtomicInt*   Semaphore_t;
+typedef pthread_t               Thread_t;
+typedef uge::UInt64             AffinityMask_t;
+#endif
 
 namespace uge
 {
@@ -65,7 +81,12 @@ namespace uge
     {
         friend class ConditionVariable;
     private:
+#if defined( UGE_PLATFORM_WINDOWS )
         CRITICAL_SECTION    m_critSect;
+#elif defined( UGE_PLATFORM_LINUX )
+        // Recursive, like a critical section.
+        pthread_mutex_t     m_mutex;
+#endif
 
     public:
         Mutex();
@@ -85,7 +106,17 @@ namespace uge
     class Semaphore
     {
     private:
+#if defined( UGE_PLATFORM_WINDOWS )
         Semaphore_t m_semaphore;
+#elif defined( UGE_PLATFORM_LINUX )
+        // Futex word: acquiring only takes a syscall when the count is zero, releasing only when
+        // a thread waits on it.
+        AtomicInt   m_count;
+        AtomicInt   m_waiterCount;
+        Int32       m_maxCount;
+
+        Bool TryDecrement();
+#endif
 
     public:
         Semaphore( Int32 initialCount, Int32 maxCount );
@@ -94,7 +125,7 @@ namespace uge
     public:
         void Acquire();
         Bool TryAcquire( TimeoutMs_t  ms );
-        void Release(Int32 count);
+        Bool Release(Int32 count);
         const Semaphore_t Get() const;
     };
 
@@ -105,7 +136,11 @@ namespace uge
     class ConditionVariable
     {
     private:
+#if defined( UGE_PLATFORM_WINDOWS )
         CONDITION_VARIABLE m_condition;
+#elif defined( UGE_PLATFORM_LINUX )
+        pthread_cond_t m_condition;
+#endif
 
     public:
         ConditionVariable();
@@ -146,8 +181,18 @@ namespace uge
 
         void Init()
         {
+#if defined( UGE_PLATFORM_WINDOWS )
             Int64 value = __readgsqword( 0x30 );
             id = *reinterpret_cast<UInt32*>(value + 0x48);
+#elif defined( UGE_PLATFORM_LINUX )
+            // gettid is a syscall, ask once per thread.
+            static thread_local UInt32 s_threadId = 0;
+            if ( s_threadId == 0 )
+            {
+                s_threadId = static_cast<UInt32>( ::syscall( SYS_gettid ) );
+            }
+            id = s_threadId;
+#endif
         }
 
         UGE_INLINE Bool isValid() const
@@ -184,6 +229,15 @@ namespace uge
         Thread_t        m_thread;
         UInt32          m_stackSize;
         AnsiChar        m_threadName[g_MaxThreadNameLength];
+#if defined( UGE_PLATFORM_LINUX )
+        // Priorities are per thread nice values, set through the kernel id the thread publishes
+        // once started. Whichever of SetPriority and the thread comes second applies it.
+        AtomicInt       m_nativeId;
+        AtomicInt       m_priority;
+
+        static void* ThreadEntry( void* userData );
+        void ApplyPriority( Int32 nativeId, EThreadPriority threadPriority );
+#endif
 
     public:
         Thread( const AnsiChar* threadName, const UInt32 stackSize = g_kDefaultThreadStackSize );
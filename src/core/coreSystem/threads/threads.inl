@@ -28,6 +28,7 @@ namespace uge
         m_sharedLock.UnlockShared();
     }
 
+#if defined( UGE_PLATFORM_WINDOWS )
     // Mutex
     UGE_INLINE Mutex::Mutex()
     {
@@ -91,9 +92,10 @@ namespace uge
         return result == WAIT_OBJECT_0;
     }
 
-    UGE_INLINE void Semaphore::Release(Int32 count)
+    // Returns false, releasing nothing, if the count would exceed the maximum.
+    UGE_INLINE Bool Semaphore::Release(Int32 count)
     {
-        ::ReleaseSemaphore( m_semaphore, count, nullptr );
+        return ::ReleaseSemaphore( m_semaphore, count, nullptr ) != FALSE;
     }
 
     UGE_INLINE const Semaphore_t Semaphore::Get() const
@@ -130,9 +132,14 @@ namespace uge
     {
         ::WakeAllConditionVariable( &m_condition );
     }
+#endif
 
     UGE_INLINE const AnsiChar *uge::Thread::GetThreadName() const
     {
         return m_threadName;
     }
 }
+
+#if defined( UGE_PLATFORM_LINUX )
+#include "threadsPosix.inl"
+#endif
@@ -0,0 +1,211 @@
+#include "threads.h"
+
+#if defined( UGE_PLATFORM_LINUX )
+#include <sched.h>
+#include <sys/resource.h>
+#include <time.h>
+
+namespace uge
+{
+    /**
+     * @brief Yields the current thread's time slice to another thread that is ready to run.
+     * 
+     */
+    void Thread_Yield()
+    {
+        (void)::sched_yield();
+    }
+
+    /**
+     * @brief Suspends the execution of the current thread for a specified amount of time.
+     * 
+     * @param ms The time, in milliseconds, for which to suspend the execution of the current thread.
+     */
+    void Thread_Sleep( TimeoutMs_t ms )
+    {
+        timespec duration;
+        duration.tv_sec = static_cast<time_t>( ms / 1000 );
+        duration.tv_nsec = static_cast<long>( ms % 1000 ) * 1000000l;
+
+        // Resume after signals until the whole duration has elapsed.
+        while ( ::nanosleep( &duration, &duration ) != 0 && errno == EINTR )
+        {
+        }
+    }
+
+    static cpu_set_t ToCpuSet( AffinityMask_t affinityMask )
+    {
+        cpu_set_t cpuSet;
+        CPU_ZERO( &cpuSet );
+        for ( UInt32 cpu = 0; cpu != sizeof( affinityMask ) * 8; ++cpu )
+        {
+            if ( ( affinityMask & ( 1ull << cpu ) ) != 0 )
+            {
+                CPU_SET( cpu, &cpuSet );
+            }
+        }
+        return cpuSet;
+    }
+
+    /**
+     * @brief Sets the affinity mask for the current thread.
+     * 
+     * @param affinityMask The affinity mask to set for the current thread.
+     */
+    void Thread_SetAffinity( AffinityMask_t affinityMask )
+    {
+        if ( affinityMask != 0 )
+        {
+            const cpu_set_t cpuSet = ToCpuSet( affinityMask );
+            ::pthread_setaffinity_np( ::pthread_self(), sizeof( cpuSet ), &cpuSet );
+        }
+    }
+
+    /**
+     * @brief Names the current thread, as shown by debuggers and /proc. Linux keeps the first 15 characters.
+     */
+    void Thread_SetName( const AnsiChar* threadName )
+    {
+        if ( !threadName )
+        {
+            return;
+        }
+
+        AnsiChar name[16];
+        Strcpy( name, threadName, sizeof( name ), sizeof( name ) - 1 );
+        ::pthread_setname_np( ::pthread_self(), name );
+    }
+
+    /**
+     * @brief Not available with pthreads, a thread can't be stopped from another one.
+     */
+    void Thread_Suspend( ThreadId id )
+    {
+        UGE_ASSERT( false, "Thread_Suspend isn't supported on this platform" );
+    }
+
+    /**
+     * @brief Not available with pthreads, see Thread_Suspend.
+     */
+    void Thread_Resume( ThreadId id )
+    {
+        UGE_ASSERT( false, "Thread_Resume isn't supported on this platform" );
+    }
+
+    // EThreadPriority as nice values. Raising the priority above Normal needs CAP_SYS_NICE and
+    // silently fails without it.
+    static const Int32 g_threadPriorityNice[] = { 19, 10, 5, 0, -5, -10, -20 };
+
+    void* Thread::ThreadEntry( void* userData )
+    {
+        Thread* thread = reinterpret_cast<Thread*>(userData);
+        UGE_ASSERT( thread, "Thread is null!" );
+
+        if (thread)
+        {
+            Thread_SetName( thread->GetThreadName() );
+
+            const Int32 nativeId = static_cast<Int32>( ThreadId::GetCurrentThread().Get() );
+            atomic::Atomic32::Exchange( &thread->m_nativeId, nativeId );
+            thread->ApplyPriority( nativeId, static_cast<EThreadPriority>( atomic::Atomic32::Fetch( &thread->m_priority ) ) );
+
+            thread->ThreadFunc();
+        }
+
+        return nullptr;
+    }
+
+    Thread::Thread(const AnsiChar *threadName, const UInt32 stackSize)
+        : m_thread()
+        , m_stackSize( stackSize )
+        , m_nativeId( 0 )
+        , m_priority( Normal )
+    {
+        UGE_ASSERT( threadName, "Thread name cannot be null!" );
+        UGE_ASSERT( Strlen( threadName ) <= g_MaxThreadNameLength, "Thread name cannot be longer than %d characters!", g_MaxThreadNameLength );
+
+        Strcpy( m_threadName, threadName, g_MaxThreadNameLength );
+    }
+
+    Thread::~Thread()
+    {
+    }
+
+    void Thread::Join()
+    {
+        if ( IsValid() )
+        {
+            const Int32 result = ::pthread_join( m_thread, nullptr );
+            UGE_ASSERT( result == 0, "Failed to wait for thread!" );
+            m_thread = Thread_t();
+            atomic::Atomic32::Exchange( &m_nativeId, 0 );
+        }
+    }
+
+    void Thread::Detach()
+    {
+        if ( IsValid() )
+        {
+            ::pthread_detach( m_thread );
+            m_thread = Thread_t();
+            atomic::Atomic32::Exchange( &m_nativeId, 0 );
+        }
+    }
+
+    void Thread::Init()
+    {
+        UGE_ASSERT( !IsValid(), "Thread already started!" );
+
+        pthread_attr_t attributes;
+        ::pthread_attr_init( &attributes );
+        ::pthread_attr_setstacksize( &attributes, std::max<size_t>( m_stackSize, PTHREAD_STACK_MIN ) );
+
+        const Int32 result = ::pthread_create( &m_thread, &attributes, &Thread::ThreadEntry, this );
+        UGE_ASSERT( result == 0, "Failed to create thread!" );
+        if ( result != 0 )
+        {
+            m_thread = Thread_t();
+        }
+
+        ::pthread_attr_destroy( &attributes );
+    }
+
+    void Thread::SetAffinityMask(AffinityMask_t mask)
+    {
+        UGE_ASSERT( IsValid(), "Thread is not valid!" );
+
+        if ( IsValid() )
+        {
+            const cpu_set_t cpuSet = ToCpuSet( mask );
+            ::pthread_setaffinity_np( m_thread, sizeof( cpuSet ), &cpuSet );
+        }
+    }
+
+    void Thread::SetPriority(EThreadPriority threadPriority)
+    {
+        UGE_ASSERT( IsValid(), "Thread is not valid!" );
+
+        // The exchanges order the store before the read of the id, see ThreadEntry.
+        atomic::Atomic32::Exchange( &m_priority, threadPriority );
+        const Int32 nativeId = atomic::Atomic32::Fetch( &m_nativeId );
+        if ( nativeId != 0 )
+        {
+            ApplyPriority( nativeId, threadPriority );
+        }
+    }
+
+    void Thread::SetPriorityBoost(Bool disablePriorityBoost)
+    {
+        // The Linux scheduler has no priority boost to disable.
+        (void)disablePriorityBoost;
+    }
+
+    void Thread::ApplyPriority( Int32 nativeId, EThreadPriority threadPriority )
+    {
+        if ( threadPriority >= Idle && threadPriority <= TimeCritical )
+        {
+            (void)::setpriority( PRIO_PROCESS, static_cast<id_t>( nativeId ), g_threadPriorityNice[threadPriority] );
+        }
+    }
+}
+#endif
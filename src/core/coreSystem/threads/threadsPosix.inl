@@ -0,0 +1,211 @@
+#include <errno.h>
+#include <linux/futex.h>
+#include <time.h>
+
+namespace uge
+{
+    namespace priv
+    {
+        /**
+         * @brief Sleeps until the futex word no longer holds expected, a wake, or the timeout.
+         *
+         * @param timeout Relative timeout, nullptr to wait forever.
+         */
+        UGE_FORCE_INLINE void FutexWait( const AtomicInt* word, Int32 expected, const timespec* timeout )
+        {
+            ::syscall( SYS_futex, word, FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0 );
+        }
+
+        UGE_FORCE_INLINE void FutexWake( const AtomicInt* word, Int32 count )
+        {
+            ::syscall( SYS_futex, word, FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0 );
+        }
+
+        UGE_FORCE_INLINE UInt64 GetMonotonicTimeNs()
+        {
+            timespec now;
+            ::clock_gettime( CLOCK_MONOTONIC, &now );
+            return static_cast<UInt64>( now.tv_sec ) * 1000000000ull + static_cast<UInt64>( now.tv_nsec );
+        }
+
+        UGE_FORCE_INLINE timespec ToTimespec( UInt64 ns )
+        {
+            timespec time;
+            time.tv_sec = static_cast<time_t>( ns / 1000000000ull );
+            time.tv_nsec = static_cast<long>( ns % 1000000000ull );
+            return time;
+        }
+    }
+
+    // Mutex
+    UGE_INLINE Mutex::Mutex()
+    {
+        pthread_mutexattr_t attributes;
+        ::pthread_mutexattr_init( &attributes );
+        ::pthread_mutexattr_settype( &attributes, PTHREAD_MUTEX_RECURSIVE );
+        ::pthread_mutex_init( &m_mutex, &attributes );
+        ::pthread_mutexattr_destroy( &attributes );
+    }
+
+    UGE_INLINE Mutex::~Mutex()
+    {
+        ::pthread_mutex_destroy( &m_mutex );
+    }
+
+    UGE_INLINE void Mutex::Lock()
+    {
+        ::pthread_mutex_lock( &m_mutex );
+    }
+
+    UGE_INLINE Bool Mutex::TryLock()
+    {
+        return ::pthread_mutex_trylock( &m_mutex ) == 0;
+    }
+
+    UGE_INLINE void Mutex::Unlock()
+    {
+        ::pthread_mutex_unlock( &m_mutex );
+    }
+
+    UGE_INLINE void Mutex::SetSpinCount( SpinCount_t count )
+    {
+        // glibc only spins on non-recursive mutexes.
+        (void)count;
+    }
+
+    // Semaphore
+    UGE_INLINE Semaphore::Semaphore( Int32 initialCount, Int32 maxCount )
+        : m_count( initialCount )
+        , m_waiterCount( 0 )
+        , m_maxCount( maxCount )
+    {
+        UGE_ASSERT( initialCount >= 0 && maxCount >= 0, "Invalid arguments");
+        UGE_ASSERT( initialCount <= maxCount, "Invalid arguments");
+    }
+
+    UGE_INLINE Semaphore::~Semaphore()
+    {
+    }
+
+    UGE_INLINE Bool Semaphore::TryDecrement()
+    {
+        for (;;)
+        {
+            const Int32 count = atomic::Atomic32::Fetch( &m_count );
+            if ( count <= 0 )
+            {
+                return false;
+            }
+
+            if ( atomic::Atomic32::CompareExchange( &m_count, count - 1, count ) == count )
+            {
+                return true;
+            }
+        }
+    }
+
+    UGE_INLINE void Semaphore::Acquire()
+    {
+        while ( !TryDecrement() )
+        {
+            // The increment orders the registration before the futex re-checks the count, see Release.
+            atomic::Atomic32::Increment( &m_waiterCount );
+            priv::FutexWait( &m_count, 0, nullptr );
+            atomic::Atomic32::Decrement( &m_waiterCount );
+        }
+    }
+
+    UGE_INLINE Bool Semaphore::TryAcquire( TimeoutMs_t ms )
+    {
+        if ( TryDecrement() )
+        {
+            return true;
+        }
+
+        const UInt64 deadline = priv::GetMonotonicTimeNs() + static_cast<UInt64>( ms ) * 1000000ull;
+        for (;;)
+        {
+            const UInt64 now = priv::GetMonotonicTimeNs();
+            if ( now >= deadline )
+            {
+                return TryDecrement();
+            }
+
+            const timespec timeout = priv::ToTimespec( deadline - now );
+            atomic::Atomic32::Increment( &m_waiterCount );
+            priv::FutexWait( &m_count, 0, &timeout );
+            atomic::Atomic32::Decrement( &m_waiterCount );
+
+            if ( TryDecrement() )
+            {
+                return true;
+            }
+        }
+    }
+
+    UGE_INLINE Bool Semaphore::Release( Int32 count )
+    {
+        // Like ReleaseSemaphore, a release past the maximum count is ignored and fails.
+        for (;;)
+        {
+            const Int32 current = atomic::Atomic32::Fetch( &m_count );
+            if ( current + count > m_maxCount )
+            {
+                return false;
+            }
+
+            if ( atomic::Atomic32::CompareExchange( &m_count, current + count, current ) == current )
+            {
+                break;
+            }
+        }
+
+        if ( atomic::Atomic32::Fetch( &m_waiterCount ) != 0 )
+        {
+            priv::FutexWake( &m_count, count );
+        }
+
+        return true;
+    }
+
+    UGE_INLINE const Semaphore_t Semaphore::Get() const
+    {
+        return &m_count;
+    }
+
+    // ConditionVariable
+    UGE_INLINE ConditionVariable::ConditionVariable()
+    {
+        pthread_condattr_t attributes;
+        ::pthread_condattr_init( &attributes );
+        ::pthread_condattr_setclock( &attributes, CLOCK_MONOTONIC );
+        ::pthread_cond_init( &m_condition, &attributes );
+        ::pthread_condattr_destroy( &attributes );
+    }
+
+    UGE_INLINE ConditionVariable::~ConditionVariable()
+    {
+        ::pthread_cond_destroy( &m_condition );
+    }
+
+    UGE_INLINE void ConditionVariable::Wait( Mutex& mtx )
+    {
+        ::pthread_cond_wait( &m_condition, &mtx.m_mutex );
+    }
+
+    UGE_INLINE void ConditionVariable::WaitTimeout( Mutex& mtx, TimeoutMs_t ms )
+    {
+        const timespec deadline = priv::ToTimespec( priv::GetMonotonicTimeNs() + static_cast<UInt64>( ms ) * 1000000ull );
+        ::pthread_cond_timedwait( &m_condition, &mtx.m_mutex, &deadline );
+    }
+
+    UGE_INLINE void ConditionVariable::WakeAny()
+    {
+        ::pthread_cond_signal( &m_condition );
+    }
+
+    UGE_INLINE void ConditionVariable::WakeAll()
+    {
+        ::pthread_cond_broadcast( &m_condition );
+    }
+}
@@ -8,6 +8,7 @@ using namespace uge;
 int main( int argc, char** argv )
 {
     log::InitLog();
+    jobs::InitJobSystem();
 
     log::GetLog().SetLevel( log::LogLevel_Trace );
 
@@ -19,10 +20,15 @@ int main( int argc, char** argv )
         {
             UGE_LOG_DEBUG( UGE_LOG_CATEGORY, "Hello %i", loop );
         }
+
+        // Coroutines that awaited ResumeOnMainThread only resume from here.
+        RunMainThreadTasks();
+
         uge::Thread_Sleep( 1 );
     }
 
+    jobs::DeinitJobSystem();
     log::DeinitLog();
 
     return 0;
-}
\ No newline at end of file
+}
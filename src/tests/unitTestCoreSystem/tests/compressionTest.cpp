@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "core/coreSystem/build.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/coreSystem/compression/lzCompression.h"
+
+namespace
+{
+    std::vector<uge::UByte> RoundTrip(const std::vector<uge::UByte> &data, uge::UInt32 &compressedSize)
+    {
+        std::vector<uge::UByte> compressed(uge::compression::LzCompressBound(static_cast<uge::UInt32>(data.size())));
+        compressedSize = uge::compression::LzCompress(data.data(), static_cast<uge::UInt32>(data.size()), compressed.data(), static_cast<uge::UInt32>(compressed.size()));
+
+        std::vector<uge::UByte> decompressed(data.size());
+        const uge::UInt32 size = uge::compression::LzDecompress(compressed.data(), compressedSize, decompressed.data(), static_cast<uge::UInt32>(decompressed.size()));
+        decompressed.resize(size != uge::compression::c_lzInvalid ? size : 0);
+        return decompressed;
+    }
+}
+
+TEST(LzCompressionTests, RoundTripsTextRunsAndNoise)
+{
+    std::vector<std::vector<uge::UByte>> inputs(5);
+
+    for (uge::UInt32 i = 0; i != 2000; ++i)
+    {
+        const std::string line = "[2024.01.01 12:00:00.000][Info] Entity " + std::to_string(i) + " moved to (1.000, 2.500, -3.250) in Sector_7\n";
+        inputs[0].insert(inputs[0].end(), line.begin(), line.end());
+    }
+
+    // Long runs make overlapping matches and lengths continued over several bytes.
+    inputs[1].assign(100000, 'a');
+
+    std::mt19937 random(1234);
+    for (uge::UInt32 i = 0; i != 70000; ++i)
+    {
+        inputs[2].push_back(static_cast<uge::UByte>(random()));
+    }
+
+    inputs[3] = {'x', 'y', 'z'};
+
+    uge::UInt32 compressedSize = 0;
+    for (const auto &input : inputs)
+    {
+        EXPECT_EQ(RoundTrip(input, compressedSize), input);
+        EXPECT_LE(compressedSize, uge::compression::LzCompressBound(static_cast<uge::UInt32>(input.size())));
+    }
+
+    RoundTrip(inputs[0], compressedSize);
+    EXPECT_LT(compressedSize, inputs[0].size() / 4);
+}
+
+TEST(LzCompressionTests, MalformedBlocksAreRejected)
+{
+    const std::string text = "abcabcabcabcabcabcabcabcabcabcabcabc and some literals at the end";
+    std::vector<uge::UByte> compressed(uge::compression::LzCompressBound(static_cast<uge::UInt32>(text.size())));
+    const uge::UInt32 compressedSize = uge::compression::LzCompress(reinterpret_cast<const uge::UByte *>(text.data()), static_cast<uge::UInt32>(text.size()), compressed.data(), static_cast<uge::UInt32>(compressed.size()));
+
+    std::vector<uge::UByte> output(text.size());
+    for (uge::UInt32 size = 0; size != compressedSize; ++size)
+    {
+        const uge::UInt32 decompressedSize = uge::compression::LzDecompress(compressed.data(), size, output.data(), static_cast<uge::UInt32>(output.size()));
+        EXPECT_TRUE(decompressedSize == uge::compression::c_lzInvalid || decompressedSize < text.size());
+    }
+
+    EXPECT_EQ(uge::compression::LzDecompress(compressed.data(), compressedSize, output.data(), static_cast<uge::UInt32>(output.size()) - 1), uge::compression::c_lzInvalid);
+
+    // An offset pointing before the start of the output.
+    const uge::UByte badOffset[] = {0x10, 'a', 0x05, 0x00, 0x00};
+    EXPECT_EQ(uge::compression::LzDecompress(badOffset, sizeof(badOffset), output.data(), static_cast<uge::UInt32>(output.size())), uge::compression::c_lzInvalid);
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "core/coreSystem/build.h"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    using namespace uge;
+    using namespace uge::jobs;
+
+    void EmptyJob(void *)
+    {
+    }
+
+    struct SliceJob
+    {
+        const Float *m_values;
+        UInt32 m_count;
+        Double m_sum;
+    };
+
+    void SumSliceJob(void *data)
+    {
+        SliceJob *slice = static_cast<SliceJob *>(data);
+        Double sum = 0.0;
+        for (UInt32 i = 0; i != slice->m_count; ++i)
+        {
+            sum += std::sqrt(static_cast<Double>(slice->m_values[i]));
+        }
+        slice->m_sum = sum;
+    }
+
+    Task<UInt32> LeafTask(UInt32 value)
+    {
+        co_return value;
+    }
+
+    Task<Double> MeasureTaskSpawnNs(UInt32 count)
+    {
+        UInt32 sum = 0;
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (UInt32 i = 0; i != count; ++i)
+        {
+            sum += co_await LeafTask(i);
+        }
+        const std::chrono::duration<Double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+        EXPECT_EQ(sum, count * (count - 1) / 2);
+        co_return elapsed.count() / count;
+    }
+
+    Task<Double> MeasureWorkerHopNs(UInt32 count)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (UInt32 i = 0; i != count; ++i)
+        {
+            co_await ResumeOnWorkers();
+        }
+        const std::chrono::duration<Double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - start;
+        co_return elapsed.count() / count;
+    }
+}
+
+TEST(JobsBenchmarks, SubmitExecute)
+{
+    const UInt32 c_jobCount = 1000000;
+    const UInt32 c_batchSize = 256;
+
+    JobSystem jobSystem;
+    jobSystem.Init();
+
+    std::vector<JobDecl> jobs(c_batchSize, JobDecl{EmptyJob, nullptr});
+    JobCounter counter;
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (UInt32 i = 0; i != c_jobCount / c_batchSize; ++i)
+    {
+        jobSystem.Run(jobs.data(), c_batchSize, &counter);
+        jobSystem.WaitForCounter(&counter);
+    }
+    const std::chrono::duration<Double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - start;
+    std::printf("[ BENCH    ] empty job submit+execute on %u workers: %.1f ns per job, %.2f M jobs/s\n",
+                jobSystem.GetWorkerCount(), elapsed.count() / c_jobCount, c_jobCount / elapsed.count() * 1000.0);
+
+    jobSystem.Deinit();
+}
+
+TEST(JobsBenchmarks, ParallelForScaling)
+{
+    const UInt32 c_valueCount = 8 * 1024 * 1024;
+    const UInt32 c_sliceCount = 512;
+    const UInt32 c_sliceSize = c_valueCount / c_sliceCount;
+
+    std::vector<Float> values(c_valueCount);
+    for (UInt32 i = 0; i != c_valueCount; ++i)
+    {
+        values[i] = static_cast<Float>(i & 1023);
+    }
+
+    Double singleWorkerMs = 0.0;
+    for (UInt32 workerCount = 1; workerCount <= JobSystem::GetHardwareThreadCount(); ++workerCount)
+    {
+        JobSystem jobSystem;
+        jobSystem.Init(workerCount);
+
+        std::vector<SliceJob> slices(c_sliceCount);
+        std::vector<JobDecl> jobs(c_sliceCount);
+        for (UInt32 i = 0; i != c_sliceCount; ++i)
+        {
+            slices[i] = SliceJob{values.data() + i * c_sliceSize, c_sliceSize, 0.0};
+            jobs[i] = JobDecl{SumSliceJob, &slices[i]};
+        }
+
+        JobCounter counter;
+        const auto start = std::chrono::high_resolution_clock::now();
+        jobSystem.Run(jobs.data(), c_sliceCount, &counter);
+        jobSystem.WaitForCounter(&counter);
+        const std::chrono::duration<Double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+        Double sum = 0.0;
+        for (const SliceJob &slice : slices)
+        {
+            sum += slice.m_sum;
+        }
+        EXPECT_GT(sum, 0.0);
+
+        if (workerCount == 1)
+        {
+            singleWorkerMs = elapsed.count();
+        }
+        std::printf("[ BENCH    ] parallel for over %u workers: %.2f ms, %.2fx\n", workerCount, elapsed.count(), singleWorkerMs / elapsed.count());
+
+        jobSystem.Deinit();
+    }
+}
+
+TEST(JobsBenchmarks, TaskSpawnResume)
+{
+    InitJobSystem();
+
+    // A task awaited in a loop: frame allocation, start, completion and destruction.
+    Task<Double> spawn = MeasureTaskSpawnNs(20000);
+    const Double spawnNs = SyncWait(spawn);
+
+    // The coroutine suspended and resumed by a job on the workers each time.
+    Task<Double> hop = MeasureWorkerHopNs(100000);
+    const Double hopNs = SyncWait(hop);
+
+    std::printf("[ BENCH    ] task spawn+await: %.1f ns, resume on workers: %.1f ns\n", spawnNs, hopNs);
+
+    DeinitJobSystem();
+}
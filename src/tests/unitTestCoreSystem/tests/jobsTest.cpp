@@ -0,0 +1,352 @@
+#include <gtest/gtest.h>
+#include "core/coreSystem/build.h"
+
+#include <algorithm>
+#include <set>
+#include <thread>
+
+namespace
+{
+    using namespace uge;
+    using namespace uge::jobs;
+
+    void IncrementJob(void *data)
+    {
+        atomic::Atomic32::Increment(static_cast<AtomicInt *>(data));
+    }
+
+    struct DependencyState
+    {
+        AtomicInt m_firstDone;
+        AtomicInt m_firstDoneSeen;
+    };
+
+    void FirstJob(void *data)
+    {
+        atomic::Atomic32::Increment(&static_cast<DependencyState *>(data)->m_firstDone);
+    }
+
+    void SecondJob(void *data)
+    {
+        DependencyState *state = static_cast<DependencyState *>(data);
+        atomic::Atomic32::Store(&state->m_firstDoneSeen, atomic::Atomic32::Fetch(&state->m_firstDone));
+    }
+
+    struct TreeContext
+    {
+        JobSystem *m_jobSystem;
+        Mutex m_threadIdsLock;
+        std::set<UInt32> m_threadIds;
+    };
+
+    struct TreeNode
+    {
+        TreeContext *m_context;
+        UInt32 m_depth;
+        UInt32 m_leafCount;
+    };
+
+    // Each node waits on its two children, on a fiber, so the tree never holds a worker thread.
+    void TreeJob(void *data)
+    {
+        TreeNode *node = static_cast<TreeNode *>(data);
+        TreeContext *context = node->m_context;
+        if (node->m_depth == 0)
+        {
+            ScopedLock<Mutex> lock(context->m_threadIdsLock);
+            context->m_threadIds.insert(ThreadId::GetCurrentThread().Get());
+            node->m_leafCount = 1;
+            return;
+        }
+
+        TreeNode children[2] = {{context, node->m_depth - 1, 0}, {context, node->m_depth - 1, 0}};
+        JobDecl jobs[2] = {{TreeJob, &children[0]}, {TreeJob, &children[1]}};
+
+        JobCounter counter;
+        context->m_jobSystem->Run(jobs, 2, &counter);
+        context->m_jobSystem->WaitForCounter(&counter);
+
+        node->m_leafCount = children[0].m_leafCount + children[1].m_leafCount;
+    }
+
+    Task<UInt32> AddAsync(UInt32 a, UInt32 b)
+    {
+        co_return a + b;
+    }
+
+    Task<UInt32> SumPipeline(UInt32 mainThreadId, Bool *resumedOnMainThread)
+    {
+        UInt32 sum = co_await AddAsync(1, 2);
+
+        Task<UInt32> tasks[8];
+        for (UInt32 i = 0; i != 8; ++i)
+        {
+            tasks[i] = AddAsync(i, 1);
+        }
+        co_await WhenAll(tasks, 8);
+        for (Task<UInt32> &task : tasks)
+        {
+            sum += task.GetResult();
+        }
+
+        co_await ResumeOnMainThread();
+        *resumedOnMainThread = ThreadId::GetCurrentThread().Get() == mainThreadId;
+
+        co_await ResumeOnWorkers();
+        co_return sum;
+    }
+}
+
+TEST(JobQueueTests, OwnerPopsNewestThievesStealOldest)
+{
+    JobQueue *queue = new JobQueue;
+    AtomicInt data[3] = {};
+
+    for (AtomicInt &value : data)
+    {
+        ASSERT_TRUE(queue->Push(Job{IncrementJob, &value, nullptr}));
+    }
+    EXPECT_EQ(queue->GetSize(), 3u);
+
+    Job job;
+    ASSERT_TRUE(queue->Pop(job));
+    EXPECT_EQ(job.m_data, &data[2]);
+    ASSERT_TRUE(queue->Steal(job));
+    EXPECT_EQ(job.m_data, &data[0]);
+    ASSERT_TRUE(queue->Pop(job));
+    EXPECT_EQ(job.m_data, &data[1]);
+
+    EXPECT_FALSE(queue->Pop(job));
+    EXPECT_FALSE(queue->Steal(job));
+    delete queue;
+}
+
+TEST(JobSystemTests, RunsEveryJobAndDependenciesInOrder)
+{
+    JobSystem jobSystem;
+    jobSystem.Init(4);
+    EXPECT_EQ(jobSystem.GetCurrentWorkerIndex(), 0u);
+
+    const UInt32 c_jobCount = 10000;
+    AtomicInt value = 0;
+    std::vector<JobDecl> jobs(c_jobCount, JobDecl{IncrementJob, &value});
+
+    JobCounter counter;
+    jobSystem.Run(jobs.data(), c_jobCount, &counter);
+    jobSystem.WaitForCounter(&counter);
+    EXPECT_EQ(value, static_cast<AtomicInt>(c_jobCount));
+
+    // The second job must only start once every first job is done.
+    DependencyState state = {};
+    std::vector<JobDecl> firstJobs(64, JobDecl{FirstJob, &state});
+    JobDecl secondJob = {SecondJob, &state};
+
+    JobCounter firstCounter;
+    JobCounter secondCounter;
+    jobSystem.Run(firstJobs.data(), 64, &firstCounter);
+    jobSystem.Run(&secondJob, 1, &secondCounter, &firstCounter);
+    jobSystem.WaitForCounter(&secondCounter);
+    EXPECT_TRUE(firstCounter.IsDone());
+    EXPECT_EQ(state.m_firstDoneSeen, 64);
+
+    jobSystem.Deinit();
+}
+
+TEST(JobSystemTests, ThreadsOutsideTheSystemCanSubmit)
+{
+    JobSystem jobSystem;
+    jobSystem.Init(2);
+
+    const UInt32 c_jobCount = 1000;
+    AtomicInt value = 0;
+    std::thread submitter([&]()
+                          {
+                              EXPECT_EQ(jobSystem.GetCurrentWorkerIndex(), JobSystem::c_noWorkerIndex);
+                              std::vector<JobDecl> jobs(c_jobCount, JobDecl{IncrementJob, &value});
+                              JobCounter counter;
+                              jobSystem.Run(jobs.data(), c_jobCount, &counter);
+                              jobSystem.WaitForCounter(&counter); });
+    submitter.join();
+    EXPECT_EQ(value, static_cast<AtomicInt>(c_jobCount));
+
+    jobSystem.Deinit();
+}
+
+TEST(JobSystemTests, DeinitWakesWorkersDespiteUnusedWakeups)
+{
+    const UInt32 c_workerCount = 4;
+
+    // Wakeups the workers don't get to take before Deinit leave permits behind, Deinit must still
+    // get every sleeping worker out.
+    for (UInt32 round = 0; round != 50; ++round)
+    {
+        JobSystem jobSystem;
+        jobSystem.Init(c_workerCount);
+
+        AtomicInt value = 0;
+        JobDecl jobs[c_workerCount];
+        for (JobDecl &job : jobs)
+        {
+            job = JobDecl{IncrementJob, &value};
+        }
+
+        JobCounter counter;
+        jobSystem.Run(jobs, c_workerCount, &counter);
+        jobSystem.WaitForCounter(&counter);
+        EXPECT_EQ(value, static_cast<AtomicInt>(c_workerCount));
+
+        jobSystem.Deinit();
+    }
+}
+
+TEST(JobSystemTests, DeepJobTreeWaitsOnFibers)
+{
+    const UInt32 c_workerCount = 3;
+    const UInt32 c_depth = 14;
+
+    JobSystem jobSystem;
+    jobSystem.Init(c_workerCount, 64);
+
+    TreeContext context;
+    context.m_jobSystem = &jobSystem;
+    TreeNode root = {&context, c_depth, 0};
+    JobDecl rootJob = {TreeJob, &root};
+
+    JobCounter counter;
+    jobSystem.Run(&rootJob, 1, &counter);
+    jobSystem.WaitForCounter(&counter);
+
+    // 16k jobs waited on their children, with 3 threads and 64 fibers.
+    EXPECT_EQ(root.m_leafCount, 1u << c_depth);
+    EXPECT_LE(context.m_threadIds.size(), c_workerCount);
+
+    jobSystem.Deinit();
+}
+
+TEST(JobSystemTests, TreeDeeperThanTheFiberPoolFallsBackToWorkerStacks)
+{
+    const UInt32 c_workerCount = 2;
+    const UInt32 c_depth = 10;
+
+    JobSystem jobSystem;
+    jobSystem.Init(c_workerCount, 4);
+
+    TreeContext context;
+    context.m_jobSystem = &jobSystem;
+    TreeNode root = {&context, c_depth, 0};
+    JobDecl rootJob = {TreeJob, &root};
+
+    JobCounter counter;
+    jobSystem.Run(&rootJob, 1, &counter);
+    jobSystem.WaitForCounter(&counter);
+
+    EXPECT_EQ(root.m_leafCount, 1u << c_depth);
+
+    jobSystem.Deinit();
+}
+
+TEST(TaskTests, AwaitWhenAllAndResumeOnMainThread)
+{
+    jobs::InitJobSystem(3);
+
+    Bool resumedOnMainThread = false;
+    Task<UInt32> task = SumPipeline(ThreadId::GetCurrentThread().Get(), &resumedOnMainThread);
+    const UInt32 sum = SyncWait(task);
+
+    // 1 + 2, then 1 + 2 + ... + 8 from the tasks awaited together.
+    EXPECT_EQ(sum, 39u);
+    EXPECT_TRUE(resumedOnMainThread);
+
+    jobs::DeinitJobSystem();
+}
+
+TEST(TaskTests, MainLoopResumesMainThreadTasks)
+{
+    jobs::InitJobSystem(3);
+
+    // Started without SyncWait, so only the frame loop below brings it back to the main thread.
+    Bool resumedOnMainThread = false;
+    Task<UInt32> task = SumPipeline(ThreadId::GetCurrentThread().Get(), &resumedOnMainThread);
+    priv::TaskGroup group = {1, std::coroutine_handle<>()};
+    task.GetHandle().promise().SetGroup(&group);
+    priv::ResumeOnWorkers(task.GetHandle());
+
+    UInt32 frameCount = 0;
+    while (atomic::Atomic32::Fetch(&group.m_remaining) != 0)
+    {
+        if (RunMainThreadTasks())
+        {
+            ++frameCount;
+        }
+        Thread_Yield();
+    }
+
+    EXPECT_EQ(task.GetResult(), 39u);
+    EXPECT_TRUE(resumedOnMainThread);
+    EXPECT_EQ(frameCount, 1u);
+
+    jobs::DeinitJobSystem();
+}
+
+TEST(ParallelTests, ForVisitsEachIndexOnceAndReduceSums)
+{
+    jobs::InitJobSystem(4);
+
+    const UInt32 c_count = 200000;
+    // A plain array: as a template argument, AtomicInt would lose its alignment attribute.
+    AtomicInt *visits = new AtomicInt[c_count]();
+    ParallelFor(c_count, [visits](UInt32 index)
+                { atomic::Atomic32::Increment(&visits[index]); });
+    EXPECT_EQ(std::count(visits, visits + c_count, 1), static_cast<std::ptrdiff_t>(c_count));
+    delete[] visits;
+
+    const UInt64 sum = ParallelReduce(
+        10u, c_count, UInt64(0),
+        [](UInt64 &partial, UInt32 index)
+        { partial += index; },
+        [](UInt64 a, UInt64 b)
+        { return a + b; });
+    EXPECT_EQ(sum, UInt64(c_count) * (c_count - 1) / 2 - 45);
+
+    // Too small to be worth a job, runs on the caller.
+    UInt32 smallSum = 0;
+    ParallelFor(8u, [&smallSum](UInt32 index)
+                { smallSum += index; });
+    EXPECT_EQ(smallSum, 28u);
+
+    jobs::DeinitJobSystem();
+}
+
+TEST(ParallelTests, ReduceFromOutsideTheWorkersSplitsSparingly)
+{
+    const UInt32 c_workerCount = 4;
+    const UInt32 c_count = 400000;
+    jobs::InitJobSystem(c_workerCount);
+
+    // A thread that isn't a worker has no queue telling it when to stop splitting.
+    Mutex partialsLock;
+    std::set<const UInt64 *> partials;
+    UInt64 sum = 0;
+    std::thread caller([&]()
+                       { sum = ParallelReduce(
+                             0u, c_count, UInt64(0),
+                             [&](UInt64 &partial, UInt32 index)
+                             {
+                                 if (index % 64 == 0)
+                                 {
+                                     ScopedLock<Mutex> lock(partialsLock);
+                                     partials.insert(&partial);
+                                 }
+                                 partial += index;
+                             },
+                             [](UInt64 a, UInt64 b)
+                             { return a + b; }); });
+    caller.join();
+
+    EXPECT_EQ(sum, UInt64(c_count) * (c_count - 1) / 2);
+
+    // The caller's result and the split ranges, each with its own partial result.
+    EXPECT_LE(partials.size(), 1 + priv::c_parallelRangesPerWorker * c_workerCount);
+
+    jobs::DeinitJobSystem();
+}
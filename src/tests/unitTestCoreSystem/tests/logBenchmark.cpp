@@ -0,0 +1,622 @@
+#include <gtest/gtest.h>
+#include "core/coreSystem/build.h"
+
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/coreSystem/log/logBinaryFileSink.h"
+#include "core/coreSystem/log/logCompressedFileSink.h"
+#include "core/coreSystem/log/logFileSink.h"
+#include "core/coreSystem/log/logMappedFileSink.h"
+
+namespace
+{
+    using namespace uge;
+
+    UInt32 EncodeArgs(UByte *buffer, UInt32 bufferSize, const char *format, ...)
+    {
+        va_list argList;
+        va_start(argList, format);
+        const UInt32 size = log::EncodeLogArgs(buffer, bufferSize, format, argList);
+        va_end(argList);
+        return size;
+    }
+
+    class CountingLogSink : public log::LogSink
+    {
+    public:
+        CountingLogSink()
+            : m_count(0)
+        {
+        }
+
+        virtual void SinkLog(const char *formattedMsg, const log::LogLine &logLine)
+        {
+            atomic::Atomic32::Increment(&m_count);
+        }
+
+        virtual void Flush()
+        {
+        }
+
+        UInt32 GetCount()
+        {
+            return atomic::Atomic32::Fetch(&m_count);
+        }
+
+    private:
+        AtomicInt m_count;
+    };
+
+    /**
+     * @brief Measures the caller side cost of a log call. Messages are pushed in bursts that fit in
+     * the queue and the log thread is allowed to drain between bursts, so only the producer is timed.
+     */
+    Double MeasureNsPerLogCall(log::LogFormatMode formatMode, Bool packByType = false)
+    {
+        const UInt32 c_burstSize = 64;
+        const UInt32 c_burstCount = 2000;
+
+        auto logger = std::make_unique<log::CLog>();
+        CountingLogSink sink;
+
+        logger->RegisterSink(&sink);
+        logger->SetFormatMode(formatMode);
+        logger->Init(log::LogMode_ASync);
+
+        std::chrono::nanoseconds elapsed(0);
+        UInt32 pushed = 0;
+        for (UInt32 burst = 0; burst != c_burstCount; ++burst)
+        {
+            const auto start = std::chrono::high_resolution_clock::now();
+            for (UInt32 i = 0; i != c_burstSize; ++i)
+            {
+                if (packByType)
+                {
+                    logger->PushMessageArgs(log::LogLevel_Info, log::LogCategory_Core, "Entity %u moved to (%.3f, %.3f, %.3f) in %s", i, 1.0f * i, 2.5f, -3.25f, "Sector_7");
+                }
+                else
+                {
+                    logger->PushMessage(log::LogLevel_Info, log::LogCategory_Core, "Entity %u moved to (%.3f, %.3f, %.3f) in %s", i, 1.0f * i, 2.5f, -3.25f, "Sector_7");
+                }
+            }
+            elapsed += std::chrono::high_resolution_clock::now() - start;
+            pushed += c_burstSize;
+
+            while (sink.GetCount() != pushed)
+            {
+                Thread_Yield();
+            }
+        }
+
+        logger->Deinit();
+        logger->UnregisterSink(&sink);
+
+        return static_cast<Double>(elapsed.count()) / pushed;
+    }
+
+    /**
+     * @brief The per-line localtime/strftime/Strcat formatting FormatLogMessage used to do, kept as
+     * the reference for the cached formatter.
+     */
+    void FormatLogMessageUncached(char *buffer, UInt32 bufferSize, const log::LogLine &logLine)
+    {
+        const char *levelString[] = {"[Fatal]", "[Error]", "[Warning]", "[Info]", "[Debug]", "[Trace]"};
+
+        auto time = std::chrono::system_clock::to_time_t(logLine.m_time);
+        std::tm localTime;
+        Localtime(localTime, time);
+
+        strftime(buffer, bufferSize, "[%Y.%m.%d %X]", &localTime);
+        Strcat(buffer, levelString[logLine.m_level], bufferSize);
+        Strcat(buffer, " ", bufferSize);
+
+        const UInt32 prefixLength = static_cast<UInt32>(Strlen(buffer));
+        log::DecodeLogArgs(buffer + prefixLength, bufferSize - prefixLength - 1, logLine.m_format, reinterpret_cast<const UByte *>(logLine.GetPayload()), logLine.m_size);
+        Strcat(buffer, "\n", bufferSize);
+    }
+
+    template <typename TFormatter>
+    Double MeasureFormattedLinesPerSecond(TFormatter formatter)
+    {
+        const UInt32 c_lineCount = 200000;
+        const char *format = "Entity %u moved to (%.3f, %.3f, %.3f) in %s";
+
+        struct
+        {
+            log::LogLine m_line;
+            UByte m_payload[256];
+        } record;
+
+        record.m_line = log::LogLine{0, std::chrono::system_clock::now(), 0, log::LogLineType_Log, log::LogLevel_Info, log::LogCategory_Core, format};
+        record.m_line.m_size = EncodeArgs(record.m_payload, sizeof(record.m_payload), format, 42u, 1.0, 2.5, -3.25, "Sector_7");
+
+        char formattedMsg[log::c_logFormattedLineSize];
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (UInt32 i = 0; i != c_lineCount; ++i)
+        {
+            // A few thousand lines per second of log time, like a busy frame loop.
+            record.m_line.m_time += std::chrono::microseconds(250);
+            formatter(formattedMsg, sizeof(formattedMsg), record.m_line);
+        }
+        const Double elapsed = std::chrono::duration<Double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        return c_lineCount / elapsed;
+    }
+
+    /**
+     * @brief Feeds the same batch of formatted lines to a sink, as the log thread would, and returns
+     * the number of lines sunk per second.
+     */
+    Double MeasureSinkLinesPerSecond(log::LogSink &sink, Bool perLine = false)
+    {
+        const UInt32 c_batchCount = 2000;
+
+        const log::LogLine logLine = {};
+        std::string text;
+        std::vector<log::LogBatchEntry> entries;
+        for (UInt32 i = 0; i != log::c_logBatchMax; ++i)
+        {
+            text += "[2024.01.01 12:00:00.000][Info] Entity " + std::to_string(i) + " moved to (1.000, 2.500, -3.250) in Sector_7\n";
+        }
+
+        for (UInt32 i = 0, offset = 0; i != log::c_logBatchMax; ++i)
+        {
+            const UInt32 length = static_cast<UInt32>(text.find('\n', offset)) + 1 - offset;
+            entries.push_back(log::LogBatchEntry{&logLine, text.c_str() + offset, length});
+            offset += length;
+        }
+
+        const log::LogBatch batch = {entries.data(), static_cast<UInt32>(entries.size()), text.c_str(), static_cast<UInt32>(text.size())};
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (UInt32 i = 0; i != c_batchCount; ++i)
+        {
+            // The base implementation hands the lines to SinkLog one by one.
+            perLine ? sink.LogSink::SinkLogBatch(batch) : sink.SinkLogBatch(batch);
+        }
+        sink.Flush();
+        const Double elapsed = std::chrono::duration<Double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        return c_batchCount * batch.m_count / elapsed;
+    }
+
+    class LatencyLogSink : public log::LogSink
+    {
+    public:
+        LatencyLogSink()
+            : m_count(0), m_totalLatencyNs(0)
+        {
+        }
+
+        virtual void SinkLog(const char *formattedMsg, const log::LogLine &logLine)
+        {
+            m_totalLatencyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now() - logLine.m_time).count();
+            atomic::Atomic32::Increment(&m_count);
+        }
+
+        virtual void Flush()
+        {
+        }
+
+        UInt32 GetCount()
+        {
+            return atomic::Atomic32::Fetch(&m_count);
+        }
+
+        Double GetAverageLatencyUs() const
+        {
+            return m_count != 0 ? m_totalLatencyNs / 1000.0 / m_count : 0.0;
+        }
+
+    private:
+        AtomicInt m_count;
+        Int64 m_totalLatencyNs;
+    };
+
+    Double GetProcessCpuSeconds()
+    {
+#if defined(UGE_PLATFORM_WINDOWS)
+        FILETIME creationTime, exitTime, kernelTime, userTime;
+        ::GetProcessTimes(::GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime);
+
+        const UInt64 kernel = (static_cast<UInt64>(kernelTime.dwHighDateTime) << 32) | kernelTime.dwLowDateTime;
+        const UInt64 user = (static_cast<UInt64>(userTime.dwHighDateTime) << 32) | userTime.dwLowDateTime;
+        return (kernel + user) / 1e7;
+#elif defined(UGE_PLATFORM_LINUX)
+        timespec cpuTime;
+        ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuTime);
+        return cpuTime.tv_sec + cpuTime.tv_nsec / 1e9;
+#endif
+    }
+
+    /**
+     * @brief Measures the CPU an idle log thread burns, then the average latency of messages that find it idle.
+     */
+    void MeasureIdleCpuAndLatency(log::LogWaitMode mode, Double &idleCpuPercent, Double &latencyUs)
+    {
+        const UInt32 c_messageCount = 200;
+
+        auto logger = std::make_unique<log::CLog>();
+        LatencyLogSink sink;
+
+        logger->SetWaitMode(mode);
+        logger->RegisterSink(&sink);
+        logger->Init(log::LogMode_ASync);
+
+        // Let the log thread settle, then measure what an idle log costs.
+        Thread_Sleep(100);
+        const auto idleStart = std::chrono::steady_clock::now();
+        const Double idleCpuStart = GetProcessCpuSeconds();
+        Thread_Sleep(1000);
+        const Double idleCpu = GetProcessCpuSeconds() - idleCpuStart;
+        const Double idleWall = std::chrono::duration<Double>(std::chrono::steady_clock::now() - idleStart).count();
+
+        // Spaced out messages, so every one of them finds the log thread idle.
+        for (UInt32 i = 0; i != c_messageCount; ++i)
+        {
+            logger->PushMessage(log::LogLevel_Info, log::LogCategory_Core, "Latency probe %u", i);
+            Thread_Sleep(2);
+        }
+
+        while (sink.GetCount() != c_messageCount)
+        {
+            Thread_Yield();
+        }
+
+        logger->Deinit();
+        logger->UnregisterSink(&sink);
+
+        idleCpuPercent = 100.0 * idleCpu / idleWall;
+        latencyUs = sink.GetAverageLatencyUs();
+    }
+
+    class LogProducerThread : public Thread
+    {
+    public:
+        LogProducerThread(log::CLog *logger, volatile AtomicInt *startFlag)
+            : Thread("LogProducer"), m_logger(logger), m_startFlag(startFlag), m_elapsedNs(0), m_pushed(0)
+        {
+        }
+
+        virtual void ThreadFunc()
+        {
+            const UInt32 c_burstSize = 32;
+            const UInt32 c_burstCount = 200;
+
+            while (atomic::Atomic32::Fetch(m_startFlag) == 0)
+            {
+                Thread_Yield();
+            }
+
+            for (UInt32 burst = 0; burst != c_burstCount; ++burst)
+            {
+                const auto start = std::chrono::high_resolution_clock::now();
+                for (UInt32 i = 0; i != c_burstSize; ++i)
+                {
+                    m_logger->PushMessage(log::LogLevel_Info, log::LogCategory_Core, "Worker step %u of burst %u", i, burst);
+                }
+                m_elapsedNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start).count();
+                m_pushed += c_burstSize;
+
+                // Give the log thread time to drain so we time the producer, not a full ring.
+                Thread_Sleep(2);
+            }
+        }
+
+        Double GetNsPerCall() const
+        {
+            return static_cast<Double>(m_elapsedNs) / m_pushed;
+        }
+
+    private:
+        log::CLog *m_logger;
+        volatile AtomicInt *m_startFlag;
+        Int64 m_elapsedNs;
+        UInt32 m_pushed;
+    };
+
+    Double MeasureNsPerLogCallWithProducers(UInt32 producerCount)
+    {
+        auto logger = std::make_unique<log::CLog>();
+        CountingLogSink sink;
+
+        logger->RegisterSink(&sink);
+        logger->Init(log::LogMode_ASync);
+
+        AtomicInt startFlag = 0;
+        std::vector<std::unique_ptr<LogProducerThread>> producers;
+        for (UInt32 i = 0; i != producerCount; ++i)
+        {
+            producers.push_back(std::make_unique<LogProducerThread>(logger.get(), &startFlag));
+            producers.back()->Init();
+        }
+
+        atomic::Atomic32::Exchange(&startFlag, 1);
+
+        Double totalNs = 0.0;
+        for (auto &producer : producers)
+        {
+            producer->Join();
+            totalNs += producer->GetNsPerCall();
+        }
+
+        logger->Deinit();
+        logger->UnregisterSink(&sink);
+
+        return totalNs / producerCount;
+    }
+}
+
+TEST(LogBenchmarks, DeferredVsImmediateFormatting)
+{
+    const Double immediateNs = MeasureNsPerLogCall(log::LogFormat_Immediate);
+    const Double deferredNs = MeasureNsPerLogCall(log::LogFormat_Deferred);
+    const Double packedNs = MeasureNsPerLogCall(log::LogFormat_Deferred, true);
+
+    std::printf("[ BENCH    ] caller cost per log call: immediate %.1f ns, deferred %.1f ns (%.2fx), packed by type %.1f ns (%.2fx)\n", immediateNs, deferredNs, immediateNs / deferredNs, packedNs, immediateNs / packedNs);
+}
+
+TEST(LogBenchmarks, FilteredLogInHotLoop)
+{
+    const UInt32 c_iterationCount = 10000000;
+
+    // A Trace call the runtime level filters out, on the global log the UGE_LOG_* macros use. With
+    // UGE_LOG_MIN_LEVEL above Trace, or the category outside UGE_LOG_CATEGORY_MASK, it isn't compiled at all.
+    log::CLog &logger = log::GetLog();
+    CountingLogSink sink;
+
+    logger.RegisterSink(&sink);
+    logger.Init(log::LogMode_ASync);
+    logger.SetLevel(log::LogLevel_Debug);
+
+    volatile UInt32 sum = 0;
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (UInt32 i = 0; i != c_iterationCount; ++i)
+    {
+        sum = sum + i;
+#ifdef UGE_LOG_ENABLED
+        UGE_LOG_TRACE(log::LogCategory_Game, "Hot loop iteration %u", i);
+#else
+        // The macros are empty without UGE_DEBUG, call what they expand to.
+        log::Log<log::LogLevel_Trace, log::LogCategory_Game>("Hot loop iteration %u", i);
+#endif
+    }
+    const std::chrono::duration<Double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    logger.RestoreLevel();
+    logger.Deinit();
+    logger.UnregisterSink(&sink);
+
+    EXPECT_EQ(sink.GetCount(), 0u);
+    std::printf("[ BENCH    ] hot loop with a filtered log call: %.3f ns per iteration\n", elapsed.count() / c_iterationCount);
+}
+
+TEST(LogBenchmarks, FormattedLinesPerSecond)
+{
+    const Double uncached = MeasureFormattedLinesPerSecond(FormatLogMessageUncached);
+    const Double seconds = MeasureFormattedLinesPerSecond([](char *buffer, UInt32 bufferSize, const log::LogLine &logLine)
+                                                          { log::FormatLogMessage(buffer, bufferSize, logLine, log::LogTimestamp_Seconds); });
+    const Double microseconds = MeasureFormattedLinesPerSecond([](char *buffer, UInt32 bufferSize, const log::LogLine &logLine)
+                                                               { log::FormatLogMessage(buffer, bufferSize, logLine, log::LogTimestamp_Microseconds); });
+
+    std::printf("[ BENCH    ] formatted lines per second: uncached %.0f, cached %.0f (%.2fx), cached with microseconds %.0f\n", uncached, seconds, seconds / uncached, microseconds);
+}
+
+TEST(LogBenchmarks, ProducerScaling)
+{
+    for (UInt32 producerCount = 1; producerCount <= 32; producerCount *= 2)
+    {
+        const Double ns = MeasureNsPerLogCallWithProducers(producerCount);
+        std::printf("[ BENCH    ] %2u producer threads: %.1f ns per log call\n", producerCount, ns);
+    }
+}
+
+TEST(LogBenchmarks, IdleCpuAndLatency)
+{
+    // The semaphore park against the polling loop it replaced.
+    const log::LogWaitMode c_modes[] = {log::LogWait_Poll, log::LogWait_Park};
+    const char *c_modeNames[] = {"polling", "parked"};
+
+    for (UInt32 mode = 0; mode != 2; ++mode)
+    {
+        Double idleCpuPercent = 0.0;
+        Double latencyUs = 0.0;
+        MeasureIdleCpuAndLatency(c_modes[mode], idleCpuPercent, latencyUs);
+        std::printf("[ BENCH    ] %s log thread: %.1f%% of a core when idle, enqueue to sink latency: %.1f us\n", c_modeNames[mode], idleCpuPercent, latencyUs);
+    }
+}
+
+TEST(LogBenchmarks, FileSinkThroughput)
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string filePath = (directory / "ugeFileSinkBench.log").string();
+    const std::string mappedPath = (directory / "ugeMappedSinkBench.log").string();
+
+    Double filePerLineLines = 0.0;
+    Double fileLines = 0.0;
+    {
+        log::LogFileSink sink;
+        ASSERT_TRUE(sink.OpenFile(filePath.c_str()));
+        filePerLineLines = MeasureSinkLinesPerSecond(sink, true);
+        fileLines = MeasureSinkLinesPerSecond(sink);
+        sink.CloseFile();
+    }
+
+    Double mappedLines = 0.0;
+    {
+        log::LogMappedFileSink sink;
+        ASSERT_TRUE(sink.Open(mappedPath.c_str(), 8 * 1024 * 1024, 2));
+        mappedLines = MeasureSinkLinesPerSecond(sink);
+        sink.Close();
+    }
+
+    std::filesystem::remove(filePath);
+    for (UInt32 i = 0; i != 16; ++i)
+    {
+        std::filesystem::remove(mappedPath + "." + std::to_string(i));
+    }
+
+    std::printf("[ BENCH    ] sunk lines per second: stdio file per line %.0f, per batch %.0f, memory-mapped segments %.0f\n", filePerLineLines, fileLines, mappedLines);
+}
+
+TEST(LogBenchmarks, BinaryFileSinkSizeAndThroughput)
+{
+    const UInt32 c_batchCount = 2000;
+    const UInt32 c_recordSize = sizeof(log::LogLine) + 64;
+
+    // Typical Trace level traffic: deferred messages from a few call sites and threads.
+    const char *formats[] = {"Entity %u moved to (%.3f, %.3f, %.3f) in %s", "Frame %u took %.2f ms", "Job %u finished on worker %d"};
+    const char *sectors[] = {"Sector_7", "Sector_12", "Hub"};
+    const auto baseTime = std::chrono::system_clock::now();
+
+    std::vector<UInt64> storage(log::c_logBatchMax * c_recordSize / sizeof(UInt64));
+    std::vector<log::LogBatchEntry> entries;
+    std::string text;
+    std::vector<UInt32> lengths;
+    for (UInt32 i = 0; i != log::c_logBatchMax; ++i)
+    {
+        log::LogLine *record = reinterpret_cast<log::LogLine *>(reinterpret_cast<UByte *>(storage.data()) + i * c_recordSize);
+        *record = log::LogLine{0, baseTime + std::chrono::microseconds(i * 5), 1000 + i % 4, log::LogLineType_Log, log::LogLevel_Trace, log::LogCategory_Game, formats[i % 3]};
+
+        UByte *args = reinterpret_cast<UByte *>(record->GetPayload());
+        switch (i % 3)
+        {
+        case 0:
+            record->m_size = EncodeArgs(args, 64, record->m_format, i, 1.0f + i, 2.5f, -3.25f * i, sectors[i % 2]);
+            break;
+        case 1:
+            record->m_size = EncodeArgs(args, 64, record->m_format, i, 16.0 + i / 100.0);
+            break;
+        default:
+            record->m_size = EncodeArgs(args, 64, record->m_format, i * 7, i % 8);
+            break;
+        }
+
+        char line[log::c_logFormattedLineSize];
+        const UInt32 length = log::FormatLogMessage(line, sizeof(line), *record);
+        text.append(line, length);
+        lengths.push_back(length);
+        entries.push_back(log::LogBatchEntry{record, nullptr, length});
+    }
+
+    for (UInt32 i = 0, offset = 0; i != log::c_logBatchMax; ++i)
+    {
+        entries[i].m_text = text.c_str() + offset;
+        offset += lengths[i];
+    }
+
+    const log::LogBatch batch = {entries.data(), static_cast<UInt32>(entries.size()), text.c_str(), static_cast<UInt32>(text.size())};
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string textPath = (directory / "ugeTextSinkBench.log").string();
+    const std::string binaryPath = (directory / "ugeBinarySinkBench.ulog").string();
+
+    auto measure = [&](log::LogSink &sink)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (UInt32 i = 0; i != c_batchCount; ++i)
+        {
+            sink.SinkLogBatch(batch);
+        }
+        sink.Flush();
+        return c_batchCount * batch.m_count / std::chrono::duration<Double>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+
+    Double textLines = 0.0;
+    {
+        log::LogFileSink sink;
+        ASSERT_TRUE(sink.OpenFile(textPath.c_str()));
+        textLines = measure(sink);
+        sink.CloseFile();
+    }
+
+    Double binaryLines = 0.0;
+    {
+        log::LogBinaryFileSink sink;
+        ASSERT_TRUE(sink.OpenFile(binaryPath.c_str()));
+        binaryLines = measure(sink);
+        sink.CloseFile();
+    }
+
+    const Double textSize = static_cast<Double>(std::filesystem::file_size(textPath));
+    const Double binarySize = static_cast<Double>(std::filesystem::file_size(binaryPath));
+    std::filesystem::remove(textPath);
+    std::filesystem::remove(binaryPath);
+
+    std::printf("[ BENCH    ] text file %.1f MB, binary file %.1f MB (%.2fx smaller), sunk lines per second: text %.0f, binary %.0f\n", textSize / (1024 * 1024), binarySize / (1024 * 1024), textSize / binarySize, textLines, binaryLines);
+}
+
+TEST(LogBenchmarks, CompressedFileSinkSizeAndThroughput)
+{
+    const UInt32 c_batchCount = 2000;
+
+    // Varied Trace level lines, so blocks don't just repeat the same batch.
+    std::mt19937 random(42);
+    const char *sectors[] = {"Sector_7", "Sector_12", "Hub", "Docks"};
+    std::vector<std::string> texts(16);
+    std::vector<std::vector<log::LogBatchEntry>> entries(texts.size());
+    const log::LogLine logLine = {};
+    for (UInt32 i = 0; i != texts.size(); ++i)
+    {
+        std::vector<UInt32> lengths;
+        for (UInt32 j = 0; j != log::c_logBatchMax; ++j)
+        {
+            char line[256];
+            const UInt32 millisecond = i * log::c_logBatchMax + j;
+            const Int32 length = Snprintf(line, sizeof(line), "[2024.01.01 12:%02u:%02u.%03u][Trace] Entity %u moved to (%.3f, %.3f, %.3f) in %s\n", millisecond / 60000 % 60, millisecond / 1000 % 60, millisecond % 1000,
+                                          random() % 5000, (random() % 100000) / 100.0, (random() % 100000) / 100.0, (random() % 100000) / 100.0, sectors[random() % 4]);
+            texts[i].append(line, length);
+            lengths.push_back(length);
+        }
+
+        for (UInt32 j = 0, offset = 0; j != log::c_logBatchMax; ++j)
+        {
+            entries[i].push_back(log::LogBatchEntry{&logLine, texts[i].c_str() + offset, lengths[j]});
+            offset += lengths[j];
+        }
+    }
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string textPath = (directory / "ugeTextSinkBench.log").string();
+    const std::string compressedPath = (directory / "ugeCompressedSinkBench.lzlog").string();
+
+    auto measure = [&](log::LogSink &sink)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (UInt32 i = 0; i != c_batchCount; ++i)
+        {
+            const UInt32 index = i % texts.size();
+            sink.SinkLogBatch(log::LogBatch{entries[index].data(), log::c_logBatchMax, texts[index].c_str(), static_cast<UInt32>(texts[index].size())});
+        }
+        sink.Flush();
+        return c_batchCount * log::c_logBatchMax / std::chrono::duration<Double>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+
+    Double textLines = 0.0;
+    {
+        log::LogFileSink sink;
+        ASSERT_TRUE(sink.OpenFile(textPath.c_str()));
+        textLines = measure(sink);
+        sink.CloseFile();
+    }
+
+    Double compressedLines = 0.0;
+    {
+        log::LogCompressedFileSink sink;
+        ASSERT_TRUE(sink.OpenFile(compressedPath.c_str()));
+        compressedLines = measure(sink);
+        sink.CloseFile();
+    }
+
+    const Double textSize = static_cast<Double>(std::filesystem::file_size(textPath));
+    const Double compressedSize = static_cast<Double>(std::filesystem::file_size(compressedPath));
+    std::filesystem::remove(textPath);
+    std::filesystem::remove(compressedPath);
+
+    std::printf("[ BENCH    ] text file %.1f MB, compressed file %.1f MB (%.2fx smaller), sunk lines per second: text %.0f, compressed %.0f (%.0f MB/s of text)\n", textSize / (1024 * 1024), compressedSize / (1024 * 1024), textSize / compressedSize, textLines, compressedLines,
+                compressedLines * textSize / (c_batchCount * log::c_logBatchMax) / (1024 * 1024));
+}
@@ -0,0 +1,1212 @@
+#include <gtest/gtest.h>
+#include "core/coreSystem/build.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/coreSystem/log/logAsyncSink.h"
+#include "core/coreSystem/log/logBinaryFileSink.h"
+#include "core/coreSystem/log/logCompressedFileSink.h"
+#include "core/coreSystem/log/logFileSink.h"
+#include "core/coreSystem/log/logMappedFileSink.h"
+
+namespace
+{
+    uge::UInt32 EncodeArgs(uge::UByte *buffer, uge::UInt32 bufferSize, const char *format, ...)
+    {
+        va_list argList;
+        va_start(argList, format);
+        const uge::UInt32 size = uge::log::EncodeLogArgs(buffer, bufferSize, format, argList);
+        va_end(argList);
+        return size;
+    }
+
+    template <typename... TArgs>
+    uge::UInt32 PackFields(uge::UByte *buffer, uge::UInt32 bufferSize, const TArgs &...fields)
+    {
+        uge::log::LogArgPacker<TArgs...> packer;
+        const uge::UInt32 size = packer.Measure(bufferSize, fields...);
+        packer.Write(buffer, size, fields...);
+        return size;
+    }
+
+    class LineRecordingSink : public uge::log::LogSink
+    {
+    public:
+        virtual void SinkLog(const char *formattedMsg, const uge::log::LogLine &logLine)
+        {
+            m_text += formattedMsg;
+            ++m_count;
+        }
+
+        virtual void Flush()
+        {
+            ++m_flushCount;
+        }
+
+        std::string m_text;
+        uge::UInt32 m_count = 0;
+        uge::UInt32 m_flushCount = 0;
+    };
+
+    class BatchRecordingSink : public LineRecordingSink
+    {
+    public:
+        virtual void SinkLogBatch(const uge::log::LogBatch &batch)
+        {
+            const char *expectedText = batch.m_text;
+            for (uge::UInt32 i = 0; i != batch.m_count; ++i)
+            {
+                EXPECT_EQ(batch.m_entries[i].m_text, expectedText);
+                EXPECT_EQ(batch.m_entries[i].m_logLine->m_level, uge::log::LogLevel_Info);
+                expectedText += batch.m_entries[i].m_length;
+            }
+
+            EXPECT_EQ(expectedText, batch.m_text + batch.m_textLength);
+            m_text.append(batch.m_text, batch.m_textLength);
+            m_count += batch.m_count;
+        }
+    };
+
+    // Holds the log thread in its first line until m_open is set, so the lines pushed meanwhile
+    // pile up in the producer's ring.
+    class GatedSink : public LineRecordingSink
+    {
+    public:
+        virtual void SinkLog(const char *formattedMsg, const uge::log::LogLine &logLine)
+        {
+            LineRecordingSink::SinkLog(formattedMsg, logLine);
+            if (m_count == 1)
+            {
+                uge::atomic::Atomic32::Store(&m_entered, 1);
+                while (uge::atomic::Atomic32::Fetch(&m_open) == 0)
+                {
+                    uge::Thread_Yield();
+                }
+            }
+        }
+
+        uge::AtomicInt m_entered = 0;
+        uge::AtomicInt m_open = 0;
+    };
+
+    // Several rings' worth of lines.
+    const uge::UInt32 c_overflowLineCount = 4000;
+
+    /**
+     * Pushes c_overflowLineCount numbered lines under the policy while the log thread is held in
+     * the sink, then lets it drain. Returns the numbers of the lines that were sunk, in order.
+     */
+    std::vector<uge::UInt32> FillRingUnderPolicy(uge::log::LogOverflowPolicy policy, std::string &sinkText, uge::UInt32 &droppedCount)
+    {
+        auto logger = std::make_unique<uge::log::CLog>();
+        GatedSink sink;
+        logger->RegisterSink(&sink);
+        logger->SetOverflowPolicy(policy);
+        logger->Init(uge::log::LogMode_ASync);
+
+        logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Gate");
+        while (uge::atomic::Atomic32::Fetch(&sink.m_entered) == 0)
+        {
+            uge::Thread_Yield();
+        }
+
+        for (uge::UInt32 i = 0; i != c_overflowLineCount; ++i)
+        {
+            logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Overflow line %u", i);
+        }
+        droppedCount = logger->GetDroppedCount();
+
+        uge::atomic::Atomic32::Store(&sink.m_open, 1);
+        logger->Deinit();
+        logger->UnregisterSink(&sink);
+
+        std::vector<uge::UInt32> sunk;
+        const char c_prefix[] = "Overflow line ";
+        for (size_t position = sink.m_text.find(c_prefix); position != std::string::npos; position = sink.m_text.find(c_prefix, position + 1))
+        {
+            sunk.push_back(static_cast<uge::UInt32>(std::strtoul(sink.m_text.c_str() + position + sizeof(c_prefix) - 1, nullptr, 10)));
+        }
+        sinkText = std::move(sink.m_text);
+        return sunk;
+    }
+
+    bool IsConsecutive(const std::vector<uge::UInt32> &numbers)
+    {
+        return std::adjacent_find(numbers.begin(), numbers.end(), [](uge::UInt32 a, uge::UInt32 b)
+                                  { return b != a + 1; }) == numbers.end();
+    }
+
+    // The log thread reports the drops once the rings are drained, after the lines that survived.
+    void ExpectDroppedReport(const std::string &sinkText, uge::UInt32 droppedCount)
+    {
+        const size_t report = sinkText.find("Log overflow: " + std::to_string(droppedCount) + " messages dropped\n");
+        ASSERT_NE(report, std::string::npos);
+        EXPECT_GT(report, sinkText.rfind("Overflow line "));
+        EXPECT_EQ(sinkText.find("Log overflow:", report + 1), std::string::npos);
+    }
+}
+
+TEST(LogArgsTests, DecodeMatchesVsnprintf)
+{
+    const char *format = "int %d, %5.2f, %s, %.*s, %llx, %c, %%, %-4u|";
+    uge::UByte args[256];
+    const uge::UInt32 argsSize = EncodeArgs(args, sizeof(args), format, -42, 3.14159, "text", 3, "truncated", 0xABCDEFull, 'z', 7u);
+    ASSERT_NE(argsSize, uge::log::c_logArgsInvalid);
+
+    char decoded[256];
+    uge::log::DecodeLogArgs(decoded, sizeof(decoded), format, args, argsSize);
+
+    EXPECT_STREQ(decoded, "int -42,  3.14, text, tru, abcdef, z, %, 7   |");
+}
+
+TEST(LogArgsTests, ShortModifiersTruncateLikePrintf)
+{
+    const char *format = "%hd %hu %hhd %hhx %hhu";
+    uge::UByte args[64];
+    const uge::UInt32 argsSize = EncodeArgs(args, sizeof(args), format, 70000, -1, 200, 0x1234, 511);
+    ASSERT_NE(argsSize, uge::log::c_logArgsInvalid);
+
+    char decoded[64];
+    uge::log::DecodeLogArgs(decoded, sizeof(decoded), format, args, argsSize);
+
+    EXPECT_STREQ(decoded, "4464 65535 -56 34 255");
+}
+
+TEST(LogArgsTests, UnsupportedFormatIsRejected)
+{
+    uge::UByte args[64];
+    int count = 0;
+
+    EXPECT_EQ(EncodeArgs(args, sizeof(args), "%n", &count), uge::log::c_logArgsInvalid);
+}
+
+TEST(LogArgsTests, LongStringIsTruncated)
+{
+    char longString[512];
+    uge::Memset(longString, 'a', sizeof(longString) - 1);
+    longString[sizeof(longString) - 1] = '\0';
+
+    uge::UByte args[64];
+    const uge::UInt32 argsSize = EncodeArgs(args, sizeof(args), "%s", longString);
+    ASSERT_NE(argsSize, uge::log::c_logArgsInvalid);
+
+    char decoded[128];
+    const uge::Int32 length = uge::log::DecodeLogArgs(decoded, sizeof(decoded), "%s", args, argsSize);
+    EXPECT_EQ(length, static_cast<uge::Int32>(sizeof(args) - 4));
+}
+
+TEST(LogRingTests, VariableSizeRecordsSurviveWrapAround)
+{
+    auto ring = std::make_unique<uge::log::LogRing>(0);
+
+    uge::UInt32 written = 0;
+    uge::UInt32 read = 0;
+    for (uge::UInt32 round = 0; round != 4096; ++round)
+    {
+        const uge::UInt32 size = 1 + (round * 37) % 700;
+        char *record = static_cast<char *>(ring->Reserve(size));
+        if (record != nullptr)
+        {
+            uge::Memset(record, static_cast<uge::UByte>(written), size);
+            ring->Commit(size);
+            ++written;
+        }
+
+        if (round % 3 == 0 || record == nullptr)
+        {
+            while (const char *head = static_cast<const char *>(ring->Acquire()))
+            {
+                ASSERT_EQ(static_cast<uge::UByte>(head[0]), static_cast<uge::UByte>(read));
+                ring->Pop();
+                ++read;
+            }
+        }
+    }
+
+    EXPECT_GT(written, 4096u / 2);
+}
+
+TEST(LogRingTests, DropOldestSkipsPinnedRecord)
+{
+    auto ring = std::make_unique<uge::log::LogRing>(0);
+
+    for (uge::UInt32 i = 0; i != 2; ++i)
+    {
+        *static_cast<uge::UInt32 *>(ring->Reserve(sizeof(uge::UInt32))) = i;
+        ring->Commit(sizeof(uge::UInt32));
+    }
+
+    // The log thread is reading the oldest record, the producer must not evict it.
+    const uge::UInt32 *pinned = static_cast<const uge::UInt32 *>(ring->Acquire());
+    ASSERT_NE(pinned, nullptr);
+    EXPECT_FALSE(ring->DropOldest());
+    EXPECT_EQ(*pinned, 0u);
+    ring->Pop();
+
+    EXPECT_TRUE(ring->DropOldest());
+    EXPECT_EQ(ring->Acquire(), nullptr);
+}
+
+TEST(LogOverflowTests, DropNewestKeepsTheLinesAlreadyQueued)
+{
+    std::string text;
+    uge::UInt32 droppedCount = 0;
+    const std::vector<uge::UInt32> sunk = FillRingUnderPolicy(uge::log::LogOverflow_DropNewest, text, droppedCount);
+
+    // The ring filled up, every line after that was dropped.
+    ASSERT_FALSE(sunk.empty());
+    EXPECT_GT(droppedCount, 0u);
+    EXPECT_EQ(sunk.size() + droppedCount, c_overflowLineCount);
+    EXPECT_EQ(sunk.front(), 0u);
+    EXPECT_TRUE(IsConsecutive(sunk));
+    ExpectDroppedReport(text, droppedCount);
+}
+
+TEST(LogOverflowTests, DropOldestKeepsTheNewestLines)
+{
+    std::string text;
+    uge::UInt32 droppedCount = 0;
+    const std::vector<uge::UInt32> sunk = FillRingUnderPolicy(uge::log::LogOverflow_DropOldest, text, droppedCount);
+
+    // Each line past a full ring evicted the oldest ones, through the tail CAS the log thread's pin
+    // guards.
+    ASSERT_FALSE(sunk.empty());
+    EXPECT_GT(droppedCount, 0u);
+    EXPECT_EQ(sunk.size() + droppedCount, c_overflowLineCount);
+    EXPECT_EQ(sunk.back(), c_overflowLineCount - 1);
+    EXPECT_TRUE(IsConsecutive(sunk));
+    ExpectDroppedReport(text, droppedCount);
+}
+
+TEST(LogOverflowTests, SpillMovesToTheSharedRingThenDrops)
+{
+    std::string text;
+    uge::UInt32 droppedCount = 0;
+    const std::vector<uge::UInt32> kept = FillRingUnderPolicy(uge::log::LogOverflow_DropNewest, text, droppedCount);
+    std::vector<uge::UInt32> sunk = FillRingUnderPolicy(uge::log::LogOverflow_Spill, text, droppedCount);
+
+    // The thread's ring then the shared one filled up, the lines after that were dropped. The log
+    // thread drains both rings, so the lines come in two runs.
+    ASSERT_FALSE(sunk.empty());
+    EXPECT_GT(droppedCount, 0u);
+    EXPECT_EQ(sunk.size() + droppedCount, c_overflowLineCount);
+    EXPECT_GT(sunk.size(), kept.size() * 3 / 2);
+    std::sort(sunk.begin(), sunk.end());
+    EXPECT_EQ(sunk.front(), 0u);
+    EXPECT_TRUE(IsConsecutive(sunk));
+    ExpectDroppedReport(text, droppedCount);
+}
+
+TEST(LogBatchTests, BatchedAndPerLineSinksSeeTheSameText)
+{
+    const uge::UInt32 c_messageCount = 300;
+
+    auto logger = std::make_unique<uge::log::CLog>();
+    LineRecordingSink lineSink;
+    BatchRecordingSink batchSink;
+
+    logger->RegisterSink(&lineSink);
+    logger->RegisterSink(&batchSink);
+    logger->Init(uge::log::LogMode_ASync);
+
+    for (uge::UInt32 i = 0; i != c_messageCount; ++i)
+    {
+        logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Batched message %u", i);
+    }
+
+    logger->Deinit();
+    logger->UnregisterSink(&batchSink);
+    logger->UnregisterSink(&lineSink);
+
+    EXPECT_EQ(lineSink.m_count, c_messageCount);
+    EXPECT_EQ(batchSink.m_count, c_messageCount);
+    EXPECT_EQ(batchSink.m_text, lineSink.m_text);
+    EXPECT_NE(lineSink.m_text.find("Batched message 299\n"), std::string::npos);
+}
+
+TEST(LogFlushTests, SyncModeSinksOnTheCaller)
+{
+    auto logger = std::make_unique<uge::log::CLog>();
+    LineRecordingSink sink;
+
+    logger->RegisterSink(&sink);
+    logger->Init(uge::log::LogMode_Sync);
+
+    logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Synchronous %u", 1u);
+    EXPECT_EQ(sink.m_count, 1u);
+    EXPECT_NE(sink.m_text.find("Synchronous 1\n"), std::string::npos);
+
+    EXPECT_TRUE(logger->FlushAndWait(0));
+    EXPECT_EQ(sink.m_flushCount, 1u);
+
+    logger->Deinit();
+    logger->UnregisterSink(&sink);
+}
+
+TEST(LogFlushTests, FlushAndWaitReturnsOnceSunk)
+{
+    const uge::UInt32 c_messageCount = 1000;
+
+    auto logger = std::make_unique<uge::log::CLog>();
+    LineRecordingSink sink;
+
+    logger->RegisterSink(&sink);
+    logger->Init(uge::log::LogMode_ASync);
+
+    for (uge::UInt32 i = 0; i != c_messageCount; ++i)
+    {
+        logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Fenced message %u", i);
+    }
+
+    ASSERT_TRUE(logger->FlushAndWait(10000));
+    EXPECT_EQ(sink.m_count, c_messageCount);
+    EXPECT_EQ(sink.m_flushCount, 1u);
+
+    logger->Deinit();
+    logger->UnregisterSink(&sink);
+    EXPECT_FALSE(logger->FlushAndWait(0));
+}
+
+TEST(LogFlushTests, PollingLogThreadStillDrainsTheRings)
+{
+    auto logger = std::make_unique<uge::log::CLog>();
+    LineRecordingSink sink;
+
+    logger->SetWaitMode(uge::log::LogWait_Poll);
+    logger->RegisterSink(&sink);
+    logger->Init(uge::log::LogMode_ASync);
+
+    // Past the spinning and yielding steps, the log thread only sleeps and isn't woken.
+    uge::Thread_Sleep(20);
+    logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Polled message %u", 1u);
+    ASSERT_TRUE(logger->FlushAndWait(10000));
+    EXPECT_EQ(sink.m_count, 1u);
+
+    // Back to parking while idle.
+    logger->SetWaitMode(uge::log::LogWait_Park);
+    uge::Thread_Sleep(20);
+    logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Polled message %u", 2u);
+    ASSERT_TRUE(logger->FlushAndWait(10000));
+    EXPECT_EQ(sink.m_count, 2u);
+
+    logger->Deinit();
+    logger->UnregisterSink(&sink);
+}
+
+TEST(LogStatsTests, HistogramBucketsRoundTrip)
+{
+    using uge::log::LogLatencyHistogram;
+
+    for (uge::UInt32 bucket = 0; bucket != uge::log::c_logLatencyBucketCount; ++bucket)
+    {
+        EXPECT_EQ(LogLatencyHistogram::GetBucket(LogLatencyHistogram::GetBucketLowerBound(bucket)), bucket);
+    }
+    EXPECT_EQ(LogLatencyHistogram::GetBucket(UINT64_MAX), uge::log::c_logLatencyBucketCount - 1);
+
+    LogLatencyHistogram histogram = {};
+    for (uge::UInt64 latency = 1; latency <= 100; ++latency)
+    {
+        histogram.Record(latency);
+    }
+    EXPECT_EQ(histogram.GetCount(), 100u);
+    EXPECT_EQ(histogram.m_maxUs, 100u);
+    EXPECT_EQ(histogram.GetPercentile(5.0), 5u);
+    EXPECT_LE(histogram.GetPercentile(50.0), 50u);
+    EXPECT_GE(histogram.GetPercentile(50.0), 40u);
+}
+
+TEST(LogStatsTests, CountersFollowThePipeline)
+{
+    const uge::UInt32 c_messageCount = 500;
+
+    auto logger = std::make_unique<uge::log::CLog>();
+    LineRecordingSink sink;
+
+    logger->RegisterSink(&sink);
+    logger->Init(uge::log::LogMode_ASync);
+
+    for (uge::UInt32 i = 0; i != c_messageCount; ++i)
+    {
+        logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Counted message %u", i);
+    }
+    ASSERT_TRUE(logger->FlushAndWait(10000));
+
+    const uge::log::LogStats stats = logger->GetStats();
+    EXPECT_EQ(stats.m_messageCount, c_messageCount);
+    EXPECT_EQ(stats.m_latency.GetCount(), c_messageCount);
+    EXPECT_EQ(stats.m_flushCount, 1u);
+    EXPECT_EQ(stats.m_droppedCount, 0u);
+    EXPECT_GE(stats.m_batchCount, 1u);
+    EXPECT_GT(stats.m_queueHighWater, 0u);
+    ASSERT_EQ(stats.m_sinkCount, 1u);
+    EXPECT_EQ(stats.m_sinks[0].m_sink, &sink);
+    EXPECT_EQ(stats.m_sinks[0].m_bytesWritten, sink.m_text.size());
+
+    logger->Deinit();
+    logger->UnregisterSink(&sink);
+}
+
+TEST(LogStatsTests, RingsOfExitedThreadsAreReclaimed)
+{
+    const uge::UInt32 c_roundCount = 4;
+    const uge::UInt32 c_threadCount = 32;
+
+    auto logger = std::make_unique<uge::log::CLog>();
+    LineRecordingSink sink;
+
+    logger->RegisterSink(&sink);
+    logger->Init(uge::log::LogMode_ASync);
+
+    // More short-lived threads than there are rings, each round reuses the slots of the previous one.
+    for (uge::UInt32 round = 0; round != c_roundCount; ++round)
+    {
+        std::vector<std::thread> threads;
+        for (uge::UInt32 i = 0; i != c_threadCount; ++i)
+        {
+            threads.emplace_back([&logger, round, i]() { logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Short-lived thread %u.%u", round, i); });
+        }
+
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+
+        // The rings are reclaimed after the batch holding the first flush, the second one waits for it.
+        ASSERT_TRUE(logger->FlushAndWait(10000));
+        ASSERT_TRUE(logger->FlushAndWait(10000));
+        EXPECT_EQ(logger->GetStats().m_ringCount, 1u);
+    }
+
+    logger->Deinit();
+    logger->UnregisterSink(&sink);
+
+    EXPECT_EQ(sink.m_count, c_roundCount * c_threadCount);
+    EXPECT_NE(sink.m_text.find("Short-lived thread 3.31\n"), std::string::npos);
+}
+
+TEST(LogSinkRegistryTests, UnregisteredSinkIsNoLongerUsed)
+{
+    // Sinks are registered and unregistered while the log thread is sinking messages; once
+    // UnregisterSink returns, the sink must never be called again.
+    class CheckedSink : public uge::log::LogSink
+    {
+    public:
+        virtual void SinkLog(const char *formattedMsg, const uge::log::LogLine &logLine)
+        {
+            EXPECT_TRUE(uge::atomic::Atomic32::Fetch(&m_registered) != 0);
+        }
+
+        virtual void Flush()
+        {
+        }
+
+        uge::AtomicInt m_registered = 0;
+    };
+
+    auto logger = std::make_unique<uge::log::CLog>();
+    LineRecordingSink permanentSink;
+    CheckedSink sinks[3];
+
+    logger->RegisterSink(&permanentSink);
+    logger->Init(uge::log::LogMode_ASync);
+
+    for (uge::UInt32 i = 0; i != 3000; ++i)
+    {
+        CheckedSink &sink = sinks[i % 3];
+        if (uge::atomic::Atomic32::Fetch(&sink.m_registered) != 0)
+        {
+            logger->UnregisterSink(&sink);
+            uge::atomic::Atomic32::Store(&sink.m_registered, 0);
+        }
+        else
+        {
+            uge::atomic::Atomic32::Store(&sink.m_registered, 1);
+            logger->RegisterSink(&sink);
+        }
+
+        logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Registry message %u", i);
+    }
+
+    logger->Deinit();
+    logger->UnregisterSink(&permanentSink);
+    for (CheckedSink &sink : sinks)
+    {
+        logger->UnregisterSink(&sink);
+    }
+
+    EXPECT_EQ(permanentSink.m_count, 3000u);
+}
+
+TEST(LogSinkFilterTests, SinksOnlySeeWhatTheirFilterAccepts)
+{
+    // A slow sink wrapped in a LogAsyncSink mustn't hold up the others, and each sink only gets
+    // the lines its filter accepts. CanLog rejects levels no sink wants, the per-sink filtering
+    // does the rest.
+    class SlowSink : public BatchRecordingSink
+    {
+    public:
+        virtual void SinkLogBatch(const uge::log::LogBatch &batch)
+        {
+            uge::Thread_Sleep(1);
+            BatchRecordingSink::SinkLogBatch(batch);
+        }
+    };
+
+    auto logger = std::make_unique<uge::log::CLog>();
+    LineRecordingSink errorSink;
+    SlowSink gameSink;
+    errorSink.SetFilter(uge::log::LogLevel_Error);
+    gameSink.SetFilter(uge::log::LogLevel_Info, 1ull << uge::log::LogCategory_Game);
+
+    {
+        uge::log::LogAsyncSink asyncSink(&gameSink);
+        logger->RegisterSink(&errorSink);
+        logger->RegisterSink(&asyncSink);
+        logger->SetLevel(uge::log::LogLevel_Trace);
+        logger->Init(uge::log::LogMode_ASync);
+
+        EXPECT_TRUE(logger->CanLog(uge::log::LogLevel_Error, uge::log::LogCategory_Core));
+        EXPECT_TRUE(logger->CanLog(uge::log::LogLevel_Info, uge::log::LogCategory_Game));
+        EXPECT_FALSE(logger->CanLog(uge::log::LogLevel_Debug, uge::log::LogCategory_Game));
+
+        for (uge::UInt32 i = 0; i != 1000; ++i)
+        {
+            logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Game, "Game message %u", i);
+            if (i % 10 == 0)
+            {
+                logger->PushMessage(uge::log::LogLevel_Error, uge::log::LogCategory_Core, "Core error %u", i);
+            }
+        }
+
+        logger->Deinit();
+        logger->UnregisterSink(&asyncSink);
+        logger->UnregisterSink(&errorSink);
+        EXPECT_EQ(asyncSink.GetDroppedCount(), 0u);
+    }
+
+    EXPECT_EQ(errorSink.m_count, 100u);
+    EXPECT_EQ(errorSink.m_text.find("Game message"), std::string::npos);
+    EXPECT_EQ(gameSink.m_count, 1000u);
+    EXPECT_EQ(gameSink.m_text.find("Core error"), std::string::npos);
+    EXPECT_NE(gameSink.m_text.find("Game message 999"), std::string::npos);
+}
+
+TEST(LogSinkFilterTests, NothingIsFilteredWithoutSinks)
+{
+    auto logger = std::make_unique<uge::log::CLog>();
+    LineRecordingSink errorSink;
+    errorSink.SetFilter(uge::log::LogLevel_Error);
+    logger->SetLevel(uge::log::LogLevel_Trace);
+    logger->Init(uge::log::LogMode_ASync);
+
+    // Lines logged before the first RegisterSink are kept for it.
+    EXPECT_TRUE(logger->CanLog(uge::log::LogLevel_Trace, uge::log::LogCategory_Game));
+
+    logger->RegisterSink(&errorSink);
+    EXPECT_TRUE(logger->CanLog(uge::log::LogLevel_Error, uge::log::LogCategory_Game));
+    EXPECT_FALSE(logger->CanLog(uge::log::LogLevel_Warning, uge::log::LogCategory_Game));
+
+    logger->UnregisterSink(&errorSink);
+    EXPECT_TRUE(logger->CanLog(uge::log::LogLevel_Trace, uge::log::LogCategory_Game));
+    logger->Deinit();
+}
+
+TEST(LogRateLimiterTests, BurstThenSuppressed)
+{
+    uge::log::LogRateLimiter limiter;
+
+    uge::UInt32 accepted = 0;
+    for (uge::UInt32 i = 0; i != 1000; ++i)
+    {
+        accepted += limiter.TryAcquire<10, 100>() ? 1 : 0;
+    }
+
+    // A tick may elapse during the loop and grant one more token.
+    EXPECT_GE(accepted, 100u);
+    EXPECT_LE(accepted, 102u);
+    EXPECT_EQ(limiter.TakeSuppressedCount(), 1000u - accepted);
+    EXPECT_EQ(limiter.TakeSuppressedCount(), 0u);
+}
+
+TEST(LogRepeatTests, IdenticalMessagesAreCollapsed)
+{
+    auto logger = std::make_unique<uge::log::CLog>();
+    LineRecordingSink sink;
+
+    logger->RegisterSink(&sink);
+    logger->Init(uge::log::LogMode_ASync);
+
+    // Off by default, every line is sunk.
+    for (uge::UInt32 i = 0; i != 3; ++i)
+    {
+        logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Uncollapsed message");
+    }
+    ASSERT_TRUE(logger->FlushAndWait(10000));
+    EXPECT_EQ(sink.m_count, 3u);
+    sink.m_count = 0;
+    sink.m_text.clear();
+
+    logger->SetRepeatCollapsing(true);
+    for (uge::UInt32 i = 0; i != 50; ++i)
+    {
+        logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Same message %u", 7u);
+    }
+    logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Other message");
+    logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Other message");
+
+    logger->Deinit();
+    logger->UnregisterSink(&sink);
+
+    // The first of each run, a summary of the 49 repeats, the second run and its summary on flush.
+    EXPECT_EQ(sink.m_count, 4u);
+    EXPECT_NE(sink.m_text.find("Same message 7\n"), std::string::npos);
+    EXPECT_NE(sink.m_text.find("Last message repeated 49 times\n"), std::string::npos);
+    EXPECT_NE(sink.m_text.find("Last message repeated once\n"), std::string::npos);
+    EXPECT_LT(sink.m_text.find("repeated 49"), sink.m_text.find("Other message"));
+}
+
+TEST(LogFormatTests, TimestampPrecisionAndPrefix)
+{
+    struct
+    {
+        uge::log::LogLine m_line;
+        char m_payload[32];
+    } record;
+
+    const auto second = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+    record.m_line = uge::log::LogLine{0, second + std::chrono::microseconds(42042), 0, uge::log::LogLineType_Log, uge::log::LogLevel_Warning, uge::log::LogCategory_Core, nullptr};
+    record.m_line.m_size = sizeof("payload");
+    std::memcpy(record.m_payload, "payload", sizeof("payload"));
+
+    char buffer[128];
+    const uge::UInt32 length = uge::log::FormatLogMessage(buffer, sizeof(buffer), record.m_line, uge::log::LogTimestamp_Microseconds);
+    EXPECT_EQ(length, std::strlen(buffer));
+    EXPECT_NE(std::strstr(buffer, ".042042][Warning] payload\n"), nullptr);
+
+    uge::log::FormatLogMessage(buffer, sizeof(buffer), record.m_line, uge::log::LogTimestamp_Milliseconds);
+    EXPECT_NE(std::strstr(buffer, ".042][Warning] payload\n"), nullptr);
+
+    uge::log::FormatLogMessage(buffer, sizeof(buffer), record.m_line, uge::log::LogTimestamp_Seconds);
+    EXPECT_NE(std::strstr(buffer, "][Warning] payload\n"), nullptr);
+    EXPECT_EQ(std::strlen("[YYYY.MM.DD HH:MM:SS"), static_cast<size_t>(std::strchr(buffer, ']') - buffer));
+
+    // The output is cut, not overrun, and stays terminated.
+    const uge::UInt32 truncatedLength = uge::log::FormatLogMessage(buffer, 8, record.m_line);
+    EXPECT_EQ(truncatedLength, 7u);
+    EXPECT_EQ(std::strlen(buffer), 7u);
+}
+
+namespace
+{
+    enum TestLogEnum
+    {
+        TestLogEnum_Value = 3
+    };
+
+    using uge::log::ValidateLogFormat;
+
+    static_assert(ValidateLogFormat<int, double, const char *>("%d %.2f %s") == uge::log::LogFormatError_None);
+    static_assert(ValidateLogFormat<int, char[4]>("%.*s") == uge::log::LogFormatError_None);
+    static_assert(ValidateLogFormat<TestLogEnum, bool, const wchar_t *, void *>("%d %u %ls %p") == uge::log::LogFormatError_None);
+    static_assert(ValidateLogFormat<uge::Int64, uge::UInt64>("%lld %llx %%") == uge::log::LogFormatError_None);
+    static_assert(ValidateLogFormat<int>("%d %d") == uge::log::LogFormatError_TooFewArguments);
+    static_assert(ValidateLogFormat<int, int>("%d") == uge::log::LogFormatError_TooManyArguments);
+    static_assert(ValidateLogFormat<const char *>("%d") == uge::log::LogFormatError_ArgumentTypeMismatch);
+    static_assert(ValidateLogFormat<int>("%lld") == uge::log::LogFormatError_ArgumentTypeMismatch);
+    static_assert(ValidateLogFormat<uge::UInt64>("%u") == uge::log::LogFormatError_ArgumentTypeMismatch);
+    static_assert(ValidateLogFormat<double, const char *>("%.*s") == uge::log::LogFormatError_WidthOrPrecisionNotInt);
+    static_assert(ValidateLogFormat<int *>("%n") == uge::log::LogFormatError_UnsupportedConversion);
+
+    static_assert(uge::log::LogArgPacker<int, double, char[6]>::c_fixedSize == 5 + 9 + 4);
+    static_assert(uge::log::LogArgPacker<int, double, char[6]>::c_stringCount == 1);
+}
+
+TEST(LogFormatTests, ArgumentsPackedByTypeMatchPrintf)
+{
+    auto logger = std::make_unique<uge::log::CLog>();
+    LineRecordingSink sink;
+
+    logger->RegisterSink(&sink);
+    logger->Init(uge::log::LogMode_ASync);
+
+    const std::string longString(3000, 'x');
+    logger->PushMessageArgs(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "%d|%u|%lld|%.2f|%s|%ls|%c|%.*s|%d", -7, 7u, -1234567890123ll, 2.5f, "narrow", L"wide", 'c', 2, "abc", TestLogEnum_Value);
+    logger->PushMessageArgs(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "[%s] after %d", longString.c_str(), 42);
+
+    logger->Deinit();
+    logger->UnregisterSink(&sink);
+
+    EXPECT_NE(sink.m_text.find("] -7|7|-1234567890123|2.50|narrow|wide|c|ab|3\n"), std::string::npos);
+
+    // Oversized strings are trimmed so the arguments following them still fit.
+    EXPECT_NE(sink.m_text.find("xxx] after 42\n"), std::string::npos);
+}
+
+TEST(LogFormatTests, RuntimeFormatsAreFormattedBeforeQueuing)
+{
+    auto logger = std::make_unique<uge::log::CLog>();
+    LineRecordingSink sink;
+
+    logger->RegisterSink(&sink);
+    logger->Init(uge::log::LogMode_ASync);
+
+    // The va_list front end formats immediately by default, the format may not outlive the call.
+    char format[32];
+    uge::Strcpy(format, "Built at runtime %d", sizeof(format));
+    logger->PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, format, 7);
+    uge::Strcpy(format, "Overwritten %s", sizeof(format));
+
+    logger->Deinit();
+    logger->UnregisterSink(&sink);
+
+    EXPECT_NE(sink.m_text.find("] Built at runtime 7\n"), std::string::npos);
+}
+
+namespace
+{
+    class RecordCopyingSink : public LineRecordingSink
+    {
+    public:
+        virtual void SinkLog(const char *formattedMsg, const uge::log::LogLine &logLine)
+        {
+            LineRecordingSink::SinkLog(formattedMsg, logLine);
+            m_types.push_back(logLine.m_type);
+            m_formats.push_back(logLine.m_format ? logLine.m_format : "");
+            m_payloads.emplace_back(logLine.GetPayload(), logLine.m_size);
+        }
+
+        std::vector<uge::log::LogLineType> m_types;
+        std::vector<std::string> m_formats;
+        std::vector<std::string> m_payloads;
+    };
+
+    // What the macros below check at compile time. A mismatch, e.g. UGE_LOG_INFO(category, "%d", "text"),
+    // doesn't compile, so the negative cases can only be checked through ValidateLogFormat itself.
+    static_assert(ValidateLogFormat<uge::UInt32, const char *>("Value %u of %s") == uge::log::LogFormatError_None);
+    static_assert(ValidateLogFormat<uge::UInt32, const char *>("Value %f of %s") == uge::log::LogFormatError_ArgumentTypeMismatch);
+    static_assert(ValidateLogFormat<uge::UInt32, const char *>("Value %u of %d") == uge::log::LogFormatError_ArgumentTypeMismatch);
+    static_assert(ValidateLogFormat<uge::UInt32>("Value %u of %s") == uge::log::LogFormatError_TooFewArguments);
+    static_assert(ValidateLogFormat<uge::UInt32, const char *>("Value %u") == uge::log::LogFormatError_TooManyArguments);
+}
+
+TEST(LogFormatTests, MacrosRouteThroughTheTemplateFrontEnd)
+{
+    uge::log::CLog &logger = uge::log::GetLog();
+    RecordCopyingSink sink;
+
+    logger.RegisterSink(&sink);
+    logger.Init(uge::log::LogMode_Sync);
+
+    const uge::UInt32 value = 5;
+#ifdef UGE_LOG_ENABLED
+    UGE_LOG_INFO(uge::log::LogCategory_Core, "Value %u of %s", value, "macro");
+    UGE_LOG_TRACE(uge::log::LogCategory_Core, "Below the runtime level");
+    UGE_LOG_INFO_KV(uge::log::LogCategory_Game, "Structured", "value", value, "name", "macro");
+#else
+    // The macros are empty without UGE_DEBUG, call what they expand to.
+    uge::log::Log<uge::log::LogLevel_Info, uge::log::LogCategory_Core>("Value %u of %s", value, "macro");
+    uge::log::Log<uge::log::LogLevel_Trace, uge::log::LogCategory_Core>("Below the runtime level");
+    uge::log::LogFields<uge::log::LogLevel_Info, uge::log::LogCategory_Game>("Structured", "value", value, "name", "macro");
+#endif
+
+    logger.Deinit();
+    logger.UnregisterSink(&sink);
+
+    ASSERT_EQ(sink.m_count, 2u);
+    EXPECT_NE(sink.m_text.find("[Info] Value 5 of macro\n"), std::string::npos);
+    EXPECT_NE(sink.m_text.find("[Info] Structured value=5 name=\"macro\"\n"), std::string::npos);
+    EXPECT_EQ(sink.m_text.find("Below the runtime level"), std::string::npos);
+
+    // Both calls queued the constant format and the arguments packed by type, not formatted text.
+    uge::UByte expected[uge::log::c_logLineBufferSize];
+    EXPECT_EQ(sink.m_types[0], uge::log::LogLineType_Log);
+    EXPECT_EQ(sink.m_formats[0], "Value %u of %s");
+    uge::UInt32 expectedSize = PackFields(expected, sizeof(expected), value, "macro");
+    EXPECT_EQ(sink.m_payloads[0], std::string(reinterpret_cast<const char *>(expected), expectedSize));
+
+    EXPECT_EQ(sink.m_types[1], uge::log::LogLineType_Fields);
+    EXPECT_EQ(sink.m_formats[1], "Structured");
+    expectedSize = PackFields(expected, sizeof(expected), "value", value, "name", "macro");
+    EXPECT_EQ(sink.m_payloads[1], std::string(reinterpret_cast<const char *>(expected), expectedSize));
+}
+
+static_assert(uge::log::IsLogFieldList<const char *, int, const char *, const char *>());
+static_assert(!uge::log::IsLogFieldList<const char *>());
+static_assert(!uge::log::IsLogFieldList<int, int>());
+static_assert(uge::log::GetLogArgType<uge::UInt32>() == uge::log::LogArgType_UInt32);
+static_assert(uge::log::GetLogArgType<uge::UInt64>() == uge::log::LogArgType_UInt64);
+static_assert(uge::log::GetLogArgType<uge::Int16>() == uge::log::LogArgType_Int32);
+
+TEST(LogFieldsTests, RenderedAsTextJsonAndBinary)
+{
+    const uge::UInt32 c_recordSize = sizeof(uge::log::LogLine) + uge::log::c_logLineBufferSize;
+    std::vector<uge::UInt64> storage(2 * c_recordSize / sizeof(uge::UInt64));
+    uge::log::LogLine *records[2];
+    for (uge::UInt32 i = 0; i != 2; ++i)
+    {
+        records[i] = reinterpret_cast<uge::log::LogLine *>(reinterpret_cast<uge::UByte *>(storage.data()) + i * c_recordSize);
+        *records[i] = uge::log::LogLine{0, std::chrono::system_clock::now(), 7, uge::log::LogLineType_Fields, uge::log::LogLevel_Info, uge::log::LogCategory_Game, "Entity 100% spawned"};
+        records[i]->m_size = PackFields(reinterpret_cast<uge::UByte *>(records[i]->GetPayload()), uge::log::c_logLineBufferSize, "entity", 42 + i, "ms", 1.5, "name", "orc \"boss\"\t", "id", -1234567890123ll);
+    }
+
+    char line[uge::log::c_logFormattedLineSize];
+    uge::log::FormatLogMessage(line, sizeof(line), *records[0]);
+    EXPECT_NE(std::strstr(line, "[Info] Entity 100% spawned entity=42 ms=1.5 name=\"orc \"boss\"\t\" id=-1234567890123\n"), nullptr);
+
+    const uge::UInt32 jsonLength = uge::log::FormatLogJson(line, sizeof(line), *records[0]);
+    EXPECT_EQ(jsonLength, std::strlen(line));
+    EXPECT_EQ(std::strncmp(line, "{\"time\":", 8), 0);
+    EXPECT_NE(std::strstr(line, ",\"level\":\"Info\",\"category\":\"Game\",\"thread\":7,\"msg\":\"Entity 100% spawned\",\"entity\":42,\"ms\":1.5,\"name\":\"orc \\\"boss\\\"\\t\",\"id\":-1234567890123}\n"), nullptr);
+
+    // A line too short for every field leaves the last ones out and stays valid JSON.
+    const uge::UInt32 truncatedLength = uge::log::FormatLogJson(line, jsonLength - 10, *records[0]);
+    EXPECT_EQ(std::strcmp(line + truncatedLength - 2, "}\n"), 0);
+    EXPECT_EQ(std::strstr(line, "\"id\""), nullptr);
+
+    // The keys are written once with the call site, the second record only holds the values.
+    uge::log::LogBinaryEncoder encoder;
+    std::vector<uge::UByte> data(4096);
+    uge::UInt32 size = encoder.EncodeHeader(data.data(), static_cast<uge::UInt32>(data.size()));
+    const uge::UInt32 firstSize = encoder.Encode(data.data() + size, static_cast<uge::UInt32>(data.size()) - size, *records[0]);
+    size += firstSize;
+    const uge::UInt32 secondSize = encoder.Encode(data.data() + size, static_cast<uge::UInt32>(data.size()) - size, *records[1]);
+    size += secondSize;
+    EXPECT_LT(secondSize * 2, firstSize);
+
+    uge::log::LogBinaryDecoder decoder(data.data(), size);
+    for (uge::log::LogLine *record : records)
+    {
+        char expected[uge::log::c_logFormattedLineSize];
+        const uge::UInt32 expectedLength = uge::log::FormatLogMessage(expected, sizeof(expected), *record, uge::log::LogTimestamp_Microseconds);
+
+        uge::UInt32 length = 0;
+        ASSERT_TRUE(decoder.DecodeNext(line, sizeof(line), length, uge::log::LogTimestamp_Microseconds));
+        EXPECT_EQ(std::string(line, length), std::string(expected, expectedLength));
+    }
+    EXPECT_TRUE(decoder.IsAtEnd());
+}
+
+TEST(LogFieldsTests, UnsignedValuesKeepTheirSign)
+{
+    const uge::UInt32 c_recordSize = sizeof(uge::log::LogLine) + uge::log::c_logLineBufferSize;
+    std::vector<uge::UInt64> storage(c_recordSize / sizeof(uge::UInt64));
+    uge::log::LogLine *record = reinterpret_cast<uge::log::LogLine *>(storage.data());
+    *record = uge::log::LogLine{0, std::chrono::system_clock::now(), 7, uge::log::LogLineType_Fields, uge::log::LogLevel_Info, uge::log::LogCategory_Game, "Limits"};
+    record->m_size = PackFields(reinterpret_cast<uge::UByte *>(record->GetPayload()), uge::log::c_logLineBufferSize, "u32", 0xFFFFFFFFu, "u64", UINT64_MAX, "i32", -1);
+
+    char line[uge::log::c_logFormattedLineSize];
+    const uge::UInt32 textLength = uge::log::FormatLogMessage(line, sizeof(line), *record, uge::log::LogTimestamp_Microseconds);
+    const std::string text(line, textLength);
+    EXPECT_NE(text.find("Limits u32=4294967295 u64=18446744073709551615 i32=-1\n"), std::string::npos);
+
+    uge::log::FormatLogJson(line, sizeof(line), *record);
+    EXPECT_NE(std::strstr(line, ",\"u32\":4294967295,\"u64\":18446744073709551615,\"i32\":-1}\n"), nullptr);
+
+    uge::log::LogBinaryEncoder encoder;
+    std::vector<uge::UByte> data(1024);
+    uge::UInt32 size = encoder.EncodeHeader(data.data(), static_cast<uge::UInt32>(data.size()));
+    size += encoder.Encode(data.data() + size, static_cast<uge::UInt32>(data.size()) - size, *record);
+
+    uge::log::LogBinaryDecoder decoder(data.data(), size);
+    uge::UInt32 length = 0;
+    ASSERT_TRUE(decoder.DecodeNext(line, sizeof(line), length, uge::log::LogTimestamp_Microseconds));
+    EXPECT_EQ(std::string(line, length), text);
+}
+
+TEST(LogCrashTests, QueuedLinesReachDiskOnAbort)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "ugeCrashFlushTest.log";
+    std::filesystem::remove(path);
+
+    EXPECT_DEATH(
+        {
+            // Never freed, abort() doesn't return.
+            uge::log::LogFileSink *sink = new uge::log::LogFileSink();
+            sink->OpenFile(path.string().c_str(), "w");
+
+            uge::log::GetLog().RegisterSink(sink);
+            uge::log::InitLog();
+            for (uge::UInt32 i = 0; i != 200; ++i)
+            {
+                uge::log::GetLog().PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Line %u before the crash", i);
+            }
+            abort();
+        },
+        "");
+
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    EXPECT_NE(text.str().find("Line 199 before the crash\n"), std::string::npos);
+    EXPECT_NE(text.str().find("abort() called\n"), std::string::npos);
+    EXPECT_GT(text.str().find("abort() called"), text.str().find("Line 199"));
+
+    file.close();
+    std::filesystem::remove(path);
+}
+
+TEST(LogCrashTests, QueuedLinesReachDiskOnAccessViolation)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "ugeCrashFaultTest.log";
+    std::filesystem::remove(path);
+
+    EXPECT_DEATH(
+        {
+            uge::log::LogFileSink *sink = new uge::log::LogFileSink();
+            sink->OpenFile(path.string().c_str(), "w");
+
+            uge::log::GetLog().RegisterSink(sink);
+            uge::log::InitLog();
+            for (uge::UInt32 i = 0; i != 200; ++i)
+            {
+                uge::log::GetLog().PushMessage(uge::log::LogLevel_Info, uge::log::LogCategory_Core, "Line %u before the fault", i);
+            }
+
+            // Faults on its own thread, out of reach of the test framework's exception handling, so
+            // it goes to the unhandled exception filter on Windows and the SIGSEGV handler on Linux.
+            std::thread([]() {
+                // The pointee is volatile too, or the null store is undefined and optimized out.
+                int *volatile address = nullptr;
+                *static_cast<volatile int *>(address) = 42;
+            }).join();
+        },
+        "");
+
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+#if defined(UGE_PLATFORM_WINDOWS)
+    const char *reason = "Unhandled exception 0xC0000005";
+#else
+    const char *reason = "Signal 11 (Segmentation fault)";
+#endif
+    EXPECT_NE(text.str().find("Line 199 before the fault\n"), std::string::npos);
+    EXPECT_NE(text.str().find(reason), std::string::npos);
+    EXPECT_GT(text.str().find(reason), text.str().find("Line 199"));
+
+    file.close();
+    std::filesystem::remove(path);
+}
+
+TEST(LogMappedFileSinkTests, RotatesAndKeepsTheLastSegments)
+{
+    const std::filesystem::path basePath = std::filesystem::temp_directory_path() / "ugeMappedSinkTest.log";
+    const uge::UInt32 c_segmentSize = 256;
+    const uge::UInt32 c_segmentCount = 3;
+    const uge::log::LogLine logLine = {};
+
+    std::string written;
+    {
+        uge::log::LogMappedFileSink sink;
+        ASSERT_TRUE(sink.Open(basePath.string().c_str(), c_segmentSize, c_segmentCount));
+
+        for (uge::UInt32 i = 0; i != 100; ++i)
+        {
+            const std::string line = "Mapped line " + std::to_string(i) + "\n";
+            sink.SinkLog(line.c_str(), logLine);
+            written += line;
+        }
+
+        sink.Flush();
+        sink.Close();
+    }
+
+    // Segments never split a line, so the kept segments hold the last lines written, in order.
+    std::string kept;
+    uge::UInt32 keptCount = 0;
+    for (uge::UInt32 i = 0; i != 100; ++i)
+    {
+        const std::filesystem::path segmentPath = basePath.string() + "." + std::to_string(i);
+        if (!std::filesystem::exists(segmentPath))
+        {
+            continue;
+        }
+
+        EXPECT_LE(std::filesystem::file_size(segmentPath), c_segmentSize);
+
+        std::ifstream segment(segmentPath, std::ios::binary);
+        std::stringstream content;
+        content << segment.rdbuf();
+        kept += content.str();
+        ++keptCount;
+
+        segment.close();
+        std::filesystem::remove(segmentPath);
+    }
+
+    EXPECT_EQ(keptCount, c_segmentCount);
+    ASSERT_FALSE(kept.empty());
+    EXPECT_EQ(kept.find("Mapped line "), 0u);
+    EXPECT_EQ(written.compare(written.size() - kept.size(), kept.size(), kept), 0);
+}
+
+TEST(LogMappedFileSinkTests, OpenDeletesTheSegmentsOfAnEarlierRun)
+{
+    const std::filesystem::path basePath = std::filesystem::temp_directory_path() / "ugeMappedSinkStaleTest.log";
+    const std::string staleSegment = basePath.string() + ".57";
+    const std::string otherFile = basePath.string() + ".1.txt";
+    std::ofstream(staleSegment) << "Stale line\n";
+    std::ofstream(basePath.string() + ".0") << "Stale line\n";
+    std::ofstream(otherFile) << "Not a segment\n";
+
+    {
+        uge::log::LogMappedFileSink sink;
+        ASSERT_TRUE(sink.Open(basePath.string().c_str(), 256, 3));
+        sink.SinkLog("Fresh line\n", uge::log::LogLine{});
+        sink.Close();
+    }
+
+    EXPECT_FALSE(std::filesystem::exists(staleSegment));
+    EXPECT_TRUE(std::filesystem::exists(otherFile));
+
+    std::ifstream segment(basePath.string() + ".0");
+    std::stringstream content;
+    content << segment.rdbuf();
+    EXPECT_EQ(content.str(), "Fresh line\n");
+
+    segment.close();
+    std::filesystem::remove(basePath.string() + ".0");
+    std::filesystem::remove(otherFile);
+}
+
+TEST(LogBinaryFormatTests, FileSinkRoundTripsThroughTheDecoder)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "ugeBinarySinkTest.ulog";
+    const auto baseTime = std::chrono::system_clock::now();
+
+    // Deferred messages with every argument type, a repeated format and an immediate message.
+    const uge::UInt32 c_recordCount = 4;
+    const uge::UInt32 c_recordSize = sizeof(uge::log::LogLine) + uge::log::c_logLineBufferSize;
+    std::vector<uge::UInt64> storage(c_recordCount * c_recordSize / sizeof(uge::UInt64));
+    uge::log::LogLine *records[c_recordCount];
+    for (uge::UInt32 i = 0; i != c_recordCount; ++i)
+    {
+        records[i] = reinterpret_cast<uge::log::LogLine *>(reinterpret_cast<uge::UByte *>(storage.data()) + i * c_recordSize);
+        *records[i] = uge::log::LogLine{0, baseTime + std::chrono::microseconds(i * 1500), 100 + (i & 1), uge::log::LogLineType_Log, uge::log::LogLevel_Info, uge::log::LogCategory_Game, nullptr};
+    }
+
+    const char *format = "int %d, %lld, %.3f, %f, %p, %s, %*d|";
+    for (uge::UInt32 i = 0; i != 2; ++i)
+    {
+        records[i]->m_format = format;
+        records[i]->m_size = EncodeArgs(reinterpret_cast<uge::UByte *>(records[i]->GetPayload()), uge::log::c_logLineBufferSize, format, -42 - i, -1234567890123ll, 0.1, 2.5, records[i], "text", 6, 7);
+        ASSERT_NE(records[i]->m_size, uge::log::c_logArgsInvalid);
+    }
+
+    records[2]->m_format = "no arguments, %% only";
+    records[2]->m_level = uge::log::LogLevel_Error;
+    records[2]->m_category = uge::log::LogCategory_Core;
+
+    const char *text = "already formatted";
+    uge::Memcpy(records[3]->GetPayload(), text, strlen(text) + 1);
+    records[3]->m_size = static_cast<uge::UInt32>(strlen(text)) + 1;
+
+    std::string expected;
+    {
+        uge::log::LogBinaryFileSink sink;
+        ASSERT_TRUE(sink.OpenFile(path.string().c_str()));
+
+        uge::log::LogBatchEntry entries[c_recordCount];
+        char line[uge::log::c_logFormattedLineSize];
+        for (uge::UInt32 i = 0; i != c_recordCount; ++i)
+        {
+            const uge::UInt32 length = uge::log::FormatLogMessage(line, sizeof(line), *records[i], uge::log::LogTimestamp_Microseconds);
+            expected.append(line, length);
+            entries[i] = uge::log::LogBatchEntry{records[i], nullptr, 0};
+        }
+
+        sink.SinkLogBatch(uge::log::LogBatch{entries, 3, nullptr, 0});
+        sink.SinkLog(nullptr, *records[3]);
+        sink.CloseFile();
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    file.close();
+    std::filesystem::remove(path);
+
+    const std::string data = content.str();
+    uge::log::LogBinaryDecoder decoder(reinterpret_cast<const uge::UByte *>(data.data()), static_cast<uge::UInt32>(data.size()));
+    ASSERT_TRUE(decoder.IsValid());
+
+    std::string decoded;
+    char line[uge::log::c_logFormattedLineSize];
+    uge::UInt32 length = 0;
+    while (decoder.DecodeNext(line, sizeof(line), length, uge::log::LogTimestamp_Microseconds))
+    {
+        decoded.append(line, length);
+    }
+
+    EXPECT_TRUE(decoder.IsValid());
+    EXPECT_TRUE(decoder.IsAtEnd());
+    EXPECT_EQ(decoded, expected);
+}
+
+TEST(LogCompressedFileSinkTests, CompleteBlocksOfATruncatedFileDecode)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "ugeCompressedSinkTest.lzlog";
+    const uge::log::LogLine logLine = {};
+
+    std::string written;
+    {
+        uge::log::LogCompressedFileSink sink;
+        ASSERT_TRUE(sink.OpenFile(path.string().c_str(), 4096));
+
+        for (uge::UInt32 i = 0; i != 1000; ++i)
+        {
+            const std::string line = "[2024.01.01 12:00:00.000][Info] Compressed line " + std::to_string(i) + "\n";
+            sink.SinkLog(line.c_str(), logLine);
+            written += line;
+        }
+
+        sink.CloseFile();
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    file.close();
+    std::filesystem::remove(path);
+
+    std::string data = content.str();
+    EXPECT_LT(data.size(), written.size() / 4);
+
+    auto decode = [](const std::string &data, uge::Bool &valid)
+    {
+        uge::log::LogCompressedDecoder decoder(reinterpret_cast<const uge::UByte *>(data.data()), static_cast<uge::UInt32>(data.size()));
+        std::vector<uge::UByte> block(4096);
+        std::string text;
+        uge::UInt32 length = 0;
+        while (decoder.DecodeNextBlock(block.data(), static_cast<uge::UInt32>(block.size()), length))
+        {
+            // Blocks never split a line.
+            EXPECT_EQ(block[length - 1], '\n');
+            text.append(reinterpret_cast<const char *>(block.data()), length);
+        }
+
+        valid = decoder.IsValid();
+        return text;
+    };
+
+    uge::Bool valid = false;
+    EXPECT_EQ(decode(data, valid), written);
+    EXPECT_TRUE(valid);
+
+    // Cut in the middle of the last block, as a crash would: every block before it still decodes.
+    data.resize(data.size() - 10);
+    const std::string recovered = decode(data, valid);
+    EXPECT_FALSE(valid);
+    EXPECT_FALSE(recovered.empty());
+    EXPECT_LT(recovered.size(), written.size());
+    EXPECT_EQ(written.compare(0, recovered.size(), recovered), 0);
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "core/coreSystem/build.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <vector>
+
+namespace
+{
+    using namespace uge;
+    using namespace uge::jobs;
+
+    template <typename TFunction>
+    Double MeasureMs(TFunction function)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        function();
+        const std::chrono::duration<Double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+        return elapsed.count();
+    }
+
+    // Stand-ins for math::Matrix::Mul and math::Box::AddPoint, with the same row-major 4x4 product
+    // and min/max update: coreMath only builds with MSVC.
+    struct BenchMatrix
+    {
+        Float m[4][4];
+
+        static BenchMatrix Mul(const BenchMatrix &a, const BenchMatrix &b)
+        {
+            BenchMatrix result;
+            for (UInt32 row = 0; row != 4; ++row)
+            {
+                for (UInt32 column = 0; column != 4; ++column)
+                {
+                    result.m[row][column] = a.m[row][0] * b.m[0][column] + a.m[row][1] * b.m[1][column] + a.m[row][2] * b.m[2][column] + a.m[row][3] * b.m[3][column];
+                }
+            }
+            return result;
+        }
+    };
+
+    struct BenchBox
+    {
+        Float m_min[3];
+        Float m_max[3];
+
+        static BenchBox EmptyBox()
+        {
+            return BenchBox{{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+        }
+
+        BenchBox &AddPoint(const Float *point)
+        {
+            for (UInt32 i = 0; i != 3; ++i)
+            {
+                m_min[i] = std::min(m_min[i], point[i]);
+                m_max[i] = std::max(m_max[i], point[i]);
+            }
+            return *this;
+        }
+
+        BenchBox &AddBox(const BenchBox &box)
+        {
+            AddPoint(box.m_min);
+            return AddPoint(box.m_max);
+        }
+
+        bool operator==(const BenchBox &other) const
+        {
+            return std::equal(m_min, m_min + 3, other.m_min) && std::equal(m_max, m_max + 3, other.m_max);
+        }
+    };
+}
+
+TEST(ParallelBenchmarks, MatrixMulAndBoxAddPoint)
+{
+    const UInt32 c_count = 1000000;
+
+    std::vector<BenchMatrix> matrices(c_count);
+    std::vector<BenchMatrix> products(c_count);
+    std::vector<Float> points(3 * c_count);
+    for (UInt32 i = 0; i != c_count; ++i)
+    {
+        const Float f = static_cast<Float>(i % 1000);
+        matrices[i] = BenchMatrix{{{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}, {f, -f, f * 0.5f, 1.0f}}};
+        points[3 * i] = f;
+        points[3 * i + 1] = f * 0.25f - 100.0f;
+        points[3 * i + 2] = -f;
+    }
+
+    // A rotation of 0.5 rad around Z.
+    const Float c = 0.87758256f;
+    const Float s = 0.47942554f;
+    const BenchMatrix transform = {{{c, s, 0.0f, 0.0f}, {-s, c, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}}};
+
+    InitJobSystem();
+
+    const Double serialMulMs = MeasureMs([&]()
+                                         {
+                                             for (UInt32 i = 0; i != c_count; ++i)
+                                             {
+                                                 products[i] = BenchMatrix::Mul(matrices[i], transform);
+                                             } });
+    const Double parallelMulMs = MeasureMs([&]()
+                                           { ParallelFor(c_count, [&](UInt32 i)
+                                                         { products[i] = BenchMatrix::Mul(matrices[i], transform); }); });
+
+    BenchBox serialBox = BenchBox::EmptyBox();
+    const Double serialBoxMs = MeasureMs([&]()
+                                         {
+                                             for (UInt32 i = 0; i != c_count; ++i)
+                                             {
+                                                 serialBox.AddPoint(&points[3 * i]);
+                                             } });
+    BenchBox parallelBox;
+    const Double parallelBoxMs = MeasureMs([&]()
+                                           { parallelBox = ParallelReduce(
+                                                 0u, c_count, BenchBox::EmptyBox(),
+                                                 [&](BenchBox &box, UInt32 i)
+                                                 { box.AddPoint(&points[3 * i]); },
+                                                 [](const BenchBox &a, const BenchBox &b)
+                                                 { return BenchBox(a).AddBox(b); }); });
+    EXPECT_TRUE(parallelBox == serialBox);
+
+    std::printf("[ BENCH    ] 1M 4x4 matrix products on %u workers: serial %.2f ms, ParallelFor %.2f ms\n", GetJobSystem().GetWorkerCount(), serialMulMs, parallelMulMs);
+    std::printf("[ BENCH    ] 1M box AddPoint on %u workers: serial %.2f ms, ParallelReduce %.2f ms\n", GetJobSystem().GetWorkerCount(), serialBoxMs, parallelBoxMs);
+
+    DeinitJobSystem();
+}
@@ -0,0 +1,266 @@
+#include <gtest/gtest.h>
+#include "core/coreSystem/build.h"
+
+#include <chrono>
+#include <mutex>
+#include <semaphore>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace uge;
+
+    template <typename TFunction>
+    Double MeasureNsPerCall(UInt32 count, TFunction function)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (UInt32 i = 0; i != count; ++i)
+        {
+            function();
+        }
+        const std::chrono::duration<Double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - start;
+        return elapsed.count() / count;
+    }
+
+    /**
+     * @brief Lock/unlock cost with threadCount threads hammering the same lock.
+     */
+    template <typename TLock>
+    Double MeasureContendedNsPerLock(TLock &lock, UInt32 threadCount)
+    {
+        const UInt32 c_lockCount = 200000;
+
+        std::vector<std::thread> threads;
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (UInt32 i = 0; i != threadCount; ++i)
+        {
+            threads.emplace_back([&lock]()
+                                 {
+                                     for (UInt32 j = 0; j != c_lockCount; ++j)
+                                     {
+                                         lock.lock();
+                                         lock.unlock();
+                                     } });
+        }
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        const std::chrono::duration<Double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - start;
+        return elapsed.count() / (c_lockCount * threadCount);
+    }
+
+    // uge::Mutex with the std lock interface, so both locks go through the same loops.
+    struct EngineMutex
+    {
+        Mutex m_mutex;
+
+        void lock()
+        {
+            m_mutex.Lock();
+        }
+
+        void unlock()
+        {
+            m_mutex.Unlock();
+        }
+    };
+
+    class EmptyThread : public Thread
+    {
+    public:
+        EmptyThread()
+            : Thread("BenchThread", 64 * 1024)
+        {
+        }
+
+        virtual void ThreadFunc()
+        {
+        }
+    };
+
+    /**
+     * @brief Operations per microsecond with threadCount threads taking the lock, one in writeEvery as a writer.
+     */
+    template <typename TLock>
+    Double MeasureReadWriteOpsPerUs(UInt32 threadCount, UInt32 writeEvery)
+    {
+        const UInt32 c_opCount = 100000;
+
+        TLock lock;
+        UInt64 value = 0;
+
+        std::vector<std::thread> threads;
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (UInt32 i = 0; i != threadCount; ++i)
+        {
+            threads.emplace_back([&lock, &value, writeEvery, i]()
+                                 {
+                                     UInt64 sum = 0;
+                                     for (UInt32 j = 0; j != c_opCount; ++j)
+                                     {
+                                         if ((j + i) % writeEvery == 0)
+                                         {
+                                             lock.Lock();
+                                             ++value;
+                                             lock.Unlock();
+                                         }
+                                         else
+                                         {
+                                             lock.LockShared();
+                                             sum += value;
+                                             lock.UnlockShared();
+                                         }
+                                     }
+                                     (void)sum; });
+        }
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        const std::chrono::duration<Double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+        return c_opCount * threadCount / elapsed.count();
+    }
+
+    // std::shared_mutex with the engine lock interface.
+    struct StdSharedMutex
+    {
+        std::shared_mutex m_mutex;
+
+        void Lock()
+        {
+            m_mutex.lock();
+        }
+
+        void Unlock()
+        {
+            m_mutex.unlock();
+        }
+
+        void LockShared()
+        {
+            m_mutex.lock_shared();
+        }
+
+        void UnlockShared()
+        {
+            m_mutex.unlock_shared();
+        }
+    };
+
+    struct SwitchingFibers
+    {
+        Fiber m_threadFiber;
+        Fiber m_fiber;
+    };
+
+    void SwitchBackFiberMain(void *userData)
+    {
+        SwitchingFibers *fibers = static_cast<SwitchingFibers *>(userData);
+        for (;;)
+        {
+            Fiber::Switch(fibers->m_fiber, fibers->m_threadFiber);
+        }
+    }
+}
+
+TEST(ThreadsBenchmarks, MutexLockUnlock)
+{
+    const UInt32 c_lockCount = 1000000;
+
+    EngineMutex engineMutex;
+    std::mutex stdMutex;
+
+    const Double engineNs = MeasureNsPerCall(c_lockCount, [&]()
+                                             { engineMutex.lock(); engineMutex.unlock(); });
+    const Double stdNs = MeasureNsPerCall(c_lockCount, [&]()
+                                          { stdMutex.lock(); stdMutex.unlock(); });
+    std::printf("[ BENCH    ] uncontended lock/unlock: uge::Mutex %.1f ns, std::mutex %.1f ns\n", engineNs, stdNs);
+
+    for (UInt32 threadCount = 2; threadCount <= 8; threadCount *= 2)
+    {
+        const Double engineContendedNs = MeasureContendedNsPerLock(engineMutex, threadCount);
+        const Double stdContendedNs = MeasureContendedNsPerLock(stdMutex, threadCount);
+        std::printf("[ BENCH    ] %u threads lock/unlock: uge::Mutex %.1f ns, std::mutex %.1f ns\n", threadCount, engineContendedNs, stdContendedNs);
+    }
+}
+
+TEST(ThreadsBenchmarks, SemaphoreReleaseAcquire)
+{
+    const UInt32 c_count = 1000000;
+
+    Semaphore engineSemaphore(0, 1);
+    std::binary_semaphore stdSemaphore(0);
+
+    const Double engineNs = MeasureNsPerCall(c_count, [&]()
+                                             { engineSemaphore.Release(1); engineSemaphore.Acquire(); });
+    const Double stdNs = MeasureNsPerCall(c_count, [&]()
+                                          { stdSemaphore.release(); stdSemaphore.acquire(); });
+    std::printf("[ BENCH    ] uncontended release/acquire: uge::Semaphore %.1f ns, std::binary_semaphore %.1f ns\n", engineNs, stdNs);
+
+    // Ping-pong between two threads, every acquire has to sleep.
+    const UInt32 c_pingCount = 20000;
+    Semaphore ping(0, 1);
+    Semaphore pong(0, 1);
+    std::thread partner([&]()
+                        {
+                            for (UInt32 i = 0; i != c_pingCount; ++i)
+                            {
+                                ping.Acquire();
+                                pong.Release(1);
+                            } });
+    const Double pingPongNs = MeasureNsPerCall(c_pingCount, [&]()
+                                               { ping.Release(1); pong.Acquire(); });
+    partner.join();
+    std::printf("[ BENCH    ] cross thread wakeup round trip: uge::Semaphore %.1f ns\n", pingPongNs);
+}
+
+TEST(ThreadsBenchmarks, ThreadCreateJoin)
+{
+    const UInt32 c_threadCount = 2000;
+
+    const Double engineNs = MeasureNsPerCall(c_threadCount, []()
+                                             {
+                                                 EmptyThread thread;
+                                                 thread.Init();
+                                                 thread.Join(); });
+    const Double stdNs = MeasureNsPerCall(c_threadCount, []()
+                                          {
+                                              std::thread thread([]() {});
+                                              thread.join(); });
+    std::printf("[ BENCH    ] thread create/join: uge::Thread %.1f us, std::thread %.1f us\n", engineNs / 1000.0, stdNs / 1000.0);
+}
+
+TEST(ThreadsBenchmarks, FiberSwitch)
+{
+    const UInt32 c_switchCount = 1000000;
+
+    SwitchingFibers fibers;
+    fibers.m_threadFiber.InitFromThread();
+    fibers.m_fiber.Init(SwitchBackFiberMain, &fibers, 64 * 1024);
+
+    // Each call is a round trip, two switches.
+    const Double roundTripNs = MeasureNsPerCall(c_switchCount, [&]()
+                                                { Fiber::Switch(fibers.m_threadFiber, fibers.m_fiber); });
+    std::printf("[ BENCH    ] fiber switch: %.1f ns\n", roundTripNs / 2.0);
+
+    fibers.m_fiber.Deinit();
+    fibers.m_threadFiber.Deinit();
+}
+
+TEST(ThreadsBenchmarks, ReadWriteLockContention)
+{
+    const UInt32 c_threadCount = 4;
+    const UInt32 c_writeEvery[] = {1000, 100, 10, 2};
+
+    for (UInt32 writeEvery : c_writeEvery)
+    {
+        const Double spinOps = MeasureReadWriteOpsPerUs<RWSpinLock>(c_threadCount, writeEvery);
+        const Double bigReaderOps = MeasureReadWriteOpsPerUs<BigReaderLock>(c_threadCount, writeEvery);
+        const Double stdOps = MeasureReadWriteOpsPerUs<StdSharedMutex>(c_threadCount, writeEvery);
+        std::printf("[ BENCH    ] %u threads, 1 write in %u: RWSpinLock %.1f, BigReaderLock %.1f, std::shared_mutex %.1f ops/us\n",
+                    c_threadCount, writeEvery, spinOps, bigReaderOps, stdOps);
+    }
+}
@@ -58,3 +58,184 @@ TEST(RWSpinLockTests, TryLockShared)
         // Assert that the shared lock is not acquired
     }
 }
+
+TEST(RWSpinLockTests, ManyReadersThenWriter)
+{
+    uge::RWSpinLock lock;
+
+    // More readers than the old 8-bit counter could hold.
+    for (int i = 0; i != 1000; ++i)
+    {
+        ASSERT_TRUE(lock.TryLockShared());
+    }
+    EXPECT_FALSE(lock.TryLock());
+
+    for (int i = 0; i != 1000; ++i)
+    {
+        lock.UnlockShared();
+    }
+    EXPECT_TRUE(lock.TryLock());
+    EXPECT_FALSE(lock.TryLockShared());
+    lock.Unlock();
+}
+
+namespace
+{
+    template <typename TLock>
+    class WritingThread : public uge::Thread
+    {
+    public:
+        WritingThread(TLock &lock)
+            : Thread("WritingThread"), m_lock(lock), m_locked(0)
+        {
+        }
+
+        virtual void ThreadFunc()
+        {
+            m_lock.Lock();
+            uge::atomic::Atomic32::Exchange(&m_locked, 1);
+            m_lock.Unlock();
+        }
+
+        TLock &m_lock;
+        uge::AtomicInt m_locked;
+    };
+
+    /**
+     * @brief A writer waiting on a reader keeps new readers out, then gets the lock once the reader leaves.
+     */
+    template <typename TLock>
+    void ExpectWriterPreferred(TLock &lock)
+    {
+        lock.LockShared();
+
+        WritingThread<TLock> writer(lock);
+        writer.Init();
+
+        // Wait for the writer to flag itself.
+        while (lock.TryLockShared())
+        {
+            lock.UnlockShared();
+            uge::Thread_Yield();
+        }
+        EXPECT_EQ(writer.m_locked, 0);
+
+        lock.UnlockShared();
+        writer.Join();
+        EXPECT_EQ(writer.m_locked, 1);
+        EXPECT_TRUE(lock.TryLockShared());
+        lock.UnlockShared();
+    }
+}
+
+TEST(RWSpinLockTests, WaitingWriterHoldsOffReaders)
+{
+    uge::RWSpinLock lock;
+    ExpectWriterPreferred(lock);
+}
+
+TEST(BigReaderLockTests, SharedAndExclusive)
+{
+    uge::BigReaderLock lock;
+
+    lock.LockShared();
+    EXPECT_TRUE(lock.TryLockShared());
+    EXPECT_FALSE(lock.TryLock());
+    lock.UnlockShared();
+    lock.UnlockShared();
+
+    EXPECT_TRUE(lock.TryLock());
+    EXPECT_FALSE(lock.TryLockShared());
+    lock.Unlock();
+
+    ExpectWriterPreferred(lock);
+}
+
+TEST(SemaphoreTests, TimeoutAndMaximumCount)
+{
+    uge::Semaphore semaphore(0, 2);
+
+    EXPECT_FALSE(semaphore.TryAcquire(10));
+
+    // Like ReleaseSemaphore, a release past the maximum count is ignored and fails.
+    EXPECT_TRUE(semaphore.Release(2));
+    EXPECT_FALSE(semaphore.Release(1));
+    EXPECT_TRUE(semaphore.TryAcquire(0));
+    EXPECT_TRUE(semaphore.TryAcquire(0));
+    EXPECT_FALSE(semaphore.TryAcquire(0));
+}
+
+namespace
+{
+    class WakingThread : public uge::Thread
+    {
+    public:
+        WakingThread(uge::Semaphore &semaphore)
+            : Thread("WakingThread"), m_semaphore(semaphore)
+        {
+        }
+
+        virtual void ThreadFunc()
+        {
+            m_threadId = uge::ThreadId::GetCurrentThread();
+            uge::Thread_Sleep(20);
+            m_semaphore.Release(1);
+        }
+
+        uge::Semaphore &m_semaphore;
+        uge::ThreadId m_threadId;
+    };
+}
+
+TEST(ThreadTests, ThreadRunsAndWakesWaiter)
+{
+    uge::Semaphore semaphore(0, 1);
+    WakingThread thread(semaphore);
+
+    thread.Init();
+    semaphore.Acquire();
+    thread.Join();
+
+    EXPECT_TRUE(thread.m_threadId.isValid());
+    EXPECT_NE(thread.m_threadId, uge::ThreadId::GetCurrentThread());
+    EXPECT_FALSE(thread.IsValid());
+}
+
+namespace
+{
+    struct PingPongFibers
+    {
+        uge::Fiber m_threadFiber;
+        uge::Fiber m_fiber;
+        uge::UInt32 m_switchCount;
+    };
+
+    void PingPongFiberMain(void *userData)
+    {
+        PingPongFibers *fibers = static_cast<PingPongFibers *>(userData);
+        for (;;)
+        {
+            ++fibers->m_switchCount;
+            uge::Fiber::Switch(fibers->m_fiber, fibers->m_threadFiber);
+        }
+    }
+}
+
+TEST(FiberTests, SwitchesBackAndForth)
+{
+    PingPongFibers fibers;
+    fibers.m_switchCount = 0;
+
+    ASSERT_TRUE(fibers.m_threadFiber.InitFromThread());
+    ASSERT_TRUE(fibers.m_fiber.Init(PingPongFiberMain, &fibers, 64 * 1024));
+
+    for (uge::UInt32 i = 0; i != 3; ++i)
+    {
+        uge::Fiber::Switch(fibers.m_threadFiber, fibers.m_fiber);
+    }
+    EXPECT_EQ(fibers.m_switchCount, 3u);
+
+    fibers.m_fiber.Deinit();
+    fibers.m_threadFiber.Deinit();
+    EXPECT_FALSE(fibers.m_fiber.IsValid());
+}
@@ -0,0 +1,6 @@
+#ifndef __LOGDECODER_BUILD_H__
+#define __LOGDECODER_BUILD_H__
+
+#include "core/coreSystem/build.h"
+
+#endif // __LOGDECODER_BUILD_H__
@@ -0,0 +1,149 @@
+#include "build.h"
+
+#include "core/coreSystem/file/file.h"
+#include "core/coreSystem/log/logBinaryFormat.h"
+#include "core/coreSystem/log/logCompressedFileSink.h"
+
+#include <vector>
+
+using namespace uge;
+
+namespace
+{
+    void PrintUsage()
+    {
+        printf( "Usage: logDecoder <binary or compressed log> [text log] [-s | -ms | -us]\n" );
+        printf( "Turns a log written by LogBinaryFileSink or LogCompressedFileSink back into text, printed if no text log is given.\n" );
+        printf( "  -s, -ms, -us  Timestamp precision of binary logs, milliseconds by default.\n" );
+    }
+
+    Bool ReadWholeFile( const char* fileName, std::vector<UByte>& data )
+    {
+        FILE* file = nullptr;
+        if ( !file::FileOpen( &file, fileName, "rb" ) )
+        {
+            return false;
+        }
+
+        const Int64 size = file::FileGetSize( file );
+        Bool result = size >= 0 && size <= UINT32_MAX;
+        if ( result )
+        {
+            data.resize( static_cast<size_t>( size ) );
+            result = file::FileRead( file, data.data(), static_cast<UInt32>( size ) ) == size;
+        }
+
+        file::FileClose( file );
+        return result;
+    }
+
+    /**
+     * @brief Writes the text of every complete block, a log cut short by a crash stops at its last complete block.
+     */
+    Bool DecodeCompressedLog( const std::vector<UByte>& data, FILE* output, UInt32& blockCount )
+    {
+        log::LogCompressedDecoder decoder( data.data(), static_cast<UInt32>( data.size() ) );
+        std::vector<UByte> block( log::c_logCompressedBlockMaxSize );
+        UInt32 length = 0;
+        while ( decoder.DecodeNextBlock( block.data(), static_cast<UInt32>( block.size() ), length ) )
+        {
+            file::FileWrite( output, block.data(), length );
+            ++blockCount;
+        }
+
+        return decoder.IsValid();
+    }
+
+    Bool DecodeBinaryLog( const std::vector<UByte>& data, FILE* output, log::LogTimestampPrecision precision, UInt32& lineCount )
+    {
+        log::LogBinaryDecoder decoder( data.data(), static_cast<UInt32>( data.size() ) );
+        char line[log::c_logFormattedLineSize];
+        UInt32 length = 0;
+        while ( decoder.DecodeNext( line, sizeof( line ), length, precision ) )
+        {
+            file::FileWrite( output, line, length );
+            ++lineCount;
+        }
+
+        return decoder.IsValid();
+    }
+}
+
+int main( int argc, char** argv )
+{
+    const char* inputName = nullptr;
+    const char* outputName = nullptr;
+    log::LogTimestampPrecision precision = log::LogTimestamp_Milliseconds;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( strcmp( argv[i], "-s" ) == 0 )
+        {
+            precision = log::LogTimestamp_Seconds;
+        }
+        else if ( strcmp( argv[i], "-ms" ) == 0 )
+        {
+            precision = log::LogTimestamp_Milliseconds;
+        }
+        else if ( strcmp( argv[i], "-us" ) == 0 )
+        {
+            precision = log::LogTimestamp_Microseconds;
+        }
+        else if ( inputName == nullptr )
+        {
+            inputName = argv[i];
+        }
+        else if ( outputName == nullptr )
+        {
+            outputName = argv[i];
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if ( inputName == nullptr )
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    std::vector<UByte> data;
+    if ( !ReadWholeFile( inputName, data ) )
+    {
+        fprintf( stderr, "Can't read %s\n", inputName );
+        return 1;
+    }
+
+    const Bool compressed = data.size() >= log::c_logCompressedHeaderSize && Memcmp( data.data(), log::c_logCompressedMagic, sizeof( log::c_logCompressedMagic ) ) == 0;
+    if ( !compressed && !log::LogBinaryDecoder( data.data(), static_cast<UInt32>( data.size() ) ).IsValid() )
+    {
+        fprintf( stderr, "%s isn't a binary or compressed log\n", inputName );
+        return 1;
+    }
+
+    FILE* output = stdout;
+    if ( outputName != nullptr && !file::FileOpen( &output, outputName, "w" ) )
+    {
+        fprintf( stderr, "Can't create %s\n", outputName );
+        return 1;
+    }
+
+    UInt32 count = 0;
+    const Bool valid = compressed ? DecodeCompressedLog( data, output, count ) : DecodeBinaryLog( data, output, precision, count );
+
+    if ( output != stdout )
+    {
+        file::FileClose( output );
+    }
+
+    if ( !valid )
+    {
+        fprintf( stderr, "Malformed %s after %u %s, the log may have been cut short\n", compressed ? "block" : "record", count, compressed ? "blocks" : "lines" );
+        return 1;
+    }
+
+    return 0;
+}